@@ -1,8 +1,201 @@
 import QtQuick
 
 Window {
+    id: root
+
+    required property DashboardController dashboard
+
     width: 640
-    height: 480
+    height: 560
     visible: true
-    title: qsTr("Hello World")
+    title: qsTr("ESP32 BLE Client")
+    color: "#FFFFFF"
+
+    component VitalTile: Rectangle {
+        property alias caption: captionText.text
+        property alias value: valueText.text
+        property alias textColor: valueText.color
+
+        radius: 8
+        border.width: 1
+        implicitHeight: 80
+
+        Column {
+            anchors.centerIn: parent
+            Text {
+                id: captionText
+                anchors.horizontalCenter: parent.horizontalCenter
+                font.pixelSize: 16
+                font.bold: true
+                color: valueText.color
+            }
+            Text {
+                id: valueText
+                anchors.horizontalCenter: parent.horizontalCenter
+                font.pixelSize: 20
+                font.bold: true
+            }
+        }
+    }
+
+    component ActionButton: Rectangle {
+        id: button
+        property alias text: label.text
+        property color baseColor: "#2563EB"
+        signal clicked()
+
+        radius: 8
+        implicitHeight: 44
+        color: enabled ? baseColor : "#9CA3AF"
+
+        Text {
+            id: label
+            anchors.centerIn: parent
+            color: "white"
+            font.bold: true
+        }
+        MouseArea {
+            anchors.fill: parent
+            onClicked: button.clicked()
+        }
+    }
+
+    Column {
+        anchors.fill: parent
+        anchors.margins: 10
+        spacing: 10
+
+        // --- Status Area ---
+        Text {
+            width: parent.width
+            text: qsTr("Status: %1").arg(root.dashboard.status)
+            color: root.dashboard.connected ? "#10B981" : "#F87171"
+            font.pixelSize: 18
+            font.bold: true
+            wrapMode: Text.WordWrap
+        }
+
+        // --- Current Values ---
+        Row {
+            width: parent.width
+            spacing: 20
+
+            VitalTile {
+                width: (parent.width - parent.spacing) / 2
+                color: "#E0F2F1"
+                border.color: "#B2DFDB"
+                textColor: "#004D40"
+                caption: qsTr("Temperature")
+                value: qsTr("%1 °C").arg(root.dashboard.temperature.toFixed(1))
+            }
+            VitalTile {
+                width: (parent.width - parent.spacing) / 2
+                color: "#E3F2FD"
+                border.color: "#BBDEFB"
+                textColor: "#1565C0"
+                caption: qsTr("Heart Rate")
+                value: qsTr("%1 BPM").arg(root.dashboard.heartRate.toFixed(0))
+            }
+        }
+
+        // --- Prediction (shared with the widget UI, see MonitorController) ---
+        VitalTile {
+            id: predictionTile
+            width: parent.width
+            color: {
+                switch (root.dashboard.riskState) {
+                case "atRisk": return "#FFFBEB"
+                case "normal": return "#ECFDF5"
+                case "failed": return "#FEE2E2"
+                default: return "#F3F4F6"
+                }
+            }
+            border.width: 2
+            border.color: {
+                switch (root.dashboard.riskState) {
+                case "atRisk": return "#FCD34D"
+                case "normal": return "#A7F3D0"
+                case "failed": return "#FCA5A5"
+                default: return "#D1D5DB"
+                }
+            }
+            textColor: {
+                switch (root.dashboard.riskState) {
+                case "atRisk": return "#92400E"
+                case "normal": return "#065F46"
+                case "failed": return "#991B1B"
+                default: return "#374151"
+                }
+            }
+            caption: qsTr("Prediction")
+            value: {
+                switch (root.dashboard.riskState) {
+                case "atRisk": return qsTr("⚠️ STATUS: AT RISK (%1%)").arg(Math.round(root.dashboard.riskProbability * 100))
+                case "normal": return qsTr("✅ STATUS: NOT AT RISK (%1%)").arg(Math.round(root.dashboard.riskProbability * 100))
+                case "failed": return qsTr("❌ Prediction Failed")
+                default: return qsTr("Not Run")
+                }
+            }
+        }
+        Text {
+            width: parent.width
+            visible: text.length > 0
+            text: root.dashboard.riskState === "failed" ? qsTr("Details: %1").arg(root.dashboard.predictionError)
+                                                        : root.dashboard.notification
+            color: "#4B5563"
+            font.pixelSize: 12
+            elide: Text.ElideRight
+        }
+
+        // --- Live Traces ---
+        WaveformItem {
+            id: temperatureTrace
+            width: parent.width
+            height: 100
+            minimum: 34
+            maximum: 40
+            color: "#004D40"
+        }
+        WaveformItem {
+            id: heartRateTrace
+            width: parent.width
+            height: 100
+            minimum: 60
+            maximum: 200
+            color: "#1565C0"
+        }
+
+        // --- Control Buttons ---
+        Row {
+            width: parent.width
+            spacing: 10
+
+            ActionButton {
+                width: (parent.width - 2 * parent.spacing) / 3
+                text: root.dashboard.scanning ? qsTr("Scanning...") : qsTr("Start Scan")
+                enabled: !root.dashboard.scanning
+                onClicked: root.dashboard.startScan()
+            }
+            ActionButton {
+                width: (parent.width - 2 * parent.spacing) / 3
+                text: qsTr("Disconnect")
+                baseColor: "#DC2626"
+                enabled: root.dashboard.connected
+                onClicked: root.dashboard.disconnectDevice()
+            }
+            ActionButton {
+                width: (parent.width - 2 * parent.spacing) / 3
+                text: qsTr("Test")
+                onClicked: root.dashboard.predictNow()
+            }
+        }
+    }
+
+    Connections {
+        target: root.dashboard
+        function onSampleReceived(temperature, heartRate) {
+            temperatureTrace.append(temperature)
+            heartRateTrace.append(heartRate)
+        }
+    }
 }
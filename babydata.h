@@ -0,0 +1,21 @@
+#ifndef BABYDATA_H
+#define BABYDATA_H
+
+#include <QString>
+
+// Patient profile from InitialFormWindow plus the live vitals from BLE.
+// These are the 9 inputs of health_classifier.onnx (see featureschema.h).
+struct BabyData {
+    QString gender = "male";
+    float gestational_age_weeks = 0.0f;
+    float birth_weight_kg = 0.0f;
+    float birth_length_cm = 0.0f;
+    float age_days = 0.0f;
+    float weight_kg = 0.0f;
+    float length_cm = 0.0f;
+    // NOTE: temperature_c and heart_rate_bpm will be received via BLE
+    float temperature_c = 0.0f;
+    float heart_rate_bpm = 0.0f;
+};
+
+#endif // BABYDATA_H
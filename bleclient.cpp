@@ -1,8 +1,25 @@
 #include "bleclient.h"
+#include "featureschema.h"
+#include "structuredlogger.h"
+#include "tickscheduler.h"
+#include "vitalsparser.h"
 #include <QDebug>
 #include <QList>
+#include <QMetaMethod>
 #include <QThread>
-#include <QTimer> // QTimer header kept for other potential uses, but singleShot removed
+#include <algorithm>
+
+// Link telemetry intervals and how far each may slide to share a wake-up
+static const int RSSI_INTERVAL_MS = 2000;
+static const int RSSI_TOLERANCE_MS = 1000;
+static const int LINK_STATS_INTERVAL_MS = 5000;
+static const int LINK_STATS_TOLERANCE_MS = 2000;
+static const int CLOCK_PROBE_INTERVAL_MS = 10000;
+static const int CLOCK_PROBE_TOLERANCE_MS = 5000;
+
+// Schema rows of the two streamed vitals, for the plausibility check
+static constexpr size_t TEMPERATURE_INPUT = featureschema::indexOf("temperature_c");
+static constexpr size_t HEART_RATE_INPUT = featureschema::indexOf("heart_rate_bpm");
 
 // --- Helper Setters (Manage state and emit signals) ---
 void BleClient::setStatus(const QString &newStatus)
@@ -18,21 +35,53 @@ void BleClient::setIsScanning(bool scanning)
     if (m_isScanning != scanning) {
         m_isScanning = scanning;
         // Emit signal when scanning status changes (used by the GUI to enable/disable buttons)
-        emit scanFinished();
+        emit scanningChanged(m_isScanning);
     }
 }
 
-void BleClient::setData(const QString &newData)
+void BleClient::setData(const QByteArray &newData)
 {
-    // In a real application, you might append data instead of overwriting,
-    // but for the status demonstration, we overwrite.
+    // Kept as bytes (a shared copy, no allocation); converted to text only
+    // if someone reads the property or listens to dataReceived
     if (m_data != newData) {
         m_data = newData;
-        emit dataReceived(m_data);
-        //qDebug() << "Received : " << m_data;
+        if (isSignalConnected(QMetaMethod::fromSignal(&BleClient::dataReceived)))
+            emit dataReceived(data());
     }
 }
 
+void BleClient::parseData(const QByteArray &payload, qint64 arrivalNs)
+{
+    // Data is expected to be a comma-separated string, e.g., "37.5,120", with
+    // the ESP32's clock as an optional third field
+    VitalsSample sample;
+    const char *begin = payload.constData();
+    const char *end = begin + payload.size();
+    if (!vitalsparser::parseVitals(begin, end, sample.temperature_c, sample.heart_rate_bpm, sample.deviceTimeUs)) {
+        // Rare; only rejected payloads are turned into text. With the right
+        // number of fields, one of them is not a number
+        const qsizetype commas = std::count(begin, end, ',');
+        emit sampleRejected((commas == 1 || commas == 2) ? SampleRejection::NotNumeric : SampleRejection::Format,
+                            QString::fromUtf8(payload));
+        return;
+    }
+    // A value outside the schema range is a sensor fault, not a reading; the
+    // model never sees it
+    if (!featureschema::inRange(TEMPERATURE_INPUT, sample.temperature_c)
+        || !featureschema::inRange(HEART_RATE_INPUT, sample.heart_rate_bpm)) {
+        emit sampleRejected(SampleRejection::OutOfRange, QString::fromUtf8(payload));
+        return;
+    }
+
+    sample.sequence = ++m_sampleSequence;
+    sample.arrivalNs = arrivalNs;
+    if (sample.deviceTimeUs >= 0) {
+        m_clockSync.addArrival(sample.deviceTimeUs, arrivalNs);
+        sample.sensorNs = m_clockSync.toLocalNs(sample.deviceTimeUs);
+    }
+    emit sampleReceived(sample);
+}
+
 // --- Constructor ---
 
 BleClient::BleClient(QObject *parent)
@@ -44,6 +93,9 @@ BleClient::BleClient(QObject *parent)
     // Connect discovery signals
     connect(m_deviceDiscoveryAgent, &QBluetoothDeviceDiscoveryAgent::deviceDiscovered,
             this, &BleClient::deviceDiscovered);
+    // Service UUIDs may only show up in a later advertisement / scan response
+    connect(m_deviceDiscoveryAgent, &QBluetoothDeviceDiscoveryAgent::deviceUpdated,
+            this, &BleClient::deviceUpdated);
     connect(m_deviceDiscoveryAgent, &QBluetoothDeviceDiscoveryAgent::errorOccurred,
             this, &BleClient::scanError);
     connect(m_deviceDiscoveryAgent, &QBluetoothDeviceDiscoveryAgent::finished,
@@ -55,10 +107,42 @@ BleClient::BleClient(QObject *parent)
                     }
                 }
             });
+
+    // JPEG decoding is too slow for the BLE thread, so it gets its own
+    m_decoderThread = new QThread(this);
+    m_decoderThread->setObjectName("FrameDecodeThread");
+    m_frameDecoder = new FrameDecoder(&m_framePool);
+    m_frameDecoder->moveToThread(m_decoderThread);
+    connect(m_decoderThread, &QThread::finished, m_frameDecoder, &QObject::deleteLater);
+    // Forwarded as is; receivers in other threads get it queued
+    connect(m_frameDecoder, &FrameDecoder::frameDecoded,
+            this, &BleClient::frameDecoded, Qt::DirectConnection);
+    m_decoderThread->start();
+
+    m_frameAssembler = new FrameAssembler(&m_framePool, m_frameDecoder);
+}
+
+BleClient::~BleClient()
+{
+    // The decoder reads from m_framePool, so it must be gone before the pool
+    m_decoderThread->quit();
+    m_decoderThread->wait();
+    delete m_frameAssembler;
 }
 
 // --- Public Slots ---
 
+void BleClient::setDiscoveryTimeout(int timeoutMs)
+{
+    m_discoveryTimeoutMs = qMax(0, timeoutMs);
+}
+
+void BleClient::publishState()
+{
+    emit statusChanged(m_status);
+    emit scanningChanged(m_isScanning);
+}
+
 void BleClient::startScan()
 {
     if (m_isScanning)
@@ -70,8 +154,14 @@ void BleClient::startScan()
     setStatus(tr("Scanning for ESP32-CAM-Data..."));
     setIsScanning(true);
 
-    // Start device discovery (scanning)
-    m_deviceDiscoveryAgent->start();
+    m_connectTimer.start();
+    m_scanToFoundMs = -1;
+    m_scanToConnectedMs = -1;
+
+    // Start device discovery (scanning): Low Energy only, so no time is spent
+    // on a classic inquiry, and bounded by the configured timeout
+    m_deviceDiscoveryAgent->setLowEnergyDiscoveryTimeout(m_discoveryTimeoutMs);
+    m_deviceDiscoveryAgent->start(QBluetoothDeviceDiscoveryAgent::LowEnergyMethod);
 }
 
 void BleClient::disconnectDevice()
@@ -88,35 +178,56 @@ void BleClient::disconnectDevice()
 
 // --- Discovery Slots ---
 
+bool BleClient::isTargetDevice(const QBluetoothDeviceInfo &device) const
+{
+    if (!(device.coreConfigurations() & QBluetoothDeviceInfo::LowEnergyCoreConfiguration))
+        return false;
+
+    // Prefer the advertised service UUID; fall back to the name for
+    // advertisements that do not carry the service list
+    const QList<QBluetoothUuid> services = device.serviceUuids();
+    if (!services.isEmpty())
+        return services.contains(QBluetoothUuid(SERVICE_UUID));
+    return device.name() == "ESP32-CAM-Data";
+}
+
+void BleClient::deviceUpdated(const QBluetoothDeviceInfo &device, QBluetoothDeviceInfo::Fields updatedFields)
+{
+    Q_UNUSED(updatedFields);
+    deviceDiscovered(device);
+}
+
 void BleClient::deviceDiscovered(const QBluetoothDeviceInfo &device)
 {
-    // Filter for Low Energy devices by name
-    if (device.coreConfigurations() & QBluetoothDeviceInfo::LowEnergyCoreConfiguration &&
-        device.name() == "ESP32-CAM-Data") {
-
-        setStatus(tr("Target found. Connecting..."));
-        m_deviceDiscoveryAgent->stop(); // Stop scanning immediately after finding the target
-        setIsScanning(false);
-        m_deviceInfo = device;
-
-        // Create the low energy controller (responsible for connection management)
-        m_control = QLowEnergyController::createCentral(m_deviceInfo, this);
-
-        // Connect connection signals
-        connect(m_control, &QLowEnergyController::connected,
-                this, &BleClient::deviceConnected);
-        connect(m_control, &QLowEnergyController::disconnected,
-                this, &BleClient::deviceDisconnected);
-        connect(m_control, &QLowEnergyController::errorOccurred,
-                this, &BleClient::controllerError);
-        connect(m_control, &QLowEnergyController::serviceDiscovered,
-                this, &BleClient::serviceDiscovered);
-        connect(m_control, &QLowEnergyController::discoveryFinished,
-                this, &BleClient::serviceScanDone);
-
-        // Initiate connection
-        m_control->connectToDevice();
-    }
+    // Ignore further results once we are connecting to the first match
+    if (m_control || !isTargetDevice(device))
+        return;
+
+    m_scanToFoundMs = m_connectTimer.elapsed();
+    setStatus(tr("Target found. Connecting..."));
+    m_deviceDiscoveryAgent->stop(); // Stop scanning immediately after finding the target
+    setIsScanning(false);
+    m_deviceInfo = device;
+
+    // Create the low energy controller (responsible for connection management)
+    m_control = QLowEnergyController::createCentral(m_deviceInfo, this);
+
+    // Connect connection signals
+    connect(m_control, &QLowEnergyController::connected,
+            this, &BleClient::deviceConnected);
+    connect(m_control, &QLowEnergyController::disconnected,
+            this, &BleClient::deviceDisconnected);
+    connect(m_control, &QLowEnergyController::errorOccurred,
+            this, &BleClient::controllerError);
+    connect(m_control, &QLowEnergyController::serviceDiscovered,
+            this, &BleClient::serviceDiscovered);
+    connect(m_control, &QLowEnergyController::discoveryFinished,
+            this, &BleClient::serviceScanDone);
+    connect(m_control, &QLowEnergyController::rssiRead,
+            this, &BleClient::rssiRead);
+
+    // Initiate connection
+    m_control->connectToDevice();
 }
 
 void BleClient::scanError(QBluetoothDeviceDiscoveryAgent::Error error)
@@ -126,11 +237,83 @@ void BleClient::scanError(QBluetoothDeviceDiscoveryAgent::Error error)
     setStatus(tr("Error during scan: ") + m_deviceDiscoveryAgent->errorString());
 }
 
+void BleClient::setScheduler(TickScheduler *scheduler)
+{
+    // RSSI polling and telemetry publishing, both only run while connected
+    m_scheduler = scheduler;
+    m_rssiTask = m_scheduler->addTask("ble.rssi", RSSI_INTERVAL_MS, RSSI_TOLERANCE_MS,
+                                      TickScheduler::Priority::Background, this, [this]() {
+                                          if (m_control)
+                                              m_control->readRssi();
+                                      }, false);
+    m_linkStatsTask = m_scheduler->addTask("ble.link_stats", LINK_STATS_INTERVAL_MS, LINK_STATS_TOLERANCE_MS,
+                                           TickScheduler::Priority::Background, this,
+                                           [this]() { publishLinkStats(); }, false);
+    m_clockProbeTask = m_scheduler->addTask("ble.clock_probe", CLOCK_PROBE_INTERVAL_MS, CLOCK_PROBE_TOLERANCE_MS,
+                                            TickScheduler::Priority::Background, this,
+                                            [this]() { sendClockProbe(); }, false);
+}
+
+void BleClient::setTelemetryEnabled(bool enabled)
+{
+    if (!m_scheduler)
+        return;
+    m_scheduler->setTaskEnabled(m_rssiTask, enabled);
+    m_scheduler->setTaskEnabled(m_linkStatsTask, enabled);
+    // Enabled separately, once the probe characteristic is subscribed
+    if (!enabled)
+        m_scheduler->setTaskEnabled(m_clockProbeTask, false);
+}
+
+void BleClient::sendClockProbe()
+{
+    if (!m_service)
+        return;
+    const QLowEnergyCharacteristic probeChar = m_service->characteristic(PROBE_CHARACTERISTIC_UUID);
+    if (!probeChar.isValid())
+        return;
+    // One probe in flight; a lost reply is simply superseded by the next one
+    const QLowEnergyService::WriteMode mode = (probeChar.properties() & QLowEnergyCharacteristic::WriteNoResponse)
+        ? QLowEnergyService::WriteWithoutResponse
+        : QLowEnergyService::WriteWithResponse;
+    ++m_probeId;
+    m_probeSendNs = monotonicNowNs();
+    m_service->writeCharacteristic(probeChar, QByteArray::number(m_probeId), mode);
+}
+
+void BleClient::handleProbeReply(const QByteArray &value, qint64 receiveNs)
+{
+    const char *begin = value.constData();
+    const char *end = begin + value.size();
+    const char *comma = std::find(begin, end, ',');
+    qint64 id = 0;
+    qint64 deviceTimeUs = 0;
+    if (comma == end || !vitalsparser::parseCounter(begin, comma, id)
+        || !vitalsparser::parseCounter(comma + 1, end, deviceTimeUs)) {
+        LOG_DEBUG("ble.clock_probe_malformed").field("size", value.size());
+        return;
+    }
+    if (m_probeSendNs < 0 || quint64(id) != m_probeId)
+        return;
+    const qint64 sendNs = m_probeSendNs;
+    m_probeSendNs = -1;
+    m_clockSync.addRoundTrip(sendNs, deviceTimeUs, receiveNs);
+    LOG_DEBUG("ble.clock_probe").field("id", id).field("rtt_ms", (receiveNs - sendNs) / 1e6);
+}
+
 // --- Connection Slots ---
 
 void BleClient::deviceConnected()
 {
     setStatus(tr("Connected. Discovering services..."));
+    m_scanToConnectedMs = m_connectTimer.elapsed();
+
+    // Fresh telemetry for every connection
+    m_linkStats.reset();
+    setTelemetryEnabled(true);
+    // The device may have rebooted since the last connection
+    m_clockSync.reset();
+    m_probeSendNs = -1;
 
     // The key step immediately after connection: start service discovery.
     // The stability issue will be solved on the ESP32 side (see section 2).
@@ -140,6 +323,8 @@ void BleClient::deviceConnected()
 void BleClient::deviceDisconnected()
 {
     setStatus(tr("Disconnected. Ready to scan."));
+    setTelemetryEnabled(false);
+    publishLinkStats();
     if (m_control) {
         m_control->deleteLater();
         m_control = nullptr;
@@ -209,7 +394,7 @@ void BleClient::serviceStateChanged(QLowEnergyService::ServiceState newState)
             return;
         }
 
-            connect(m_service, &QLowEnergyService::characteristicRead, this, &BleClient::characteristicChanged);
+        connect(m_service, &QLowEnergyService::characteristicRead, this, &BleClient::characteristicChanged);
 
         // Connect to characteristic value change signal
         connect(m_service, &QLowEnergyService::characteristicChanged,
@@ -218,33 +403,73 @@ void BleClient::serviceStateChanged(QLowEnergyService::ServiceState newState)
         connect(m_service, &QLowEnergyService::errorOccurred,
                 this, &BleClient::serviceError);
 
-        // Find the Client Characteristic Configuration Descriptor (CCCD)
-        // Use the raw 16-bit UUID (0x2902) which is stable across Qt versions
-        QLowEnergyDescriptor notificationDesc = dataChar.descriptor(
-            QBluetoothUuid(quint16(0x2902)));
-
-        if (notificationDesc.isValid()) {
-            // Write the value to enable notifications (0x0001)
-            // Use writeDescriptor on the service object
-            m_service->writeDescriptor(notificationDesc, QByteArray::fromHex("0100"));
+        if (subscribe(dataChar)) {
             setStatus(tr("Subscribed successfully. Waiting for data..."));
+
+            const qint64 scanToSubscribedMs = m_connectTimer.elapsed();
+            m_linkStats.recordConnectTiming(m_scanToFoundMs, m_scanToConnectedMs, scanToSubscribedMs);
+            LOG_INFO("ble.connect").field("found_ms", m_scanToFoundMs)
+                .field("connected_ms", m_scanToConnectedMs).field("subscribed_ms", scanToSubscribedMs);
         } else {
             setStatus(tr("Warning: Cannot subscribe (CCCD not found)."));
         }
+
+        // The camera stream is optional; older sketches only send vitals
+        QLowEnergyCharacteristic frameChar = m_service->characteristic(FRAME_CHARACTERISTIC_UUID);
+        if (frameChar.isValid() && !subscribe(frameChar))
+            qWarning() << "Camera frame characteristic has no CCCD, frames disabled";
+
+        // So is the clock probe; without it ages rely on the sample timestamps alone
+        QLowEnergyCharacteristic probeChar = m_service->characteristic(PROBE_CHARACTERISTIC_UUID);
+        if (probeChar.isValid() && subscribe(probeChar) && m_scheduler)
+            m_scheduler->setTaskEnabled(m_clockProbeTask, true);
     }
 }
 
+bool BleClient::subscribe(const QLowEnergyCharacteristic &characteristic)
+{
+    // Find the Client Characteristic Configuration Descriptor (CCCD)
+    // Use the raw 16-bit UUID (0x2902) which is stable across Qt versions
+    QLowEnergyDescriptor notificationDesc = characteristic.descriptor(
+        QBluetoothUuid(quint16(0x2902)));
+
+    if (!notificationDesc.isValid())
+        return false;
+
+    // Write the value to enable notifications (0x0001)
+    // Use writeDescriptor on the service object
+    m_service->writeDescriptor(notificationDesc, QByteArray::fromHex("0100"));
+    return true;
+}
+
 void BleClient::characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &value)
 {
     // Explicitly cast CHARACTERISTIC_UUID (QUuid) to QBluetoothUuid to avoid ambiguity
     if (characteristic.uuid() == QBluetoothUuid(CHARACTERISTIC_UUID)) {
-        // The data is assumed to be a simple UTF-8 string from the ESP32
-        QString receivedString = QString::fromUtf8(value);
-        setData(receivedString);
-
+        handleVitals(value);
+    } else if (characteristic.uuid() == QBluetoothUuid(FRAME_CHARACTERISTIC_UUID)) {
+        // Camera chunks are copied into the frame pool, never converted to text
+        m_frameAssembler->addChunk(value, monotonicNowNs());
+    } else if (characteristic.uuid() == QBluetoothUuid(PROBE_CHARACTERISTIC_UUID)) {
+        handleProbeReply(value, monotonicNowNs());
     }
 }
 
+void BleClient::injectVitals(const QByteArray &value)
+{
+    handleVitals(value);
+}
+
+void BleClient::handleVitals(const QByteArray &value)
+{
+    const qint64 arrivalNs = monotonicNowNs();
+    m_linkStats.recordArrival(arrivalNs);
+
+    // The data is a short ASCII string from the ESP32, parsed in place
+    setData(value);
+    parseData(value, arrivalNs);
+}
+
 void BleClient::serviceError(QLowEnergyService::ServiceError newError)
 {
     // This slot is called if ANY service operation fails, including the CCCD write.
@@ -255,3 +480,25 @@ void BleClient::serviceError(QLowEnergyService::ServiceError newError)
         disconnectDevice();
     }
 }
+
+// --- Link Telemetry Slots ---
+
+void BleClient::rssiRead(qint16 rssi)
+{
+    m_linkStats.recordRssi(rssi);
+}
+
+void BleClient::publishLinkStats()
+{
+    LinkStatsSnapshot stats = m_linkStats.snapshot(monotonicNowNs());
+    stats.clock = m_clockSync.estimate();
+    LOG_INFO("ble.link").field("rssi", stats.rssiValid ? int(stats.rssi) : 0)
+        .field("rate_1s", stats.rate1s).field("rate_10s", stats.rate10s)
+        .field("inter_arrival_ms", stats.lastInterArrivalMs).field("jitter_ms", stats.jitterMs)
+        .field("notifications", stats.notifications);
+    if (stats.clock.valid) {
+        LOG_INFO("ble.clock").field("drift_ppm", stats.clock.driftPpm).field("round_trip", stats.clock.roundTrip)
+            .field("uncertainty_ms", stats.clock.uncertaintyMs).field("windows", stats.clock.windows).field("probes", stats.clock.probes);
+    }
+    emit linkStatsUpdated(stats);
+}
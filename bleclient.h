@@ -7,11 +7,24 @@
 #include <QLowEnergyService>
 #include <QByteArray>
 #include <QUuid>
+#include <QElapsedTimer>
+
+#include "vitalssample.h"
+#include "linkstats.h"
+#include "cameraframes.h"
+
+class QThread;
+class TickScheduler;
 
 // UUIDs for the ESP32 Service and Characteristic
 // Match these to the ESP32 sketch!
 const QUuid SERVICE_UUID("{4fafc201-1fb5-459e-8fcc-c5c9c331914b}");
 const QUuid CHARACTERISTIC_UUID("{beb5483e-36e1-4688-b7f5-ea07361b26a8}");
+// Optional chunked JPEG stream, see cameraframes.h for the chunk format
+const QUuid FRAME_CHARACTERISTIC_UUID("{beb5483e-36e1-4688-b7f5-ea07361b26a9}");
+// Optional clock probe: the app writes an ASCII probe id, the ESP32 notifies
+// "<id>,<its clock in microseconds>" back on the same characteristic
+const QUuid PROBE_CHARACTERISTIC_UUID("{beb5483e-36e1-4688-b7f5-ea07361b26aa}");
 
 class BleClient : public QObject
 {
@@ -19,29 +32,51 @@ class BleClient : public QObject
     // 1. Properties exposed to QML (used for signals)
     Q_PROPERTY(QString status READ status NOTIFY statusChanged)
     Q_PROPERTY(QString data READ data NOTIFY dataReceived)
-    Q_PROPERTY(bool isScanning READ isScanning NOTIFY scanFinished)
+    Q_PROPERTY(bool isScanning READ isScanning NOTIFY scanningChanged)
+    Q_PROPERTY(int discoveryTimeout READ discoveryTimeout WRITE setDiscoveryTimeout)
 
 public:
     explicit BleClient(QObject *parent = nullptr);
+    ~BleClient() override;
 
     // Getters for the properties (REQUIRED by Q_PROPERTY)
     QString status() const { return m_status; }
-    QString data() const { return m_data; }
+    QString data() const { return QString::fromUtf8(m_data); }
     bool isScanning() const { return m_isScanning; }
+    int discoveryTimeout() const { return m_discoveryTimeoutMs; }
+
+    // Periodic link telemetry runs as scheduler tasks; call before moveToThread()
+    void setScheduler(TickScheduler *scheduler);
 
 public slots:
     void startScan();
     void disconnectDevice();
+    // Re-emits the current status and scanning state (the client runs on its
+    // own thread, so the UI asks for them instead of calling the getters)
+    void publishState();
+    // Low Energy scan timeout in milliseconds (0 scans until stopped)
+    void setDiscoveryTimeout(int timeoutMs);
+    // Runs `value` through the same path as a notification of
+    // CHARACTERISTIC_UUID, without a device (stress tools)
+    void injectVitals(const QByteArray &value);
 
 signals:
     // Signals to notify the UI of state changes
     void statusChanged(const QString &newStatus);
     void dataReceived(const QString &newData);
-    void scanFinished();
+    void scanningChanged(bool scanning);
+    // Parsed on the BLE thread; only these cross over to the UI
+    void sampleReceived(const VitalsSample &sample);
+    void sampleRejected(SampleRejection reason, const QString &rawData);
+    // Periodic radio link telemetry while connected
+    void linkStatsUpdated(const LinkStatsSnapshot &stats);
+    // Emitted from the frame decoder thread
+    void frameDecoded(const QImage &image, const FrameTiming &timing);
 
 private slots:
     // Discovery
     void deviceDiscovered(const QBluetoothDeviceInfo &device);
+    void deviceUpdated(const QBluetoothDeviceInfo &device, QBluetoothDeviceInfo::Fields updatedFields);
     void scanError(QBluetoothDeviceDiscoveryAgent::Error error);
 
     // Connection
@@ -55,6 +90,10 @@ private slots:
     void serviceStateChanged(QLowEnergyService::ServiceState newState);
     void characteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &value);
     void serviceError(QLowEnergyService::ServiceError newError);
+
+    // Link telemetry
+    void rssiRead(qint16 rssi);
+    void publishLinkStats();
 private:
     QBluetoothDeviceDiscoveryAgent *m_deviceDiscoveryAgent = nullptr;
     QLowEnergyController *m_control = nullptr;
@@ -63,12 +102,44 @@ private:
 
     // Private member variables holding the state
     QString m_status;
-    QString m_data;
+    QByteArray m_data;
     bool m_isScanning = false;
+    int m_discoveryTimeoutMs = 10000;
+
+    // Time-to-connect measurement, started in startScan()
+    QElapsedTimer m_connectTimer;
+    qint64 m_scanToFoundMs = -1;
+    qint64 m_scanToConnectedMs = -1;
+    quint64 m_sampleSequence = 0;
+
+    // Link quality telemetry, sampled while connected
+    LinkStats m_linkStats;
+    TickScheduler *m_scheduler = nullptr;
+    int m_rssiTask = -1;
+    int m_linkStatsTask = -1;
+
+    // Device clock estimate from sample timestamps and round-trip probes
+    ClockSync m_clockSync;
+    int m_clockProbeTask = -1;
+    quint64 m_probeId = 0;
+    qint64 m_probeSendNs = -1;
+
+    // Camera frames: reassembled on this thread, decoded on m_decoderThread
+    FrameBufferPool m_framePool;
+    FrameDecoder *m_frameDecoder = nullptr;
+    QThread *m_decoderThread = nullptr;
+    FrameAssembler *m_frameAssembler = nullptr;
 
     void setStatus(const QString &newStatus);
     void setIsScanning(bool scanning);
-    void setData(const QString &newData);
+    void setData(const QByteArray &newData);
+    void handleVitals(const QByteArray &value);
+    void parseData(const QByteArray &payload, qint64 arrivalNs);
+    bool isTargetDevice(const QBluetoothDeviceInfo &device) const;
+    bool subscribe(const QLowEnergyCharacteristic &characteristic);
+    void setTelemetryEnabled(bool enabled);
+    void sendClockProbe();
+    void handleProbeReply(const QByteArray &value, qint64 receiveNs);
 };
 
 #endif // BLECLIENT_H
@@ -0,0 +1,166 @@
+// Delivery of BLE samples to a stalling GUI thread.
+//
+// Runs a BleClient on its own I/O thread as the app does and feeds it vitals
+// notifications through BleClient::injectVitals() at the sensor rate, from a
+// thread standing in for the Bluetooth stack. The main thread receives
+// sampleReceived like GuiWindow and sleeps inside the receiver at a fixed
+// period, standing in for a long paint, dialog or inference. Reports the
+// delivery delay (arrival on the BLE thread to the receiver) as percentiles,
+// the backlog the stalls build up, how far the BLE thread itself fell behind
+// the notifications, and samples lost (sequence gaps, rejected payloads, or
+// never delivered).
+//
+//   blestall [--rate 20] [--seconds 10] [--stall-ms 200] [--stall-every 1000]
+//
+// --stall-ms 0 gives the baseline without stalls.
+//
+// Runs on the desktop (Linux x86) as well as on the device (adb shell).
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "bleclient.h"
+#include "vitalssample.h"
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+double percentileMs(const std::vector<qint64> &sorted, double q)
+{
+    if (sorted.empty())
+        return 0.0;
+    // Nearest-rank percentile
+    const size_t rank = size_t(std::ceil(q * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)] / 1e6;
+}
+
+void printLatencies(const char *name, std::vector<qint64> &latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+    out() << "  " << name << " ms: p50 " << QString::number(percentileMs(latencies, 0.50), 'f', 2)
+          << ", p95 " << QString::number(percentileMs(latencies, 0.95), 'f', 2)
+          << ", p99 " << QString::number(percentileMs(latencies, 0.99), 'f', 2)
+          << ", max " << QString::number(percentileMs(latencies, 1.0), 'f', 2) << Qt::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("blestall");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Delivery delay and loss of BLE samples to a stalling GUI thread.");
+    parser.addHelpOption();
+    QCommandLineOption rateOption({"r", "rate"}, "Notifications per second.", "hz", "20");
+    QCommandLineOption secondsOption({"s", "seconds"}, "Run duration.", "seconds", "10");
+    QCommandLineOption stallOption("stall-ms", "How long each stall blocks the receiver.", "ms", "200");
+    QCommandLineOption stallEveryOption("stall-every", "Time between stalls.", "ms", "1000");
+    parser.addOptions({rateOption, secondsOption, stallOption, stallEveryOption});
+    parser.process(app);
+
+    const double rate = qBound(0.1, parser.value(rateOption).toDouble(), 10000.0);
+    const int seconds = qMax(1, parser.value(secondsOption).toInt());
+    const int stallMs = qMax(0, parser.value(stallOption).toInt());
+    const qint64 stallEveryNs = qMax(1, parser.value(stallEveryOption).toInt()) * qint64(1000000);
+
+    // --- BLE Client, as in main.cpp ---
+    QThread bleThread;
+    bleThread.setObjectName(QStringLiteral("BleIoThread"));
+    BleClient *client = new BleClient();
+    client->moveToThread(&bleThread);
+    QObject::connect(&bleThread, &QThread::finished, client, &QObject::deleteLater);
+    bleThread.start();
+
+    // --- Receiver, as in GuiWindow ---
+    std::atomic<quint64> sent{0};
+    quint64 received = 0;
+    quint64 gaps = 0;
+    quint64 rejected = 0;
+    quint64 lastSequence = 0;
+    quint64 maxBacklog = 0;
+    quint64 stalls = 0;
+    std::vector<qint64> deliveryNs;
+    std::vector<qint64> bleLagNs;
+    qint64 nextStallNs = monotonicNowNs() + stallEveryNs;
+    QObject::connect(client, &BleClient::sampleReceived, &app, [&](const VitalsSample &sample) {
+        const qint64 nowNs = monotonicNowNs();
+        ++received;
+        deliveryNs.push_back(nowNs - sample.arrivalNs);
+        // The payload carries its send time where the ESP32 puts its clock
+        if (sample.deviceTimeUs >= 0)
+            bleLagNs.push_back(sample.arrivalNs - sample.deviceTimeUs * 1000);
+        if (lastSequence != 0 && sample.sequence > lastSequence + 1)
+            gaps += sample.sequence - lastSequence - 1;
+        lastSequence = sample.sequence;
+        const quint64 sentNow = sent.load();
+        maxBacklog = qMax(maxBacklog, sentNow - qMin(sentNow, sample.sequence));
+
+        if (stallMs > 0 && nowNs >= nextStallNs) {
+            ++stalls;
+            QThread::msleep(stallMs);
+            nextStallNs = monotonicNowNs() + stallEveryNs;
+        }
+    });
+    QObject::connect(client, &BleClient::sampleRejected, &app, [&](SampleRejection, const QString &) { ++rejected; });
+
+    // --- Notifications ---
+    std::atomic<bool> sending{true};
+    std::thread stack([&]() {
+        const qint64 intervalNs = qint64(1e9 / rate);
+        const quint64 count = quint64(rate * seconds);
+        const qint64 startNs = monotonicNowNs();
+        for (quint64 n = 0; n < count; ++n) {
+            const qint64 dueNs = startNs + qint64(n) * intervalNs;
+            while (monotonicNowNs() < dueNs)
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            const qint64 sendNs = monotonicNowNs();
+            const QByteArray payload = QByteArray::number(36.5 + 0.1 * (n % 10), 'f', 1) + ','
+                                       + QByteArray::number(120 + n % 20) + ','
+                                       + QByteArray::number(sendNs / 1000);
+            ++sent;
+            QMetaObject::invokeMethod(client, [client, payload]() { client->injectVitals(payload); },
+                                      Qt::QueuedConnection);
+        }
+        sending = false;
+    });
+
+    while (sending.load())
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    stack.join();
+    // Let the backlog drain; whatever is still missing after that is lost
+    QElapsedTimer drain;
+    drain.start();
+    while (received + rejected < sent.load() && drain.elapsed() < 2000)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    bleThread.quit();
+    bleThread.wait();
+
+    // --- Report ---
+    const quint64 undelivered = sent.load() - qMin(sent.load(), received + rejected);
+    out() << "Sent: " << sent.load() << " notifications at " << rate << " Hz over " << seconds << " s" << Qt::endl;
+    out() << "Stalls: " << stalls << " of " << stallMs << " ms, every "
+          << stallEveryNs / 1000000 << " ms" << Qt::endl;
+    out() << "Received: " << received << ", lost " << gaps + rejected + undelivered << " (" << gaps
+          << " sequence gaps, " << rejected << " rejected, " << undelivered << " undelivered), backlog up to "
+          << maxBacklog << " samples" << Qt::endl;
+    printLatencies("delivery (BLE thread to receiver)", deliveryNs);
+    printLatencies("BLE thread behind the notification", bleLagNs);
+    return gaps + rejected + undelivered == 0 ? 0 : 2;
+}
@@ -0,0 +1,229 @@
+#include "cameraframes.h"
+
+#include <QByteArrayView>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <cstring>
+
+#include "vitalssample.h"
+
+namespace {
+
+const qint64 NS_PER_SECOND = 1000000000;
+
+} // namespace
+
+// --- FrameChunk ---
+
+bool FrameChunk::parse(const QByteArray &value, FrameChunk &chunk)
+{
+    if (value.size() < HeaderSize)
+        return false;
+
+    const char *raw = value.constData();
+    chunk.frameId = qFromLittleEndian<quint16>(raw);
+    chunk.offset = qFromLittleEndian<quint32>(raw + 2);
+    chunk.endOfFrame = (quint8(raw[6]) & EndOfFrame) != 0;
+    chunk.payload = raw + HeaderSize;
+    chunk.payloadSize = value.size() - HeaderSize;
+    return true;
+}
+
+// --- FrameBufferPool ---
+
+FrameBufferPool::FrameBufferPool()
+{
+    // All frame memory is allocated here, once
+    for (Buffer &buffer : m_buffers)
+        buffer.data.resize(MaxFrameSize);
+    m_states.fill(State::Free);
+}
+
+int FrameBufferPool::indexOf(const Buffer *buffer) const
+{
+    return int(buffer - m_buffers.data());
+}
+
+FrameBufferPool::Buffer *FrameBufferPool::acquire()
+{
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < BufferCount; ++i) {
+        if (m_states[i] == State::Free) {
+            m_states[i] = State::Assembling;
+            m_buffers[i].size = 0;
+            return &m_buffers[i];
+        }
+    }
+    return nullptr;
+}
+
+void FrameBufferPool::release(Buffer *buffer)
+{
+    QMutexLocker locker(&m_mutex);
+    m_states[indexOf(buffer)] = State::Free;
+}
+
+bool FrameBufferPool::publish(Buffer *buffer)
+{
+    QMutexLocker locker(&m_mutex);
+    bool replaced = false;
+    for (State &state : m_states) {
+        if (state == State::Ready) {
+            // The decoder never got to it and a newer frame is here: drop it
+            state = State::Free;
+            ++m_dropped;
+            replaced = true;
+        }
+    }
+    m_states[indexOf(buffer)] = State::Ready;
+    return replaced;
+}
+
+FrameBufferPool::Buffer *FrameBufferPool::takeReady()
+{
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < BufferCount; ++i) {
+        if (m_states[i] == State::Ready) {
+            m_states[i] = State::Decoding;
+            return &m_buffers[i];
+        }
+    }
+    return nullptr;
+}
+
+// --- FrameDecoder ---
+
+FrameDecoder::FrameDecoder(FrameBufferPool *pool, QObject *parent)
+    : QObject(parent), m_pool(pool)
+{
+}
+
+void FrameDecoder::scheduleDecode()
+{
+    // One queued request is enough, it always decodes the newest frame
+    if (!m_scheduled.exchange(true))
+        QMetaObject::invokeMethod(this, &FrameDecoder::decodeReady, Qt::QueuedConnection);
+}
+
+void FrameDecoder::decodeReady()
+{
+    m_scheduled = false;
+
+    while (FrameBufferPool::Buffer *buffer = m_pool->takeReady()) {
+        QImage image = QImage::fromData(QByteArrayView(buffer->data.constData(), buffer->size), "JPG");
+        FrameTiming timing = buffer->timing;
+        m_pool->release(buffer);
+
+        if (image.isNull()) {
+            m_pool->countDropped();
+            continue;
+        }
+
+        timing.decodedNs = monotonicNowNs();
+        if (timing.decodedNs - m_windowStartNs >= NS_PER_SECOND) {
+            if (m_windowStartNs != 0)
+                m_framesPerSecond = m_windowFrames * double(NS_PER_SECOND) / (timing.decodedNs - m_windowStartNs);
+            m_windowStartNs = timing.decodedNs;
+            m_windowFrames = 0;
+        }
+        ++m_windowFrames;
+        timing.framesPerSecond = m_framesPerSecond;
+        timing.droppedFrames = m_pool->droppedFrames();
+
+        emit frameDecoded(image, timing);
+    }
+}
+
+// --- LatestFrame ---
+
+bool LatestFrame::put(const QImage &image, const FrameTiming &timing)
+{
+    QMutexLocker locker(&m_mutex);
+    // QImage is implicitly shared; only the reference is swapped
+    m_image = image;
+    m_timing = timing;
+    if (m_pending) {
+        ++m_skipped;
+        return false;
+    }
+    m_pending = true;
+    return true;
+}
+
+bool LatestFrame::take(QImage &image, FrameTiming &timing)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_pending)
+        return false;
+    m_pending = false;
+    // The receiver holds the only reference from here on
+    image = std::move(m_image);
+    m_image = QImage();
+    timing = m_timing;
+    return true;
+}
+
+// --- FrameAssembler ---
+
+FrameAssembler::FrameAssembler(FrameBufferPool *pool, FrameDecoder *decoder)
+    : m_pool(pool), m_decoder(decoder)
+{
+}
+
+void FrameAssembler::dropCurrent()
+{
+    if (m_current) {
+        m_pool->release(m_current);
+        m_pool->countDropped();
+        m_current = nullptr;
+    }
+    m_skipping = true;
+}
+
+void FrameAssembler::addChunk(const QByteArray &value, qint64 arrivalNs)
+{
+    FrameChunk chunk;
+    if (!FrameChunk::parse(value, chunk))
+        return;
+
+    if (chunk.frameId != m_currentId || (!m_current && !m_skipping)) {
+        // A new frame starts; an unfinished previous one will never complete
+        dropCurrent();
+        m_currentId = chunk.frameId;
+        m_skipping = false;
+        m_expectedOffset = 0;
+
+        m_current = m_pool->acquire();
+        if (!m_current) {
+            m_pool->countDropped();
+            m_skipping = true;
+            return;
+        }
+        m_current->timing = FrameTiming();
+        m_current->timing.frameId = chunk.frameId;
+        m_current->timing.firstChunkNs = arrivalNs;
+    }
+
+    if (m_skipping)
+        return;
+
+    // Notifications arrive in order, so a gap means a chunk was lost
+    if (chunk.offset != m_expectedOffset
+        || qsizetype(chunk.offset) + chunk.payloadSize > FrameBufferPool::MaxFrameSize) {
+        dropCurrent();
+        return;
+    }
+
+    std::memcpy(m_current->data.data() + chunk.offset, chunk.payload, size_t(chunk.payloadSize));
+    m_expectedOffset += quint32(chunk.payloadSize);
+    m_current->size = m_expectedOffset;
+
+    if (chunk.endOfFrame) {
+        m_current->timing.completeNs = arrivalNs;
+        m_pool->publish(m_current);
+        m_current = nullptr;
+        // Ignore any duplicate chunk of the frame we just finished
+        m_skipping = true;
+        m_decoder->scheduleDecode();
+    }
+}
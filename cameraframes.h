@@ -0,0 +1,162 @@
+#ifndef CAMERAFRAMES_H
+#define CAMERAFRAMES_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QMetaType>
+#include <QMutex>
+#include <QObject>
+#include <array>
+#include <atomic>
+
+// JPEG frames from the ESP32-CAM arrive split across notifications of
+// FRAME_CHARACTERISTIC_UUID. Every notification starts with an 8 byte header:
+//
+//   u16 frame id (little endian)
+//   u32 byte offset of this chunk within the frame (little endian)
+//   u8  flags, bit 0 set on the last chunk of the frame
+//   u8  reserved
+//
+// followed by the chunk payload.
+
+struct FrameChunk {
+    static constexpr int HeaderSize = 8;
+    static constexpr quint8 EndOfFrame = 0x01;
+
+    quint16 frameId = 0;
+    quint32 offset = 0;
+    bool endOfFrame = false;
+    const char *payload = nullptr;
+    qsizetype payloadSize = 0;
+
+    // Returns false if the notification is too short to hold a header
+    static bool parse(const QByteArray &value, FrameChunk &chunk);
+};
+
+// Per-frame timing, steady_clock based (see monotonicNowNs())
+struct FrameTiming {
+    quint16 frameId = 0;
+    qint64 firstChunkNs = 0;
+    qint64 completeNs = 0;
+    qint64 decodedNs = 0;
+    double framesPerSecond = 0.0;
+    quint64 droppedFrames = 0;
+};
+Q_DECLARE_METATYPE(FrameTiming)
+
+// Preallocated frame buffers shared by the assembler (BLE thread) and the
+// decoder (worker thread). A buffer is Assembling, Ready or Decoding; there is
+// at most one of each, so three buffers always suffice and nothing is ever
+// queued: a Ready frame that is overtaken by a newer one is dropped as late.
+class FrameBufferPool
+{
+public:
+    static constexpr int BufferCount = 3;
+    static constexpr qsizetype MaxFrameSize = 128 * 1024;
+
+    struct Buffer {
+        QByteArray data;
+        qsizetype size = 0;
+        FrameTiming timing;
+    };
+
+    FrameBufferPool();
+
+    // Assembler side
+    Buffer *acquire();
+    void release(Buffer *buffer);
+    // Marks `buffer` as the newest complete frame; returns true if it
+    // replaced one the decoder had not picked up yet
+    bool publish(Buffer *buffer);
+
+    // Decoder side: the newest complete frame, or nullptr
+    Buffer *takeReady();
+
+    quint64 droppedFrames() const { return m_dropped.load(); }
+    void countDropped() { ++m_dropped; }
+
+private:
+    enum class State { Free, Assembling, Ready, Decoding };
+
+    QMutex m_mutex;
+    std::array<Buffer, BufferCount> m_buffers;
+    std::array<State, BufferCount> m_states;
+    std::atomic<quint64> m_dropped{0};
+
+    int indexOf(const Buffer *buffer) const;
+};
+
+// Lives on its own worker thread; decodes the newest ready frame to a QImage
+class FrameDecoder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FrameDecoder(FrameBufferPool *pool, QObject *parent = nullptr);
+
+    // Thread-safe; posts at most one pending decode request at a time
+    void scheduleDecode();
+
+signals:
+    void frameDecoded(const QImage &image, const FrameTiming &timing);
+
+private slots:
+    void decodeReady();
+
+private:
+    FrameBufferPool *m_pool;
+    std::atomic<bool> m_scheduled{false};
+
+    // Frame rate over a sliding one second window
+    qint64 m_windowStartNs = 0;
+    int m_windowFrames = 0;
+    double m_framesPerSecond = 0.0;
+};
+
+// Hands decoded frames to a receiver on another thread, newest only. A queued
+// connection would post every frame and build a backlog behind a busy
+// receiver; here a frame that arrives before the receiver took the previous
+// one replaces it, and at most one delivery is queued at a time.
+class LatestFrame
+{
+public:
+    // Producer side; returns true if no delivery is pending, i.e. the caller
+    // must queue one
+    bool put(const QImage &image, const FrameTiming &timing);
+    // Receiver side; false if a previous delivery already took the frame
+    bool take(QImage &image, FrameTiming &timing);
+
+    // Frames replaced before the receiver got to them
+    quint64 skippedFrames() const { return m_skipped.load(); }
+
+private:
+    QMutex m_mutex;
+    QImage m_image;
+    FrameTiming m_timing;
+    bool m_pending = false;
+    std::atomic<quint64> m_skipped{0};
+};
+
+// Runs on the BLE thread: copies chunks straight into a pooled buffer and
+// hands complete frames to the decoder
+class FrameAssembler
+{
+public:
+    FrameAssembler(FrameBufferPool *pool, FrameDecoder *decoder);
+
+    void addChunk(const QByteArray &value, qint64 arrivalNs);
+
+private:
+    FrameBufferPool *m_pool;
+    FrameDecoder *m_decoder;
+
+    FrameBufferPool::Buffer *m_current = nullptr;
+    quint16 m_currentId = 0;
+    quint32 m_expectedOffset = 0;
+    // Set when the current frame id was given up; its remaining chunks are skipped
+    bool m_skipping = false;
+
+    void dropCurrent();
+};
+
+#endif // CAMERAFRAMES_H
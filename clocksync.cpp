@@ -0,0 +1,178 @@
+#include "clocksync.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// A device clock this far behind its last sample has restarted
+const qint64 RESTART_THRESHOLD_NS = 1000000000;
+// Shorter fits take the delay jitter for drift
+const double MIN_FIT_SPAN_NS = 60e9;
+
+} // namespace
+
+void ClockSync::start(qint64 deviceNs, qint64 localNs)
+{
+    if (m_started && deviceNs + RESTART_THRESHOLD_NS < m_deviceOriginNs + qint64(m_lastX))
+        reset();
+    if (m_started)
+        return;
+    m_started = true;
+    m_deviceOriginNs = deviceNs;
+    m_localOriginNs = localNs;
+}
+
+void ClockSync::addArrival(qint64 deviceTimeUs, qint64 arrivalNs)
+{
+    const qint64 deviceNs = deviceTimeUs * 1000;
+    start(deviceNs, arrivalNs);
+    const qint64 sinceOriginNs = deviceNs - m_deviceOriginNs;
+    if (sinceOriginNs < 0)
+        return;
+    const double x = double(sinceOriginNs);
+    const double y = double(arrivalNs - m_localOriginNs) - x;
+    m_lastX = qMax(m_lastX, x);
+
+    // Keep only the fastest arrival of each window; after a gap, windows
+    // older than the fit are ignored until overwritten
+    const qint64 window = sinceOriginNs / WindowNs;
+    m_lastWindow = qMax(m_lastWindow, window);
+    Point &slot = m_minima[window % WindowCount];
+    if (slot.window != window) {
+        slot = Point{window, x, y};
+        refit();
+    } else if (y < slot.y) {
+        slot.x = x;
+        slot.y = y;
+        refit();
+    }
+}
+
+void ClockSync::addRoundTrip(qint64 sendNs, qint64 deviceTimeUs, qint64 receiveNs)
+{
+    if (receiveNs < sendNs)
+        return;
+    const qint64 deviceNs = deviceTimeUs * 1000;
+    // The device read its clock somewhere between send and receive
+    const qint64 midpointNs = sendNs + (receiveNs - sendNs) / 2;
+    start(deviceNs, midpointNs);
+    const double x = double(deviceNs - m_deviceOriginNs);
+
+    m_probes[m_nextProbe] = Point{0, x, double(midpointNs - m_localOriginNs) - x};
+    m_probeRttNs[m_nextProbe] = double(receiveNs - sendNs);
+    m_nextProbe = (m_nextProbe + 1) % ProbeCount;
+    m_probeCount = qMin(m_probeCount + 1, ProbeCount);
+    refit();
+}
+
+void ClockSync::reset()
+{
+    *this = ClockSync();
+}
+
+void ClockSync::refit()
+{
+    std::array<Point, WindowCount> points;
+    int n = 0;
+    for (const Point &p : m_minima) {
+        if (isLive(p))
+            points[n++] = p;
+    }
+    m_windows = n;
+    std::sort(points.begin(), points.begin() + n, [](const Point &a, const Point &b) { return a.x < b.x; });
+
+    // Of all lines below every minimum, the one closest to them on average:
+    // the edge of their lower convex hull above the mean x (Moon et al.,
+    // "Estimation and removal of clock skew from network delay measurements")
+    m_slope = 0.0;
+    m_envelopeIntercept = 0.0;
+    if (n > 0) {
+        m_envelopeIntercept = points[0].y;
+        for (int i = 1; i < n; ++i)
+            m_envelopeIntercept = qMin(m_envelopeIntercept, points[i].y);
+    }
+    if (n >= 3 && points[n - 1].x - points[0].x >= MIN_FIT_SPAN_NS) {
+        std::array<Point, WindowCount> hull;
+        int h = 0;
+        double meanX = 0.0;
+        for (int i = 0; i < n; ++i) {
+            const Point &p = points[i];
+            meanX += p.x;
+            // Monotone chain: drop the last vertex while it is not below the new edge
+            while (h >= 2 && (hull[h - 1].x - hull[h - 2].x) * (p.y - hull[h - 2].y)
+                                 - (hull[h - 1].y - hull[h - 2].y) * (p.x - hull[h - 2].x) <= 0.0)
+                --h;
+            hull[h++] = p;
+        }
+        meanX /= n;
+        int edge = 0;
+        while (edge + 2 < h && hull[edge + 1].x < meanX)
+            ++edge;
+        m_slope = (hull[edge + 1].y - hull[edge].y) / (hull[edge + 1].x - hull[edge].x);
+        m_envelopeIntercept = hull[edge].y - m_slope * hull[edge].x;
+    }
+
+    // Transit delays are never negative, so the true line lies at or below
+    // the envelope; each probe brackets it within half its round trip.
+    // Within the intersection of those bounds, the shortest round trip's
+    // midpoint is the best guess (as in NTP), assuming symmetric delays.
+    m_intercept = m_envelopeIntercept;
+    m_uncertaintyNs = 0.0;
+    if (m_probeCount == 0)
+        return;
+    double low = std::numeric_limits<double>::lowest();
+    double high = (n > 0) ? m_envelopeIntercept : std::numeric_limits<double>::max();
+    int best = 0;
+    for (int i = 0; i < m_probeCount; ++i) {
+        const double centre = m_probes[i].y - m_slope * m_probes[i].x;
+        low = qMax(low, centre - m_probeRttNs[i] / 2.0);
+        high = qMin(high, centre + m_probeRttNs[i] / 2.0);
+        if (m_probeRttNs[i] < m_probeRttNs[best])
+            best = i;
+    }
+    const double bestCentre = m_probes[best].y - m_slope * m_probes[best].x;
+    if (low <= high) {
+        m_intercept = qBound(low, bestCentre, high);
+        m_uncertaintyNs = qMax(m_intercept - low, high - m_intercept);
+    } else {
+        // Inconsistent bounds (a drift change, or a probe answered late):
+        // trust the shortest round trip alone
+        m_intercept = bestCentre;
+        m_uncertaintyNs = m_probeRttNs[best] / 2.0;
+    }
+}
+
+qint64 ClockSync::toLocalNs(qint64 deviceTimeUs) const
+{
+    if (!isValid())
+        return -1;
+    const double x = double(deviceTimeUs * 1000 - m_deviceOriginNs);
+    return m_localOriginNs + qint64(x + m_intercept + m_slope * x);
+}
+
+ClockEstimate ClockSync::estimate() const
+{
+    ClockEstimate estimate;
+    estimate.valid = isValid();
+    estimate.roundTrip = (m_probeCount > 0);
+    estimate.offsetMs = (double(m_localOriginNs - m_deviceOriginNs) + m_intercept + m_slope * m_lastX) / 1e6;
+    estimate.driftPpm = m_slope * 1e6;
+    estimate.uncertaintyMs = m_uncertaintyNs / 1e6;
+    estimate.windows = m_windows;
+    estimate.probes = m_probeCount;
+    return estimate;
+}
+
+// --- Formatting ---
+
+QString ClockEstimate::summary() const
+{
+    if (!valid)
+        return QString("Device clock: no timestamps");
+    const QString drift = QString("Device clock: drift %1 ppm over %2 windows")
+                              .arg(driftPpm, 0, 'f', 1).arg(windows);
+    if (!roundTrip)
+        return drift + " | one-way only, ages exclude the transit floor";
+    return drift + QString(" | offset +/- %1 ms from %2 probes").arg(uncertaintyMs, 0, 'f', 1).arg(probes);
+}
@@ -0,0 +1,92 @@
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+#include <QMetaType>
+#include <QString>
+#include <QtGlobal>
+#include <array>
+
+// Current mapping from the ESP32's clock to this device's steady clock
+struct ClockEstimate {
+    bool valid = false;
+    // Pinned by a round-trip probe; otherwise device times map to the
+    // earliest possible arrival, so ages miss the fastest one-way delay
+    bool roundTrip = false;
+    // Local minus device clock at the latest sample
+    double offsetMs = 0.0;
+    // How much faster the local clock runs, in parts per million
+    double driftPpm = 0.0;
+    // Half the interval the probes and the envelope leave for the offset
+    double uncertaintyMs = 0.0;
+    int windows = 0;
+    int probes = 0;
+
+    QString summary() const;
+};
+Q_DECLARE_METATYPE(ClockEstimate)
+
+// Estimates offset and drift of the ESP32's clock from the timestamps it puts
+// in its notifications, in the spirit of NTP/PTP without a server:
+//
+// - One-way: arrival = device time + offset + drift + transit delay, with the
+//   delay never below some floor. The minimum of (arrival - device time) in
+//   each window lies near the delay floor, so the line under those minima
+//   gives the drift, and the offset up to the (unknown) floor.
+// - Round trip: a probe written to the device and answered with its clock
+//   brackets the device time between send and receive. Intersecting these
+//   brackets with the envelope (no transit is faster than zero) pins the
+//   offset.
+//
+// Not thread-safe; lives with the BLE client.
+class ClockSync
+{
+public:
+    // Windows of the lower envelope, i.e. a 5 minute fit
+    static constexpr int WindowCount = 30;
+    static constexpr qint64 WindowNs = 10LL * 1000000000;
+    // Recent probes that bound the offset
+    static constexpr int ProbeCount = 8;
+
+    void addArrival(qint64 deviceTimeUs, qint64 arrivalNs);
+    void addRoundTrip(qint64 sendNs, qint64 deviceTimeUs, qint64 receiveNs);
+    void reset();
+
+    bool isValid() const { return m_windows > 0; }
+    // Local steady-clock time of a device timestamp, -1 before the first sample
+    qint64 toLocalNs(qint64 deviceTimeUs) const;
+    ClockEstimate estimate() const;
+
+private:
+    // Device time since the first sample, and (arrival - device) relative to
+    // the first sample: y = offset + drift * x + transit delay
+    struct Point {
+        qint64 window = -1;
+        double x = 0.0;
+        double y = 0.0;
+    };
+
+    bool m_started = false;
+    qint64 m_deviceOriginNs = 0;
+    qint64 m_localOriginNs = 0;
+    double m_lastX = 0.0;
+    qint64 m_lastWindow = 0;
+
+    std::array<Point, WindowCount> m_minima = {};
+    int m_windows = 0;
+    std::array<Point, ProbeCount> m_probes = {};
+    std::array<double, ProbeCount> m_probeRttNs = {};
+    int m_probeCount = 0;
+    int m_nextProbe = 0;
+
+    // y = m_intercept + m_slope * x, refitted whenever a minimum or probe changes
+    double m_intercept = 0.0;
+    double m_slope = 0.0;
+    double m_envelopeIntercept = 0.0;
+    double m_uncertaintyNs = 0.0;
+
+    void start(qint64 deviceNs, qint64 localNs);
+    bool isLive(const Point &p) const { return p.window >= 0 && p.window > m_lastWindow - WindowCount; }
+    void refit();
+};
+
+#endif // CLOCKSYNC_H
@@ -0,0 +1,248 @@
+// Round-trip check and throughput of the vitals series codec.
+//
+// Builds a synthetic overnight trace (temperature and heart rate at the
+// sensor rate, with arrival jitter, link dropouts and the odd NaN from a lost
+// sensor contact), encodes each vital in blocks and decodes every block back,
+// comparing timestamps and the exact value bits with the input. Also checks
+// an empty block, every truncation of a few blocks (each must be rejected) and
+// a block that holds more samples than the caller has room for.
+//
+//   codecbench [--hours 12] [--rate 1] [--block 600] [--passes 20] [--seed 1]
+//
+// The ratio is against 12 bytes per raw sample (64-bit timestamp, 32-bit
+// float); MB/s are raw bytes per second through encodeVitalsBlock() and
+// decodeVitalsBlock(). Exits with 2 if any check fails.
+//
+// Runs on the desktop (Linux x86) as well as on the device (adb shell).
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "vitalscodec.h"
+
+namespace {
+
+const size_t RAW_SAMPLE_BYTES = sizeof(int64_t) + sizeof(float);
+// Blocks whose every truncation is decoded
+const size_t TRUNCATED_BLOCKS = 4;
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+struct Trace {
+    std::vector<int64_t> timestampsMs;
+    std::vector<float> temperature;
+    std::vector<float> heartRate;
+    int dropouts = 0;
+};
+
+// Values are rounded as the sensor firmware prints them (0.1 degC, whole bpm)
+Trace simulateTrace(std::mt19937 &random, double hours, int rate)
+{
+    Trace trace;
+    const int64_t intervalMs = 1000 / rate;
+    const size_t samples = size_t(hours * 3600.0 * rate);
+    std::normal_distribution<double> jitterMs(0.0, 4.0);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::uniform_int_distribution<int> dropout(0, 600 * rate);
+    std::uniform_int_distribution<int64_t> gapMs(5000, 120000);
+    std::uniform_int_distribution<int> lostContact(0, 3000 * rate);
+
+    int64_t timestampMs = 1700000000000;
+    for (size_t i = 0; i < samples; ++i) {
+        timestampMs += intervalMs;
+        if (dropout(random) == 0) {
+            timestampMs += gapMs(random);
+            ++trace.dropouts;
+        }
+        const double hoursIn = double(i) / rate / 3600.0;
+        const double temperature = 36.8 + 0.3 * std::sin(hoursIn * 1.5) + 0.03 * noise(random);
+        const double heartRate = 125.0 + 10.0 * std::sin(hoursIn * 4.0) + 3.0 * noise(random);
+        trace.timestampsMs.push_back(timestampMs + int64_t(std::lround(jitterMs(random))));
+        trace.temperature.push_back(float(std::round(temperature * 10.0) / 10.0));
+        trace.heartRate.push_back(lostContact(random) == 0 ? std::numeric_limits<float>::quiet_NaN()
+                                                           : float(std::round(heartRate)));
+    }
+    // Arrival jitter must not reorder the timestamps
+    for (size_t i = 1; i < trace.timestampsMs.size(); ++i)
+        trace.timestampsMs[i] = std::max(trace.timestampsMs[i], trace.timestampsMs[i - 1]);
+    return trace;
+}
+
+bool sameBits(float a, float b)
+{
+    return std::memcmp(&a, &b, sizeof a) == 0;
+}
+
+struct SeriesReport {
+    size_t blocks = 0;
+    size_t encodedBytes = 0;
+    double encodeMBps = 0.0;
+    double decodeMBps = 0.0;
+    QString error;
+};
+
+SeriesReport runSeries(const std::vector<int64_t> &timestampsMs, const std::vector<float> &values,
+                       size_t blockSize, int passes)
+{
+    SeriesReport report;
+    const size_t samples = values.size();
+    std::vector<std::vector<uint8_t>> blocks((samples + blockSize - 1) / blockSize);
+    report.blocks = blocks.size();
+
+    // --- Encode ---
+    QElapsedTimer timer;
+    timer.start();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            const size_t first = b * blockSize;
+            encodeVitalsBlock(&timestampsMs[first], &values[first], std::min(blockSize, samples - first), blocks[b]);
+        }
+    }
+    const double encodeSeconds = timer.nsecsElapsed() / 1e9;
+    for (const std::vector<uint8_t> &block : blocks)
+        report.encodedBytes += block.size();
+
+    // --- Decode ---
+    std::vector<int64_t> decodedMs(blockSize);
+    std::vector<float> decoded(blockSize);
+    timer.start();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const std::vector<uint8_t> &block : blocks)
+            decodeVitalsBlock(block.data(), block.size(), decodedMs.data(), decoded.data(), blockSize);
+    }
+    const double decodeSeconds = timer.nsecsElapsed() / 1e9;
+
+    const double rawMB = double(samples) * RAW_SAMPLE_BYTES * passes / 1e6;
+    report.encodeMBps = encodeSeconds > 0 ? rawMB / encodeSeconds : 0.0;
+    report.decodeMBps = decodeSeconds > 0 ? rawMB / decodeSeconds : 0.0;
+
+    // --- Round Trip ---
+    for (size_t b = 0; b < blocks.size() && report.error.isEmpty(); ++b) {
+        const size_t first = b * blockSize;
+        const size_t n = std::min(blockSize, samples - first);
+        const long decodedCount = decodeVitalsBlock(blocks[b].data(), blocks[b].size(),
+                                                    decodedMs.data(), decoded.data(), blockSize);
+        if (decodedCount != long(n)) {
+            report.error = QString("block %1 decoded %2 of %3 samples").arg(b).arg(decodedCount).arg(n);
+            break;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (decodedMs[i] != timestampsMs[first + i] || !sameBits(decoded[i], values[first + i])) {
+                report.error = QString("block %1 sample %2: %3 ms / %4 instead of %5 ms / %6")
+                                   .arg(b).arg(i).arg(decodedMs[i]).arg(decoded[i])
+                                   .arg(timestampsMs[first + i]).arg(values[first + i]);
+                break;
+            }
+        }
+    }
+
+    // --- Truncated Blocks ---
+    // Every prefix of a block lacks bits of at least one sample
+    for (size_t b = 0; b < std::min(TRUNCATED_BLOCKS, blocks.size()) && report.error.isEmpty(); ++b) {
+        for (size_t length = 0; length < blocks[b].size(); ++length) {
+            // An exactly sized copy, so that a sanitizer build catches over-reads
+            const std::vector<uint8_t> truncated(blocks[b].begin(), blocks[b].begin() + long(length));
+            if (decodeVitalsBlock(truncated.data(), truncated.size(), decodedMs.data(), decoded.data(),
+                                  blockSize) >= 0) {
+                report.error = QString("block %1 truncated to %2 of %3 bytes was accepted")
+                                   .arg(b).arg(length).arg(blocks[b].size());
+                break;
+            }
+        }
+    }
+
+    // --- Capacity ---
+    if (report.error.isEmpty() && !blocks.empty()) {
+        const size_t n = std::min(blockSize, samples);
+        if (n > 0 && decodeVitalsBlock(blocks[0].data(), blocks[0].size(), decodedMs.data(), decoded.data(), n - 1) >= 0)
+            report.error = QString("block 0 (%1 samples) decoded into room for %2").arg(n).arg(n - 1);
+    }
+    return report;
+}
+
+bool checkEmptyBlock(QString &error)
+{
+    std::vector<uint8_t> block;
+    encodeVitalsBlock(nullptr, nullptr, 0, block);
+    int64_t timestampMs = 0;
+    float value = 0.0f;
+    const long n = decodeVitalsBlock(block.data(), block.size(), &timestampMs, &value, 1);
+    if (n != 0) {
+        error = QString("empty block (%1 bytes) decoded as %2").arg(block.size()).arg(n);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("codecbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Round-trip check and throughput of the vitals series codec.");
+    parser.addHelpOption();
+    QCommandLineOption hoursOption("hours", "Length of the simulated trace.", "hours", "12");
+    QCommandLineOption rateOption({"r", "rate"}, "Samples per second.", "hz", "1");
+    QCommandLineOption blockOption({"b", "block"}, "Samples per block.", "count", "600");
+    QCommandLineOption passesOption({"n", "passes"}, "Timed passes over the trace.", "count", "20");
+    QCommandLineOption seedOption("seed", "Random seed of the trace.", "seed", "1");
+    parser.addOptions({hoursOption, rateOption, blockOption, passesOption, seedOption});
+    parser.process(app);
+
+    const double hours = qBound(0.01, parser.value(hoursOption).toDouble(), 24.0 * 30);
+    const int rate = qBound(1, parser.value(rateOption).toInt(), 1000);
+    const size_t blockSize = size_t(qMax(1, parser.value(blockOption).toInt()));
+    const int passes = qMax(1, parser.value(passesOption).toInt());
+
+    std::mt19937 random(parser.value(seedOption).toUInt());
+    const Trace trace = simulateTrace(random, hours, rate);
+    out() << "Trace: " << trace.timestampsMs.size() << " samples per vital over " << hours << " h at " << rate
+          << " Hz, " << trace.dropouts << " dropouts, blocks of " << blockSize << Qt::endl;
+
+    bool ok = true;
+    QString error;
+    if (!checkEmptyBlock(error)) {
+        err() << "ERROR: " << error << Qt::endl;
+        ok = false;
+    }
+
+    for (const auto &[name, values] : {std::make_pair("temperature", &trace.temperature),
+                                       std::make_pair("heart rate", &trace.heartRate)}) {
+        const SeriesReport report = runSeries(trace.timestampsMs, *values, blockSize, passes);
+        const double bytesPerSample = values->empty() ? 0.0 : double(report.encodedBytes) / values->size();
+        out() << "  " << name << ": " << report.blocks << " blocks, "
+              << QString::number(bytesPerSample, 'f', 2) << " bytes/sample, ratio "
+              << QString::number(bytesPerSample > 0 ? RAW_SAMPLE_BYTES / bytesPerSample : 0.0, 'f', 1)
+              << ", encode " << QString::number(report.encodeMBps, 'f', 0)
+              << " MB/s, decode " << QString::number(report.decodeMBps, 'f', 0) << " MB/s" << Qt::endl;
+        if (!report.error.isEmpty()) {
+            err() << "ERROR: " << name << ": " << report.error << Qt::endl;
+            ok = false;
+        }
+    }
+    out() << (ok ? "Round trip bit-exact; empty, truncated and oversized blocks handled"
+                 : "Round trip FAILED") << Qt::endl;
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,81 @@
+#include "dashboardcontroller.h"
+
+DashboardController::DashboardController(BleClient *client, MonitorController *monitor, QObject *parent)
+    : QObject(parent), m_bleClient(client), m_monitor(monitor)
+{
+    // Connections from BleClient signals to the dashboard state
+    connect(m_bleClient, &BleClient::statusChanged, this, &DashboardController::updateStatus);
+    connect(m_bleClient, &BleClient::sampleReceived, this, &DashboardController::updateSample);
+    connect(m_bleClient, &BleClient::scanningChanged, this, &DashboardController::updateScanning);
+
+    // Predictions, the at-risk state and alerts come from the shared monitor
+    connect(m_monitor, &MonitorController::riskStateChanged, this, &DashboardController::riskChanged);
+    connect(m_monitor, &MonitorController::predictionMade, this, &DashboardController::predictionChanged);
+    connect(m_monitor, &MonitorController::notificationChanged, this, &DashboardController::notificationChanged);
+
+    // Set initial state (the client lives on the BLE thread)
+    QMetaObject::invokeMethod(m_bleClient, &BleClient::publishState, Qt::QueuedConnection);
+}
+
+QString DashboardController::riskState() const
+{
+    switch (m_monitor->riskState()) {
+    case MonitorController::RiskState::Normal:
+        return QStringLiteral("normal");
+    case MonitorController::RiskState::AtRisk:
+        return QStringLiteral("atRisk");
+    case MonitorController::RiskState::Failed:
+        return QStringLiteral("failed");
+    case MonitorController::RiskState::Unknown:
+        break;
+    }
+    return QStringLiteral("unknown");
+}
+
+bool DashboardController::isConnected() const
+{
+    return m_status.startsWith("Subscribed") || m_status.startsWith("Connected");
+}
+
+// --- Public Slots (called from QML) ---
+
+void DashboardController::startScan()
+{
+    QMetaObject::invokeMethod(m_bleClient, &BleClient::startScan, Qt::QueuedConnection);
+}
+
+void DashboardController::disconnectDevice()
+{
+    QMetaObject::invokeMethod(m_bleClient, &BleClient::disconnectDevice, Qt::QueuedConnection);
+}
+
+void DashboardController::predictNow()
+{
+    m_monitor->predictNow();
+}
+
+// --- BleClient Slots ---
+
+void DashboardController::updateStatus(const QString &newStatus)
+{
+    if (m_status == newStatus)
+        return;
+    m_status = newStatus;
+    emit statusChanged();
+}
+
+void DashboardController::updateSample(const VitalsSample &sample)
+{
+    m_temperature = sample.temperature_c;
+    m_heartRate = sample.heart_rate_bpm;
+    emit vitalsChanged();
+    emit sampleReceived(m_temperature, m_heartRate);
+}
+
+void DashboardController::updateScanning(bool scanning)
+{
+    if (m_scanning == scanning)
+        return;
+    m_scanning = scanning;
+    emit scanningChanged();
+}
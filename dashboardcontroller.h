@@ -0,0 +1,80 @@
+#ifndef DASHBOARDCONTROLLER_H
+#define DASHBOARDCONTROLLER_H
+
+#include <QObject>
+#include <QQmlEngine>
+#include <QString>
+
+#include "bleclient.h"
+#include "monitorcontroller.h"
+
+// GUI-side state for the Qt Quick dashboard (Main.qml).
+// It plays the same role as GuiWindow does for the widget UI: it listens to
+// the BleClient and the MonitorController and exposes the latest vitals, the
+// at-risk state and the current notification as plain properties.
+class DashboardController : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("Created in main.cpp and handed to Main.qml")
+
+    Q_PROPERTY(QString status READ status NOTIFY statusChanged FINAL)
+    Q_PROPERTY(bool connected READ isConnected NOTIFY statusChanged FINAL)
+    Q_PROPERTY(bool scanning READ isScanning NOTIFY scanningChanged FINAL)
+    Q_PROPERTY(double temperature READ temperature NOTIFY vitalsChanged FINAL)
+    Q_PROPERTY(double heartRate READ heartRate NOTIFY vitalsChanged FINAL)
+    // "unknown", "normal", "atRisk" or "failed"
+    Q_PROPERTY(QString riskState READ riskState NOTIFY riskChanged FINAL)
+    Q_PROPERTY(bool atRisk READ isAtRisk NOTIFY riskChanged FINAL)
+    // Smoothed at-risk probability and the label of the last prediction
+    Q_PROPERTY(double riskProbability READ riskProbability NOTIFY predictionChanged FINAL)
+    Q_PROPERTY(int label READ label NOTIFY predictionChanged FINAL)
+    Q_PROPERTY(QString predictionError READ predictionError NOTIFY riskChanged FINAL)
+    Q_PROPERTY(QString notification READ notification NOTIFY notificationChanged FINAL)
+
+public:
+    DashboardController(BleClient *client, MonitorController *monitor, QObject *parent = nullptr);
+
+    QString status() const { return m_status; }
+    bool isConnected() const;
+    bool isScanning() const { return m_scanning; }
+    double temperature() const { return m_temperature; }
+    double heartRate() const { return m_heartRate; }
+    QString riskState() const;
+    bool isAtRisk() const { return m_monitor->riskState() == MonitorController::RiskState::AtRisk; }
+    double riskProbability() const { return m_monitor->smoothedRisk(); }
+    int label() const { return int(m_monitor->lastPrediction().label); }
+    QString predictionError() const { return m_monitor->lastPrediction().error; }
+    QString notification() const { return m_monitor->notification(); }
+
+public slots:
+    void startScan();
+    void disconnectDevice();
+    void predictNow();
+
+signals:
+    void statusChanged();
+    void scanningChanged();
+    void vitalsChanged();
+    void riskChanged();
+    void predictionChanged();
+    void notificationChanged();
+    // Emitted once per valid BLE sample; the waveforms append on this
+    void sampleReceived(double temperature, double heartRate);
+
+private slots:
+    void updateStatus(const QString &newStatus);
+    void updateSample(const VitalsSample &sample);
+    void updateScanning(bool scanning);
+
+private:
+    BleClient *m_bleClient;
+    MonitorController *m_monitor;
+
+    QString m_status;
+    bool m_scanning = false;
+    double m_temperature = 0.0;
+    double m_heartRate = 0.0;
+};
+
+#endif // DASHBOARDCONTROLLER_H
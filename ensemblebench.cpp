@@ -0,0 +1,229 @@
+// Latency of the multi-model risk ensemble as the number of models grows.
+//
+// Streams a recorded dataset through ensembles of 1, 2, ... up to --max
+// models, each time once with the members scored one after another and once
+// side by side on the runner's worker pool, and reports the per-model and
+// total latency of both:
+//
+//   ensemblebench --dataset night.csv health_classifier.onnx fever.onnx bradycardia.onnx tachycardia.onnx
+//   ensemblebench --dataset night.csv --max 8 --policy any health_classifier.onnx
+//
+// With fewer models than --max, the list is repeated: every member still gets
+// its own session, which is what the latency depends on. Both variants must
+// agree on every combined label.
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "ensemblerunner.h"
+#include "healthpredictor.h"
+#include "inferencememory.h"
+#include "vitalsdataset.h"
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+struct EnsembleRun {
+    int workers = 0;
+    // Per prediction, whole ensemble
+    std::vector<qint64> totalNs;
+    // Per member, per prediction
+    std::vector<std::vector<qint64>> memberNs;
+    std::vector<int64_t> labels;
+    QString error;
+};
+
+double percentileUs(std::vector<qint64> sorted, double q)
+{
+    if (sorted.empty())
+        return 0.0;
+    std::sort(sorted.begin(), sorted.end());
+    // Nearest-rank percentile
+    const size_t rank = size_t(std::ceil(q * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)] / 1000.0;
+}
+
+// Scores every row `repeat` times in the app's pattern: inputs bound once per
+// profile, vitals rewritten per row, all members reading the same tensors
+EnsembleRun runEnsemble(Ort::Env &env, const MemoryBudget &budget, const EnsembleSpec &spec, int workers,
+                        const std::vector<BabyData> &rows, int repeat, int warmup)
+{
+    EnsembleRun run;
+    try {
+        EnsembleRunner runner(env, budget, spec, workers);
+        run.workers = runner.workers();
+        HealthInputs inputs;
+        EnsembleResult result;
+
+        inputs.setProfile(rows.front());
+        for (int i = 0; i < warmup; ++i)
+            runner.predict(inputs, result);
+
+        run.totalNs.reserve(rows.size() * repeat);
+        run.memberNs.assign(runner.size(), std::vector<qint64>());
+        for (std::vector<qint64> &latencies : run.memberNs)
+            latencies.reserve(rows.size() * repeat);
+        run.labels.reserve(rows.size());
+
+        const BabyData *boundProfile = nullptr;
+        for (int pass = 0; pass < repeat; ++pass) {
+            for (const BabyData &row : rows) {
+                if (!boundProfile || !vitalsdataset::sameProfile(*boundProfile, row))
+                    inputs.setProfile(row);
+                else
+                    inputs.setVitals(row.temperature_c, row.heart_rate_bpm);
+                boundProfile = &row;
+
+                runner.predict(inputs, result);
+                run.totalNs.push_back(result.totalNs);
+                for (size_t m = 0; m < result.members.size(); ++m)
+                    run.memberNs[m].push_back(result.members[m].latencyNs);
+                if (pass == 0)
+                    run.labels.push_back(result.label);
+            }
+        }
+    } catch (const Ort::Exception &e) {
+        run.error = QString("ONNX Runtime Error: %1").arg(e.what());
+    }
+    return run;
+}
+
+// Mean over the members of each member's median latency
+double memberP50Us(const EnsembleRun &run)
+{
+    if (run.memberNs.empty())
+        return 0.0;
+    double sum = 0.0;
+    for (const std::vector<qint64> &latencies : run.memberNs)
+        sum += percentileUs(latencies, 0.50);
+    return sum / run.memberNs.size();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ensemblebench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Reports per-model and total latency of the risk ensemble as models are added.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("models", "Ensemble .onnx models, repeated up to --max.", "model.onnx...");
+    QCommandLineOption datasetOption({"d", "dataset"}, "CSV (with header) or VTLS binary dataset.", "file");
+    QCommandLineOption maxOption("max", "Largest ensemble (default: number of models given).", "count");
+    QCommandLineOption policyOption("policy", "Combination policy: mean, majority or any.", "policy", "mean");
+    QCommandLineOption workersOption("workers", "Worker threads of the parallel variant (default: one per extra model, up to the cores).", "count");
+    QCommandLineOption repeatOption({"n", "repeat"}, "Passes over the dataset.", "count", "1");
+    QCommandLineOption warmupOption({"w", "warmup"}, "Untimed warm-up predictions per ensemble.", "count", "10");
+    QCommandLineOption arenaOption("arena", "Memory budget: default, limited[:MB] or off.", "spec", "default");
+    parser.addOptions({datasetOption, maxOption, policyOption, workersOption, repeatOption, warmupOption, arenaOption});
+    parser.process(app);
+
+    const QStringList models = parser.positionalArguments();
+    if (models.isEmpty() || !parser.isSet(datasetOption))
+        parser.showHelp(1);
+
+    EnsembleSpec base;
+    if (!EnsembleSpec::parse(parser.value(policyOption) + ':' + models.join(','), base)) {
+        err() << "ERROR: invalid --policy " << parser.value(policyOption) << " or model list" << Qt::endl;
+        return 1;
+    }
+    const int maxModels = parser.isSet(maxOption) ? qMax(1, parser.value(maxOption).toInt()) : int(models.size());
+    const int workers = parser.isSet(workersOption) ? qMax(0, parser.value(workersOption).toInt()) : -1;
+    const int repeat = qMax(1, parser.value(repeatOption).toInt());
+    const int warmup = qMax(0, parser.value(warmupOption).toInt());
+
+    // --- Load the Dataset ---
+    std::vector<BabyData> rows;
+    QString error;
+    if (!vitalsdataset::load(parser.value(datasetOption), rows, error)) {
+        err() << "ERROR: " << error << Qt::endl;
+        return 1;
+    }
+    if (rows.empty()) {
+        err() << "ERROR: " << parser.value(datasetOption) << " has no rows" << Qt::endl;
+        return 1;
+    }
+
+    MemoryBudget budget;
+    if (!MemoryBudget::parse(parser.value(arenaOption), budget)) {
+        err() << "ERROR: invalid --arena " << parser.value(arenaOption) << Qt::endl;
+        return 1;
+    }
+    Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "EnsembleBench");
+    budget.registerSharedAllocator(env);
+
+    out() << "Dataset: " << parser.value(datasetOption) << " (" << rows.size() << " rows x " << repeat
+          << "), policy " << EnsembleSpec::policyName(base.policy) << ", cores: " << QThread::idealThreadCount()
+          << Qt::endl;
+
+    // --- Grow the Ensemble ---
+    // Latencies in microseconds; "per model" is the mean of the members' medians
+    out() << Qt::left << qSetFieldWidth(8) << "models" << "workers"
+          << qSetFieldWidth(16) << "serial p50" << "serial/model" << "parallel p50" << "parallel p99"
+          << "parallel/model" << "speedup" << qSetFieldWidth(0) << Qt::endl;
+    for (int n = 1; n <= maxModels; ++n) {
+        EnsembleSpec spec;
+        spec.policy = base.policy;
+        for (int m = 0; m < n; ++m)
+            spec.members.push_back(base.members[size_t(m) % base.members.size()]);
+
+        const EnsembleRun serial = runEnsemble(env, budget, spec, 0, rows, repeat, warmup);
+        const EnsembleRun parallel = runEnsemble(env, budget, spec, workers, rows, repeat, warmup);
+        for (const EnsembleRun *run : {&serial, &parallel}) {
+            if (!run->error.isEmpty()) {
+                err() << "ERROR: " << run->error << Qt::endl;
+                return 1;
+            }
+        }
+        if (serial.labels != parallel.labels) {
+            err() << "ERROR: " << n << " models: parallel and serial scoring disagree on a combined label" << Qt::endl;
+            return 2;
+        }
+
+        const double serialP50 = percentileUs(serial.totalNs, 0.50);
+        const double parallelP50 = percentileUs(parallel.totalNs, 0.50);
+        out() << qSetFieldWidth(8) << QString::number(n) << QString::number(parallel.workers)
+              << qSetFieldWidth(16) << QString::number(serialP50, 'f', 1)
+              << QString::number(memberP50Us(serial), 'f', 1)
+              << QString::number(parallelP50, 'f', 1)
+              << QString::number(percentileUs(parallel.totalNs, 0.99), 'f', 1)
+              << QString::number(memberP50Us(parallel), 'f', 1)
+              << QString::number(parallelP50 > 0 ? serialP50 / parallelP50 : 0.0, 'f', 2)
+              << qSetFieldWidth(0) << Qt::endl;
+
+        // Per-model detail of the largest ensemble: members slower in
+        // parallel than serially are competing for cores or memory bandwidth
+        if (n == maxModels) {
+            out() << "Largest ensemble, per model (us):" << Qt::endl;
+            for (int m = 0; m < n; ++m) {
+                out() << "  " << m << " " << QFileInfo(spec.members[size_t(m)].path).fileName()
+                      << ": serial p50 " << QString::number(percentileUs(serial.memberNs[size_t(m)], 0.50), 'f', 1)
+                      << ", parallel p50 " << QString::number(percentileUs(parallel.memberNs[size_t(m)], 0.50), 'f', 1)
+                      << " p99 " << QString::number(percentileUs(parallel.memberNs[size_t(m)], 0.99), 'f', 1)
+                      << Qt::endl;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,248 @@
+#include "ensemblerunner.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+
+namespace {
+
+const QChar POLICY_SEPARATOR = ':';
+const QChar MEMBER_SEPARATOR = ',';
+const QChar WEIGHT_SEPARATOR = '=';
+
+} // namespace
+
+// --- EnsembleSpec ---
+
+bool EnsembleSpec::parse(const QString &spec, EnsembleSpec &ensemble)
+{
+    const int colon = spec.indexOf(POLICY_SEPARATOR);
+    if (colon < 0)
+        return false;
+
+    EnsembleSpec parsed;
+    const QString policy = spec.left(colon).trimmed().toLower();
+    if (policy == "mean")
+        parsed.policy = Policy::Mean;
+    else if (policy == "majority")
+        parsed.policy = Policy::Majority;
+    else if (policy == "any")
+        parsed.policy = Policy::Any;
+    else
+        return false;
+
+    for (const QString &entry : spec.mid(colon + 1).split(MEMBER_SEPARATOR, Qt::SkipEmptyParts)) {
+        Member member;
+        member.path = entry.section(WEIGHT_SEPARATOR, 0, 0).trimmed();
+        const QString weight = entry.section(WEIGHT_SEPARATOR, 1, 1).trimmed();
+        if (!weight.isEmpty()) {
+            bool ok = false;
+            member.weight = weight.toFloat(&ok);
+            if (!ok || !(member.weight > 0.0f))
+                return false;
+        }
+        if (member.path.isEmpty())
+            return false;
+        parsed.members.push_back(member);
+    }
+    if (parsed.members.empty())
+        return false;
+    ensemble = parsed;
+    return true;
+}
+
+bool EnsembleSpec::fromArguments(const QStringList &arguments, EnsembleSpec &ensemble)
+{
+    const int index = arguments.indexOf("--ensemble");
+    return index >= 0 && parse(arguments.value(index + 1), ensemble);
+}
+
+QString EnsembleSpec::policyName(Policy policy)
+{
+    switch (policy) {
+    case Policy::Mean: return "mean";
+    case Policy::Majority: return "majority";
+    case Policy::Any: return "any";
+    }
+    return QString();
+}
+
+QString EnsembleSpec::toString() const
+{
+    QStringList entries;
+    for (const Member &member : members) {
+        entries << (member.weight == 1.0f ? member.path
+                                          : QString("%1=%2").arg(member.path).arg(member.weight));
+    }
+    return policyName(policy) + POLICY_SEPARATOR + entries.join(MEMBER_SEPARATOR);
+}
+
+// --- EnsembleRunner ---
+
+EnsembleRunner::EnsembleRunner(Ort::Env &env, const MemoryBudget &budget, const EnsembleSpec &spec, int workers)
+    : m_spec(spec)
+{
+    if (m_spec.members.empty())
+        throw Ort::Exception("Ensemble has no models", ORT_INVALID_ARGUMENT);
+
+    // Parallelism comes from running the members side by side, so each
+    // session keeps a single intra-op thread
+    m_members.resize(m_spec.members.size());
+    for (size_t i = 0; i < m_members.size(); ++i) {
+        m_members[i].predictor = std::make_unique<HealthPredictor>(env, m_spec.members[i].path.toStdString(),
+                                                                   budget.sessionOptions(1));
+        m_members[i].predictor->validateSignature();
+    }
+
+    const int others = int(m_members.size()) - 1;
+    m_workers = (workers < 0) ? qMin(others, qMax(0, QThread::idealThreadCount() - 1)) : qMin(workers, others);
+    if (m_workers > 0) {
+        m_pool.setMaxThreadCount(m_workers);
+        // Keep the workers alive between predictions instead of respawning them
+        m_pool.setExpiryTimeout(-1);
+    }
+}
+
+EnsembleRunner::~EnsembleRunner()
+{
+    m_pool.waitForDone();
+}
+
+void EnsembleRunner::predict(const HealthInputs &inputs, EnsembleResult &result)
+{
+    QMutexLocker locker(&m_predictMutex);
+
+    QElapsedTimer timer;
+    timer.start();
+    result.members.resize(m_members.size());
+    for (Member &member : m_members)
+        member.error.clear();
+
+    if (m_workers == 0) {
+        for (size_t i = 0; i < m_members.size(); ++i)
+            runMember(i, inputs, result.members[i]);
+    } else {
+        // The inputs and each member's result slot outlive the tasks: we wait
+        // for all of them below
+        for (size_t i = 1; i < m_members.size(); ++i) {
+            EnsembleMemberResult *slot = &result.members[i];
+            m_pool.start([this, i, &inputs, slot]() {
+                runMember(i, inputs, *slot);
+                m_done.release();
+            });
+        }
+        runMember(0, inputs, result.members[0]);
+        m_done.acquire(int(m_members.size()) - 1);
+    }
+
+    for (size_t i = 0; i < m_members.size(); ++i) {
+        if (!m_members[i].error.empty())
+            throw Ort::Exception(QString("Ensemble model %1 (%2) failed: %3")
+                                     .arg(i).arg(m_spec.members[i].path).arg(m_members[i].error.c_str())
+                                     .toStdString(), ORT_FAIL);
+    }
+    combine(m_spec, result);
+    result.totalNs = timer.nsecsElapsed();
+}
+
+int64_t EnsembleRunner::predict(const HealthInputs &inputs, std::vector<float> *probabilities)
+{
+    EnsembleResult result;
+    predict(inputs, result);
+    if (probabilities)
+        *probabilities = std::move(result.probabilities);
+    return result.label;
+}
+
+void EnsembleRunner::runMember(size_t index, const HealthInputs &inputs, EnsembleMemberResult &result)
+{
+    // Runs on the calling thread or a worker; must not throw across the pool
+    QElapsedTimer timer;
+    timer.start();
+    try {
+        result.label = m_members[index].predictor->predict(inputs, &result.probabilities);
+    } catch (const std::exception &e) {
+        m_members[index].error = e.what();
+        result.label = -1;
+    }
+    result.latencyNs = timer.nsecsElapsed();
+}
+
+void EnsembleRunner::combine(const EnsembleSpec &spec, EnsembleResult &result)
+{
+    if (result.members.size() != spec.members.size() || result.members.empty())
+        throw Ort::Exception(QString("Ensemble has %1 results for %2 models")
+                                 .arg(result.members.size()).arg(spec.members.size()).toStdString(), ORT_FAIL);
+    const size_t classes = result.members[0].probabilities.size();
+    for (size_t i = 0; i < result.members.size(); ++i) {
+        const EnsembleMemberResult &member = result.members[i];
+        if (member.probabilities.size() != classes || classes == 0)
+            throw Ort::Exception(QString("Ensemble model %1 returned %2 classes, expected %3")
+                                     .arg(i).arg(member.probabilities.size()).arg(classes).toStdString(), ORT_FAIL);
+        if (member.label < 0 || member.label >= int64_t(classes))
+            throw Ort::Exception(QString("Ensemble model %1 returned label %2 for %3 classes")
+                                     .arg(i).arg(member.label).arg(classes).toStdString(), ORT_FAIL);
+    }
+
+    result.probabilities.assign(classes, 0.0f);
+    switch (spec.policy) {
+    case EnsembleSpec::Policy::Any: {
+        // The most severe label wins. For the probabilities, P(class >= k) is
+        // the largest any member gives, so 1 - p[0] is the highest risk of any
+        // member rather than the whole vector of one of them
+        int64_t label = 0;
+        for (const EnsembleMemberResult &member : result.members)
+            label = qMax(label, member.label);
+
+        float above = 0.0f;  // P(class > k)
+        for (size_t k = classes - 1; k > 0; --k) {
+            float atLeast = above;
+            for (const EnsembleMemberResult &member : result.members) {
+                float tail = 0.0f;
+                for (size_t j = k; j < classes; ++j)
+                    tail += member.probabilities[j];
+                atLeast = qMax(atLeast, tail);
+            }
+            atLeast = qMin(atLeast, 1.0f);
+            result.probabilities[k] = atLeast - above;
+            above = atLeast;
+        }
+        result.probabilities[0] = 1.0f - above;
+        result.label = label;
+        return;
+    }
+    case EnsembleSpec::Policy::Majority: {
+        // Vote shares, so the probabilities say how much of the ensemble agrees
+        float totalWeight = 0.0f;
+        for (size_t i = 0; i < result.members.size(); ++i) {
+            result.probabilities[size_t(result.members[i].label)] += spec.members[i].weight;
+            totalWeight += spec.members[i].weight;
+        }
+        for (float &p : result.probabilities)
+            p /= totalWeight;
+        break;
+    }
+    case EnsembleSpec::Policy::Mean: {
+        float totalWeight = 0.0f;
+        for (size_t i = 0; i < result.members.size(); ++i) {
+            const float weight = spec.members[i].weight;
+            for (size_t k = 0; k < classes; ++k)
+                result.probabilities[k] += weight * result.members[i].probabilities[k];
+            totalWeight += weight;
+        }
+        for (float &p : result.probabilities)
+            p /= totalWeight;
+        break;
+    }
+    }
+
+    // Ties go to the more severe class
+    int64_t label = 0;
+    float bestScore = -1.0f;
+    for (size_t k = 0; k < classes; ++k) {
+        if (result.probabilities[k] >= bestScore) {
+            bestScore = result.probabilities[k];
+            label = int64_t(k);
+        }
+    }
+    result.label = label;
+}
@@ -0,0 +1,114 @@
+#ifndef ENSEMBLERUNNER_H
+#define ENSEMBLERUNNER_H
+
+#include <QMutex>
+#include <QSemaphore>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "healthpredictor.h"
+#include "inferencememory.h"
+
+// Which models run and how their outputs become one prediction.
+//
+// Every member has the classifier's signature (see HealthPredictor), with
+// class 0 meaning "normal" and higher classes more severe.
+struct EnsembleSpec {
+    // The combined probabilities follow the policy, so that consumers of the
+    // probabilities (the at-risk smoother) see the same decision as the label
+    enum class Policy {
+        Mean,      // weighted mean of the probabilities, then argmax
+        Majority,  // weighted vote over the labels, ties to the more severe;
+                   // probabilities are the vote shares
+        Any        // the most severe label any member predicts; P(class >= k)
+                   // is the highest any member gives
+    };
+
+    struct Member {
+        QString path;
+        float weight = 1.0f;
+    };
+
+    Policy policy = Policy::Mean;
+    std::vector<Member> members;
+
+    // "<policy>:<model>[=weight],<model>[=weight],..." with policy "mean",
+    // "majority" or "any"; returns false for anything else
+    static bool parse(const QString &spec, EnsembleSpec &ensemble);
+    // From "--ensemble <spec>" in `arguments`; false if absent or invalid
+    static bool fromArguments(const QStringList &arguments, EnsembleSpec &ensemble);
+    static QString policyName(Policy policy);
+    QString toString() const;
+};
+
+struct EnsembleMemberResult {
+    int64_t label = -1;
+    std::vector<float> probabilities;
+    qint64 latencyNs = 0;
+};
+
+struct EnsembleResult {
+    int64_t label = -1;
+    std::vector<float> probabilities;
+    // In member order
+    std::vector<EnsembleMemberResult> members;
+    // Wall time of the whole ensemble, members and combination
+    qint64 totalNs = 0;
+};
+
+// Scores one HealthInputs with every member of an ensemble.
+//
+// The inputs are bound once and shared read-only by all sessions; each
+// session has one intra-op thread and the members run side by side on a
+// small pool of long-lived workers, with the calling thread taking the first
+// member itself. Throws Ort::Exception if a model does not load or validate,
+// or if any member fails a prediction.
+class EnsembleRunner
+{
+public:
+    // `workers` extra threads; 0 scores the members one after another on the
+    // calling thread, -1 picks one per member beyond the first (bounded by
+    // the core count)
+    EnsembleRunner(Ort::Env &env, const MemoryBudget &budget, const EnsembleSpec &spec, int workers = -1);
+    ~EnsembleRunner();
+    EnsembleRunner(const EnsembleRunner &) = delete;
+    EnsembleRunner &operator=(const EnsembleRunner &) = delete;
+
+    const EnsembleSpec &spec() const { return m_spec; }
+    size_t size() const { return m_members.size(); }
+    int workers() const { return m_workers; }
+
+    // Thread-safe; concurrent callers take turns
+    void predict(const HealthInputs &inputs, EnsembleResult &result);
+    int64_t predict(const HealthInputs &inputs, std::vector<float> *probabilities = nullptr);
+
+    // Member memory for the app's statistics
+    const Ort::Session &session(size_t member) const { return m_members[member].predictor->session(); }
+
+    // Fills result.label and result.probabilities from result.members
+    // according to the policy of `spec`; throws Ort::Exception if the members
+    // disagree on the number of classes or return an out-of-range label
+    static void combine(const EnsembleSpec &spec, EnsembleResult &result);
+
+private:
+    struct Member {
+        std::unique_ptr<HealthPredictor> predictor;
+        std::string error;
+    };
+
+    EnsembleSpec m_spec;
+    std::vector<Member> m_members;
+    int m_workers = 0;
+
+    QMutex m_predictMutex;
+    QThreadPool m_pool;
+    QSemaphore m_done;
+
+    void runMember(size_t index, const HealthInputs &inputs, EnsembleMemberResult &result);
+};
+
+#endif // ENSEMBLERUNNER_H
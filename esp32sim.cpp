@@ -0,0 +1,278 @@
+// Simulated ESP32 vitals peripheral, and an offline check of the device clock
+// estimator.
+//
+//   esp32sim [--rate 2] [--drift-ppm 30] [--jitter-ms 5]
+//
+// Advertises the vitals service through BlueZ (Linux; run the app on another
+// machine or adapter) and behaves like a current sketch: notifications carry
+// "temp,hr,deviceUs" from a clock that runs --drift-ppm slow against this
+// host's and started at a random offset, and the clock probe characteristic
+// answers every probe id with "<id>,<deviceUs>". Each reading is sent up to
+// --jitter-ms after it was stamped, like the ESP8266 -> ESP32 relay does.
+//
+//   esp32sim --offline [--minutes 10] [--seed 1] [--interval-ms 30] ...
+//
+// Runs ClockSync on simulated arrivals and probes, once from the sample
+// timestamps alone and once with probes, and compares every mapped sensor
+// time with the true one. Exits 2 if the drift or the probe-pinned ages are
+// off by more than the estimator claims.
+
+#include <QBluetoothUuid>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QLowEnergyAdvertisingData>
+#include <QLowEnergyAdvertisingParameters>
+#include <QLowEnergyCharacteristicData>
+#include <QLowEnergyController>
+#include <QLowEnergyDescriptorData>
+#include <QLowEnergyService>
+#include <QLowEnergyServiceData>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QTimer>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "bleclient.h"
+#include "clocksync.h"
+#include "vitalssample.h"
+
+namespace {
+
+const qint64 NS_PER_MS = 1000000;
+const double TWO_PI = 6.283185307179586;
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+// --- Offline estimator check ---
+
+struct OfflineResult {
+    ClockEstimate estimate;
+    double meanErrorMs = 0.0;
+    double p99AbsErrorMs = 0.0;
+    // Mapped sensor times further off than the estimator's own bound
+    double outsideBoundFraction = 0.0;
+};
+
+OfflineResult simulateSync(bool withProbes, int minutes, quint32 seed, double rateHz, double driftPpm,
+                           double intervalMs)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> inInterval(0.0, intervalMs);
+    std::exponential_distribution<double> radioRetry(1.0 / 2.0);
+    // One BLE hop: a fixed floor, waiting for the next connection event, and
+    // occasional retransmissions
+    auto linkDelayNs = [&]() { return qint64((3.0 + inInterval(rng) + radioRetry(rng)) * NS_PER_MS); };
+
+    // Local = device * (1 + drift); the device booted long before the host clock's origin
+    const qint64 deviceOffsetNs = 123456789LL * 1000;
+    auto deviceUsAt = [&](qint64 localNs) {
+        return (deviceOffsetNs + qint64(double(localNs) / (1.0 + driftPpm * 1e-6))) / 1000;
+    };
+
+    ClockSync sync;
+    std::vector<double> errorsMs;
+    quint64 outsideBound = 0;
+    const qint64 samplePeriodNs = qint64(1e9 / rateHz);
+    const qint64 probePeriodNs = 10LL * 1000000000;
+    const qint64 endNs = qint64(minutes) * 60 * 1000000000;
+    // Leave the fit a minute to find the drift before judging it
+    const qint64 warmupNs = 60LL * 1000000000;
+    qint64 nextProbeNs = probePeriodNs / 2;
+
+    for (qint64 sensorNs = samplePeriodNs; sensorNs < endNs; sensorNs += samplePeriodNs) {
+        if (withProbes && sensorNs >= nextProbeNs) {
+            const qint64 sendNs = nextProbeNs;
+            const qint64 deviceReadNs = sendNs + linkDelayNs();
+            sync.addRoundTrip(sendNs, deviceUsAt(deviceReadNs), deviceReadNs + linkDelayNs());
+            nextProbeNs += probePeriodNs;
+        }
+
+        const qint64 deviceTimeUs = deviceUsAt(sensorNs);
+        sync.addArrival(deviceTimeUs, sensorNs + linkDelayNs());
+        if (sensorNs < warmupNs)
+            continue;
+        const double errorMs = double(sync.toLocalNs(deviceTimeUs) - sensorNs) / NS_PER_MS;
+        errorsMs.push_back(errorMs);
+        // The device-side timestamp is truncated to a microsecond
+        const ClockEstimate estimate = sync.estimate();
+        if (estimate.roundTrip && std::abs(errorMs) > estimate.uncertaintyMs + 0.01)
+            ++outsideBound;
+    }
+
+    OfflineResult result;
+    result.estimate = sync.estimate();
+    if (errorsMs.empty())
+        return result;
+    double sum = 0.0;
+    std::vector<double> absErrors;
+    for (double e : errorsMs) {
+        sum += e;
+        absErrors.push_back(std::abs(e));
+    }
+    std::sort(absErrors.begin(), absErrors.end());
+    result.meanErrorMs = sum / errorsMs.size();
+    result.p99AbsErrorMs = absErrors[std::min(absErrors.size() - 1, size_t(std::ceil(0.99 * absErrors.size())) - 1)];
+    result.outsideBoundFraction = double(outsideBound) / errorsMs.size();
+    return result;
+}
+
+int runOffline(int minutes, quint32 seed, double rateHz, double driftPpm, double intervalMs)
+{
+    out() << "Simulated " << minutes << " min at " << rateHz << " Hz, device clock drift " << driftPpm
+          << " ppm, connection interval " << intervalMs << " ms, one-way floor 3 ms" << Qt::endl;
+
+    bool ok = true;
+    for (bool withProbes : {false, true}) {
+        const OfflineResult r = simulateSync(withProbes, minutes, seed, rateHz, driftPpm, intervalMs);
+        const double driftError = r.estimate.driftPpm - driftPpm;
+        out() << (withProbes ? "With probes:    " : "Timestamps only:") << " drift "
+              << QString::number(r.estimate.driftPpm, 'f', 2) << " ppm (error "
+              << QString::number(driftError, 'f', 2) << "), sensor time error mean "
+              << QString::number(r.meanErrorMs, 'f', 2) << " ms, |p99| "
+              << QString::number(r.p99AbsErrorMs, 'f', 2) << " ms";
+        if (withProbes) {
+            out() << ", claimed +/- " << QString::number(r.estimate.uncertaintyMs, 'f', 2) << " ms, outside "
+                  << QString::number(r.outsideBoundFraction * 100.0, 'f', 2) << "%";
+        }
+        out() << Qt::endl;
+
+        // 10 ppm over the 5 minute fit is 3 ms; a pinned offset must hold
+        // the bound it reports
+        ok = ok && std::abs(driftError) <= 10.0;
+        if (withProbes)
+            ok = ok && r.outsideBoundFraction <= 0.01;
+    }
+    out() << (ok ? "PASS" : "FAIL") << Qt::endl;
+    return ok ? 0 : 2;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("esp32sim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Simulated ESP32 vitals peripheral with a drifting clock.");
+    parser.addHelpOption();
+    QCommandLineOption rateOption("rate", "Samples per second.", "hz", "2");
+    QCommandLineOption driftOption("drift-ppm", "How much slower the device clock runs.", "ppm", "30");
+    QCommandLineOption jitterOption("jitter-ms", "Random delay between stamping and sending.", "ms", "5");
+    QCommandLineOption offlineOption("offline", "Check the clock estimator on simulated arrivals instead.");
+    QCommandLineOption minutesOption("minutes", "Offline: simulated duration.", "minutes", "10");
+    QCommandLineOption seedOption("seed", "Offline: random seed.", "seed", "1");
+    QCommandLineOption intervalOption("interval-ms", "Offline: BLE connection interval.", "ms", "30");
+    parser.addOptions({rateOption, driftOption, jitterOption, offlineOption, minutesOption, seedOption,
+                       intervalOption});
+    parser.process(app);
+
+    const double rateHz = qBound(0.1, parser.value(rateOption).toDouble(), 100.0);
+    const double driftPpm = parser.value(driftOption).toDouble();
+    if (parser.isSet(offlineOption)) {
+        return runOffline(qMax(2, parser.value(minutesOption).toInt()), parser.value(seedOption).toUInt(), rateHz,
+                          driftPpm, qMax(1.0, parser.value(intervalOption).toDouble()));
+    }
+    const int jitterMs = qMax(0, parser.value(jitterOption).toInt());
+
+    // --- Device clock ---
+    const qint64 startNs = monotonicNowNs();
+    const qint64 bootOffsetUs = qint64(QRandomGenerator::global()->bounded(1000000)) * 1000;
+    auto deviceTimeUs = [=]() {
+        return bootOffsetUs + qint64(double(monotonicNowNs() - startNs) / (1.0 + driftPpm * 1e-6) / 1000.0);
+    };
+
+    // --- GATT service, as in the ESP32 sketch ---
+    const QLowEnergyDescriptorData cccd(QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration,
+                                        QByteArray(2, 0));
+    QLowEnergyCharacteristicData vitalsChar;
+    vitalsChar.setUuid(QBluetoothUuid(CHARACTERISTIC_UUID));
+    vitalsChar.setValueLength(0, 64);
+    vitalsChar.setProperties(QLowEnergyCharacteristic::Read | QLowEnergyCharacteristic::Notify);
+    vitalsChar.addDescriptor(cccd);
+    QLowEnergyCharacteristicData probeChar;
+    probeChar.setUuid(QBluetoothUuid(PROBE_CHARACTERISTIC_UUID));
+    probeChar.setValueLength(0, 64);
+    probeChar.setProperties(QLowEnergyCharacteristic::Write | QLowEnergyCharacteristic::WriteNoResponse
+                            | QLowEnergyCharacteristic::Notify);
+    probeChar.addDescriptor(cccd);
+    QLowEnergyServiceData serviceData;
+    serviceData.setType(QLowEnergyServiceData::ServiceTypePrimary);
+    serviceData.setUuid(QBluetoothUuid(SERVICE_UUID));
+    serviceData.addCharacteristic(vitalsChar);
+    serviceData.addCharacteristic(probeChar);
+
+    // 31 bytes each: the 128-bit service UUID fits the advertisement, the name
+    // goes into the scan response
+    QLowEnergyAdvertisingData advertising;
+    advertising.setDiscoverability(QLowEnergyAdvertisingData::DiscoverabilityGeneral);
+    advertising.setServices({QBluetoothUuid(SERVICE_UUID)});
+    QLowEnergyAdvertisingData scanResponse;
+    scanResponse.setLocalName(QStringLiteral("ESP32-CAM-Data"));
+
+    std::unique_ptr<QLowEnergyController> peripheral;
+    std::unique_ptr<QLowEnergyService> service;
+    quint64 samplesSent = 0;
+    quint64 probesAnswered = 0;
+
+    // BlueZ needs a fresh controller and service after every disconnection
+    std::function<void()> advertise = [&]() {
+        service.reset();
+        peripheral.reset(QLowEnergyController::createPeripheral());
+        service.reset(peripheral->addService(serviceData));
+        QObject::connect(service.get(), &QLowEnergyService::characteristicChanged, &app,
+                         [&](const QLowEnergyCharacteristic &characteristic, const QByteArray &value) {
+                             if (characteristic.uuid() != QBluetoothUuid(PROBE_CHARACTERISTIC_UUID))
+                                 return;
+                             service->writeCharacteristic(characteristic, value.trimmed() + ','
+                                                                              + QByteArray::number(deviceTimeUs()));
+                             ++probesAnswered;
+                         });
+        QObject::connect(peripheral.get(), &QLowEnergyController::connected, &app,
+                         []() { out() << "Central connected" << Qt::endl; });
+        QObject::connect(peripheral.get(), &QLowEnergyController::disconnected, &app, [&]() {
+            out() << "Central disconnected after " << samplesSent << " samples, " << probesAnswered
+                  << " probes" << Qt::endl;
+            QTimer::singleShot(0, &app, advertise);
+        });
+        peripheral->startAdvertising(QLowEnergyAdvertisingParameters(), advertising, scanResponse);
+    };
+    advertise();
+    out() << "Advertising ESP32-CAM-Data: " << rateHz << " Hz, device clock " << driftPpm
+          << " ppm slow, up to " << jitterMs << " ms from stamp to send" << Qt::endl;
+
+    // --- Samples ---
+    QTimer sampleTimer;
+    sampleTimer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&sampleTimer, &QTimer::timeout, &app, [&]() {
+        if (!service || peripheral->state() != QLowEnergyController::ConnectedState)
+            return;
+        const qint64 stampUs = deviceTimeUs();
+        const double phase = double(stampUs) / 60e6 * TWO_PI;
+        const QByteArray payload = QByteArray::number(36.8 + 0.3 * std::sin(phase), 'f', 1) + ','
+                                   + QByteArray::number(125.0 + 10.0 * std::sin(phase * 3.0), 'f', 0) + ','
+                                   + QByteArray::number(stampUs);
+        QTimer::singleShot(jitterMs > 0 ? int(QRandomGenerator::global()->bounded(jitterMs + 1)) : 0, &app,
+                           [&, payload]() {
+                               if (!service)
+                                   return;
+                               const QLowEnergyCharacteristic characteristic =
+                                   service->characteristic(QBluetoothUuid(CHARACTERISTIC_UUID));
+                               service->writeCharacteristic(characteristic, payload);
+                               ++samplesSent;
+                           });
+    });
+    sampleTimer.start(int(1000.0 / rateHz));
+
+    return app.exec();
+}
@@ -0,0 +1,302 @@
+// Loopback load test of the vitals fan-out server.
+//
+// Starts a VitalsServer on its own thread, connects N WebSocket subscribers
+// on the main thread and publishes samples from a third thread at a fixed
+// rate. Reports publish-to-receive latency percentiles over all subscribers,
+// frames dropped by per-client backpressure, and process CPU time.
+//
+//   fanoutbench [--clients 50] [--rate 50] [--seconds 10] [--stalled 0]
+//
+// --stalled N makes N of the subscribers raw TCP sockets that complete the
+// WebSocket handshake and then stop reading, with a small receive buffer, so
+// the kernel buffers on both ends fill up. The rate is raised if needed so
+// that each of them is sent more than those buffers hold. At the end they
+// read what got through: every stalled subscriber must have lost samples to
+// its server-side ring, and every reading subscriber none. Exits with 2
+// otherwise.
+//
+// Runs on the desktop (Linux x86) as well as on the device (adb shell).
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <QWebSocket>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "vitalsserver.h"
+
+namespace {
+
+// Receive buffer of a stalled subscriber (the kernel doubles it)
+const int STALLED_RECEIVE_BUFFER = 4096;
+// Samples a stalled subscriber must be sent: at 30 bytes a frame, several
+// times what its receive buffer, the server's capped send buffer, the
+// server's in-flight bytes and its ring hold together
+const quint64 STALLED_MIN_SAMPLES = 5000;
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// A subscriber that upgrades to WebSocket by hand and then reads nothing until
+// drain() is called
+struct StalledSubscriber {
+    QTcpSocket socket;
+    QByteArray received;
+    bool upgraded = false;
+
+    void open(quint16 port, const QString &token)
+    {
+        // Bound first, so that the small buffer is in place before the
+        // connection advertises its first receive window
+        socket.bind(QHostAddress::LocalHost, 0);
+        socket.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, STALLED_RECEIVE_BUFFER);
+        QObject::connect(&socket, &QTcpSocket::connected, &socket, [this, port, token]() {
+            socket.write(QString("GET /?token=%1 HTTP/1.1\r\n"
+                                 "Host: 127.0.0.1:%2\r\n"
+                                 "Upgrade: websocket\r\n"
+                                 "Connection: Upgrade\r\n"
+                                 "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                                 "Sec-WebSocket-Version: 13\r\n\r\n").arg(token).arg(port).toLatin1());
+        });
+        // Reads byte by byte until the end of the response headers; after that
+        // the socket's one byte buffer stays full and Qt stops reading
+        socket.setReadBufferSize(1);
+        QObject::connect(&socket, &QTcpSocket::readyRead, &socket, [this]() {
+            while (!upgraded && socket.bytesAvailable() > 0) {
+                received += socket.read(1);
+                if (received.endsWith("\r\n\r\n")) {
+                    upgraded = received.startsWith("HTTP/1.1 101");
+                    received.clear();
+                    if (!upgraded)
+                        socket.abort();
+                }
+            }
+        });
+        socket.connectToHost(QHostAddress::LocalHost, port);
+    }
+
+    // Reads whatever the kernel and the server still hold for it, until
+    // nothing has arrived for `quietMs`
+    void drain(int quietMs)
+    {
+        socket.setReadBufferSize(0);
+        QElapsedTimer quiet;
+        quiet.start();
+        while (quiet.elapsed() < quietMs) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+            if (socket.bytesAvailable() > 0) {
+                received += socket.readAll();
+                quiet.restart();
+            }
+        }
+    }
+
+    // Sample frames among the (unmasked) server frames received
+    quint64 samples() const
+    {
+        quint64 count = 0;
+        qsizetype pos = 0;
+        const uchar *p = reinterpret_cast<const uchar *>(received.constData());
+        while (received.size() - pos >= 2) {
+            qsizetype header = 2;
+            quint64 length = p[pos + 1] & 0x7F;
+            if (length == 126) {
+                header = 4;
+                length = received.size() - pos >= 4 ? (quint64(p[pos + 2]) << 8) | p[pos + 3] : 0;
+            } else if (length == 127) {
+                break; // Never sent: frames are far smaller
+            }
+            if (quint64(received.size() - pos - header) < length)
+                break;
+            if (length > 0 && p[pos + header] == fanoutframe::Sample)
+                ++count;
+            pos += header + qsizetype(length);
+        }
+        return count;
+    }
+};
+
+double percentileUs(std::vector<qint64> &sorted, double q)
+{
+    if (sorted.empty())
+        return 0.0;
+    // Nearest-rank percentile
+    const size_t rank = size_t(std::ceil(q * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)] / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("fanoutbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Loopback load test of the WebSocket vitals fan-out server.");
+    parser.addHelpOption();
+    QCommandLineOption clientsOption({"c", "clients"}, "Subscribers.", "count", "50");
+    QCommandLineOption rateOption({"r", "rate"}, "Samples published per second.", "hz", "50");
+    QCommandLineOption secondsOption({"s", "seconds"}, "Publishing duration.", "seconds", "10");
+    QCommandLineOption stalledOption("stalled", "Subscribers that stop reading after the handshake.", "count", "0");
+    parser.addOptions({clientsOption, rateOption, secondsOption, stalledOption});
+    parser.process(app);
+
+    const int clientCount = qMax(1, parser.value(clientsOption).toInt());
+    int rate = qBound(1, parser.value(rateOption).toInt(), 10000);
+    const int seconds = qMax(1, parser.value(secondsOption).toInt());
+    const int stalled = qBound(0, parser.value(stalledOption).toInt(), clientCount);
+    if (stalled > 0 && quint64(rate) * seconds < STALLED_MIN_SAMPLES) {
+        rate = int((STALLED_MIN_SAMPLES + seconds - 1) / seconds);
+        out() << "Rate raised to " << rate << " Hz, so that the stalled subscribers' buffers overflow"
+              << Qt::endl;
+    }
+    const int readers = clientCount - stalled;
+
+    // --- Server ---
+    QThread serverThread;
+    serverThread.setObjectName(QStringLiteral("FanoutThread"));
+    VitalsServer *server = new VitalsServer();
+    server->moveToThread(&serverThread);
+    QObject::connect(&serverThread, &QThread::finished, server, &QObject::deleteLater);
+    std::atomic<int> port{0};
+    QObject::connect(server, &VitalsServer::listening, server, [&port](quint16 p) { port = p; }, Qt::DirectConnection);
+    serverThread.start();
+    const QString token = VitalsServer::generateToken();
+    QMetaObject::invokeMethod(server, [server, token]() { server->start(0, token, QHostAddress::LocalHost); });
+    while (port.load() == 0)
+        QThread::msleep(1);
+
+    // --- Subscribers ---
+    std::vector<qint64> latenciesNs;
+    latenciesNs.reserve(size_t(readers) * rate * seconds);
+    std::vector<std::unique_ptr<QWebSocket>> sockets;
+    std::vector<quint64> readerSamples(size_t(readers), 0);
+    int connected = 0;
+    for (int i = 0; i < readers; ++i) {
+        auto socket = std::make_unique<QWebSocket>();
+        QObject::connect(socket.get(), &QWebSocket::connected, &app, [&connected]() { ++connected; });
+        QObject::connect(socket.get(), &QWebSocket::binaryMessageReceived, &app,
+                         [&latenciesNs, &readerSamples, i](const QByteArray &frame) {
+                             fanoutframe::Header header;
+                             if (fanoutframe::decodeHeader(frame, header) && header.type == fanoutframe::Sample) {
+                                 latenciesNs.push_back(monotonicNowNs() - header.sentNs);
+                                 ++readerSamples[size_t(i)];
+                             }
+                         });
+        socket->open(QUrl(QString("ws://127.0.0.1:%1/?token=%2").arg(port.load()).arg(token)));
+        sockets.push_back(std::move(socket));
+    }
+    std::vector<std::unique_ptr<StalledSubscriber>> stalledSubscribers;
+    for (int i = 0; i < stalled; ++i) {
+        stalledSubscribers.push_back(std::make_unique<StalledSubscriber>());
+        stalledSubscribers.back()->open(quint16(port.load()), token);
+    }
+    const auto upgradedCount = [&stalledSubscribers]() {
+        return int(std::count_if(stalledSubscribers.begin(), stalledSubscribers.end(),
+                                 [](const std::unique_ptr<StalledSubscriber> &s) { return s->upgraded; }));
+    };
+    QElapsedTimer waitTimer;
+    waitTimer.start();
+    while ((connected < readers || upgradedCount() < stalled) && waitTimer.elapsed() < 10000)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    out() << "Subscribers connected: " << connected + upgradedCount() << " of " << clientCount
+          << " (" << upgradedCount() << " stalled)" << Qt::endl;
+
+    // --- Publish ---
+    const std::clock_t cpuStart = std::clock();
+    QElapsedTimer wall;
+    wall.start();
+    std::atomic<bool> publishing{true};
+    std::thread publisher([&]() {
+        const qint64 intervalNs = 1000000000LL / rate;
+        const qint64 startNs = monotonicNowNs();
+        for (quint64 n = 0; n < quint64(rate) * seconds; ++n) {
+            const qint64 dueNs = startNs + qint64(n) * intervalNs;
+            while (monotonicNowNs() < dueNs)
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            VitalsSample sample;
+            sample.temperature_c = 36.5f + float(n % 10) * 0.1f;
+            sample.heart_rate_bpm = 120.0f + float(n % 20);
+            sample.sequence = n + 1;
+            sample.arrivalNs = monotonicNowNs();
+            QMetaObject::invokeMethod(server, [server, sample]() { server->publishSample(sample); });
+        }
+        publishing = false;
+    });
+
+    while (publishing.load())
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    publisher.join();
+    // Let the last frames arrive
+    QElapsedTimer drain;
+    drain.start();
+    while (drain.elapsed() < 500)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    const double wallSeconds = wall.nsecsElapsed() / 1e9;
+    const double cpuSeconds = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    // Only now do the stalled subscribers read: whatever the kernel buffers and
+    // the server's ring kept for them
+    for (const auto &subscriber : stalledSubscribers)
+        subscriber->drain(500);
+
+    // --- Report ---
+    const quint64 published = quint64(rate) * seconds;
+    std::sort(latenciesNs.begin(), latenciesNs.end());
+    out() << "Published: " << published << " samples at " << rate << " Hz" << Qt::endl;
+    out() << "Delivered: " << latenciesNs.size() << " frames (expected "
+          << published * quint64(readers) << " to reading subscribers)" << Qt::endl;
+    out() << "Latency us: p50 " << QString::number(percentileUs(latenciesNs, 0.50), 'f', 0)
+          << ", p99 " << QString::number(percentileUs(latenciesNs, 0.99), 'f', 0)
+          << ", max " << QString::number(latenciesNs.empty() ? 0.0 : latenciesNs.back() / 1000.0, 'f', 0) << Qt::endl;
+    out() << "Server: sent " << server->framesSent() << ", dropped " << server->framesDropped() << Qt::endl;
+    out() << "CPU: " << QString::number(100.0 * cpuSeconds / wallSeconds, 'f', 1)
+          << "% of one core (server, subscribers and publisher together)" << Qt::endl;
+
+    // Backpressure must cost the stalled subscribers samples, and only them
+    bool passed = true;
+    for (int i = 0; i < readers; ++i) {
+        if (readerSamples[size_t(i)] != published) {
+            err() << "FAIL: reading subscriber " << i << " lost " << published - qMin(published, readerSamples[size_t(i)])
+                  << " samples" << Qt::endl;
+            passed = false;
+        }
+    }
+    for (int i = 0; i < stalled; ++i) {
+        const StalledSubscriber &subscriber = *stalledSubscribers[size_t(i)];
+        const quint64 got = subscriber.samples();
+        out() << "Stalled subscriber " << i << ": received " << got << ", dropped " << published - qMin(published, got)
+              << Qt::endl;
+        if (!subscriber.upgraded || got >= published) {
+            err() << "FAIL: stalled subscriber " << i << (subscriber.upgraded ? " dropped nothing" : " never connected")
+                  << Qt::endl;
+            passed = false;
+        }
+    }
+
+    sockets.clear();
+    stalledSubscribers.clear();
+    serverThread.quit();
+    serverThread.wait();
+    return passed ? 0 : 2;
+}
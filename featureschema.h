@@ -0,0 +1,137 @@
+#ifndef FEATURESCHEMA_H
+#define FEATURESCHEMA_H
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "babydata.h"
+
+// The 9 inputs of health_classifier.onnx, defined once.
+//
+// Order is the tensor binding order. Everything derived from the table (input
+// names, BabyData members, value slots, ranges) is computed at compile time;
+// HealthPredictor::validateSignature() checks it against the model's input
+// metadata once per session load.
+struct FeatureSpec {
+    enum class Source { Profile, Vitals };
+
+    const char *name;          // model input name, also the dataset column
+    float BabyData::*field;    // nullptr for the gender string tensor
+    Source source;             // entered in InitialFormWindow, or streamed over BLE
+    float minimum;             // plausible range, inclusive (checked by the form / BleClient)
+    float maximum;
+    int decimals;              // for display and input validators
+};
+
+namespace featureschema {
+
+inline constexpr std::array<FeatureSpec, 9> INPUTS = {{
+    {"gender",                nullptr,                          FeatureSpec::Source::Profile, 0.0f,  0.0f, 0},
+    {"gestational_age_weeks", &BabyData::gestational_age_weeks, FeatureSpec::Source::Profile, 0.0f, 50.0f, 1},
+    {"birth_weight_kg",       &BabyData::birth_weight_kg,       FeatureSpec::Source::Profile, 0.0f, 10.0f, 2},
+    {"birth_length_cm",       &BabyData::birth_length_cm,       FeatureSpec::Source::Profile, 0.0f, 100.0f, 2},
+    {"age_days",              &BabyData::age_days,              FeatureSpec::Source::Profile, 0.0f, 1000.0f, 0},
+    {"weight_kg",             &BabyData::weight_kg,             FeatureSpec::Source::Profile, 0.0f, 10.0f, 2},
+    {"length_cm",             &BabyData::length_cm,             FeatureSpec::Source::Profile, 0.0f, 100.0f, 2},
+    {"temperature_c",         &BabyData::temperature_c,         FeatureSpec::Source::Vitals, 25.0f, 45.0f, 1},
+    {"heart_rate_bpm",        &BabyData::heart_rate_bpm,        FeatureSpec::Source::Vitals, 0.0f, 300.0f, 0},
+}};
+
+constexpr size_t InputCount = INPUTS.size();
+constexpr size_t GenderIndex = 0;
+// Float inputs, stored contiguously in input order after the gender
+constexpr size_t NumericCount = InputCount - 1;
+
+constexpr bool sameName(const char *a, const char *b)
+{
+    while (*a && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+// Position in INPUTS, or InputCount if there is no such input
+constexpr size_t indexOf(const char *name)
+{
+    for (size_t i = 0; i < InputCount; ++i) {
+        if (sameName(INPUTS[i].name, name))
+            return i;
+    }
+    return InputCount;
+}
+
+// Position of a float input among the NumericCount value slots
+constexpr size_t slotOf(const char *name)
+{
+    return indexOf(name) - 1;
+}
+
+constexpr std::array<const char *, InputCount> makeNames()
+{
+    std::array<const char *, InputCount> names = {};
+    for (size_t i = 0; i < InputCount; ++i)
+        names[i] = INPUTS[i].name;
+    return names;
+}
+
+constexpr std::array<float BabyData::*, NumericCount> makeNumericFields()
+{
+    std::array<float BabyData::*, NumericCount> fields = {};
+    for (size_t i = 0; i < NumericCount; ++i)
+        fields[i] = INPUTS[i + 1].field;
+    return fields;
+}
+
+constexpr bool isWellFormed()
+{
+    if (INPUTS[GenderIndex].field != nullptr)
+        return false;
+    for (size_t i = 0; i < InputCount; ++i) {
+        if (i != GenderIndex && (INPUTS[i].field == nullptr || INPUTS[i].minimum > INPUTS[i].maximum))
+            return false;
+        if (indexOf(INPUTS[i].name) != i)
+            return false; // Duplicate name
+        for (size_t j = 0; j < i; ++j) {
+            if (INPUTS[i].field == INPUTS[j].field && INPUTS[i].field != nullptr)
+                return false; // Two inputs bound to one member
+        }
+    }
+    return true;
+}
+
+inline constexpr std::array<const char *, InputCount> NAMES = makeNames();
+inline constexpr std::array<float BabyData::*, NumericCount> NUMERIC_FIELDS = makeNumericFields();
+
+static_assert(isWellFormed(), "featureschema::INPUTS: gender must come first, then unique float members");
+static_assert(slotOf("temperature_c") < NumericCount && slotOf("heart_rate_bpm") < NumericCount,
+              "featureschema::INPUTS: the BLE vitals must be model inputs");
+
+namespace detail {
+
+// Each member pointer is a constant here, so every copy is a plain load/store
+// (a loop over NUMERIC_FIELDS would read the member offsets at runtime)
+template <size_t... Slot>
+inline void assemble(const BabyData &data, std::array<float, NumericCount> &values, std::index_sequence<Slot...>)
+{
+    ((values[Slot] = data.*std::integral_constant<float BabyData::*, NUMERIC_FIELDS[Slot]>::value), ...);
+}
+
+} // namespace detail
+
+// Copies the float inputs of `data` into their value slots
+inline void assemble(const BabyData &data, std::array<float, NumericCount> &values)
+{
+    detail::assemble(data, values, std::make_index_sequence<NumericCount>());
+}
+
+inline bool inRange(size_t index, float value)
+{
+    return value >= INPUTS[index].minimum && value <= INPUTS[index].maximum;
+}
+
+} // namespace featureschema
+
+#endif // FEATURESCHEMA_H
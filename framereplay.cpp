@@ -0,0 +1,245 @@
+// Replays a camera stream through the BLE frame path without a camera.
+//
+// Splits JPEG frames into notifications with the ESP32-CAM chunk header and
+// feeds them to a FrameAssembler from a thread standing in for the BLE
+// thread, paced at the link rate, while a FrameDecoder decodes on its own
+// thread as in BleClient. Reports the decoded frame rate, the latency from the
+// first chunk to the decoded image and from the last chunk to it
+// (percentiles), and frames dropped as late, incomplete or undecodable.
+//
+//   framereplay [--images dir] [--fps 10] [--seconds 10] [--chunk 244]
+//               [--kbps 1000] [--loss 0]
+//
+// Without --images, synthetic QVGA JPEGs are used. --loss drops that fraction
+// of chunks at random, to exercise the incomplete-frame path.
+//
+// Runs on the desktop (Linux x86) as well as on the device (adb shell).
+
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QTextStream>
+#include <QThread>
+#include <QtEndian>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "cameraframes.h"
+#include "vitalssample.h"
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+double percentileMs(const std::vector<qint64> &sorted, double q)
+{
+    if (sorted.empty())
+        return 0.0;
+    // Nearest-rank percentile
+    const size_t rank = size_t(std::ceil(q * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)] / 1e6;
+}
+
+// A moving bar over a gradient, so consecutive frames differ like a real scene
+std::vector<QByteArray> syntheticFrames(int count)
+{
+    std::vector<QByteArray> frames;
+    for (int i = 0; i < count; ++i) {
+        QImage image(320, 240, QImage::Format_RGB32);
+        const int barX = (i * 16) % image.width();
+        for (int y = 0; y < image.height(); ++y) {
+            QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+            for (int x = 0; x < image.width(); ++x) {
+                const bool bar = x >= barX && x < barX + 40 && y >= 60 && y < 180;
+                line[x] = bar ? qRgb(255, 255, 255)
+                              : qRgb(x * 255 / image.width(), y * 255 / image.height(), (x + y + i * 8) % 256);
+            }
+        }
+
+        QByteArray jpeg;
+        QBuffer buffer(&jpeg);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "JPG", 80);
+        frames.push_back(jpeg);
+    }
+    return frames;
+}
+
+std::vector<QByteArray> loadFrames(const QString &directory)
+{
+    std::vector<QByteArray> frames;
+    const QDir dir(directory);
+    for (const QString &name : dir.entryList({"*.jpg", "*.jpeg"}, QDir::Files, QDir::Name)) {
+        QFile file(dir.filePath(name));
+        if (file.open(QIODevice::ReadOnly))
+            frames.push_back(file.readAll());
+    }
+    return frames;
+}
+
+// The notifications of one frame, as the ESP32-CAM sends them
+std::vector<QByteArray> chunkFrame(const QByteArray &jpeg, quint16 frameId, int chunkPayload)
+{
+    std::vector<QByteArray> chunks;
+    for (qsizetype offset = 0; offset < jpeg.size(); offset += chunkPayload) {
+        const qsizetype size = qMin<qsizetype>(chunkPayload, jpeg.size() - offset);
+        QByteArray chunk(FrameChunk::HeaderSize + size, '\0');
+        char *raw = chunk.data();
+        qToLittleEndian<quint16>(frameId, raw);
+        qToLittleEndian<quint32>(quint32(offset), raw + 2);
+        raw[6] = char(offset + size == jpeg.size() ? FrameChunk::EndOfFrame : 0);
+        std::memcpy(raw + FrameChunk::HeaderSize, jpeg.constData() + offset, size_t(size));
+        chunks.push_back(chunk);
+    }
+    return chunks;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("framereplay");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays chunked JPEG frames through the BLE frame assembler and decoder.");
+    parser.addHelpOption();
+    QCommandLineOption imagesOption("images", "Directory of JPEG frames (default: synthetic QVGA).", "dir");
+    QCommandLineOption fpsOption("fps", "Frames sent per second.", "fps", "10");
+    QCommandLineOption secondsOption({"s", "seconds"}, "Replay duration.", "seconds", "10");
+    QCommandLineOption chunkOption("chunk", "Payload bytes per notification.", "bytes", "244");
+    QCommandLineOption kbpsOption("kbps", "Link rate the notifications are paced at.", "kbit/s", "1000");
+    QCommandLineOption lossOption("loss", "Fraction of chunks lost on the link.", "fraction", "0");
+    parser.addOptions({imagesOption, fpsOption, secondsOption, chunkOption, kbpsOption, lossOption});
+    parser.process(app);
+
+    const double fps = qBound(0.1, parser.value(fpsOption).toDouble(), 240.0);
+    const int seconds = qMax(1, parser.value(secondsOption).toInt());
+    const int chunkPayload = qBound(16, parser.value(chunkOption).toInt(), 4096);
+    const double kbps = qMax(1.0, parser.value(kbpsOption).toDouble());
+    const double loss = qBound(0.0, parser.value(lossOption).toDouble(), 1.0);
+
+    const std::vector<QByteArray> jpegs = parser.isSet(imagesOption) ? loadFrames(parser.value(imagesOption))
+                                                                     : syntheticFrames(20);
+    if (jpegs.empty()) {
+        err() << "ERROR: no JPEG frames in " << parser.value(imagesOption) << Qt::endl;
+        return 1;
+    }
+    qsizetype totalBytes = 0;
+    for (const QByteArray &jpeg : jpegs)
+        totalBytes += jpeg.size();
+    out() << "Frames: " << jpegs.size() << " JPEGs, " << totalBytes / qsizetype(jpegs.size()) / 1024
+          << " KB on average, " << chunkPayload << " byte chunks at " << kbps << " kbit/s" << Qt::endl;
+
+    // --- Frame Path, as in BleClient ---
+    FrameBufferPool pool;
+    QThread decoderThread;
+    decoderThread.setObjectName(QStringLiteral("FrameDecoderThread"));
+    FrameDecoder *decoder = new FrameDecoder(&pool);
+    decoder->moveToThread(&decoderThread);
+    QObject::connect(&decoderThread, &QThread::finished, decoder, &QObject::deleteLater);
+    FrameAssembler assembler(&pool, decoder);
+
+    std::vector<qint64> firstChunkToDecodedNs;
+    std::vector<qint64> completeToDecodedNs;
+    qint64 firstDecodedNs = 0;
+    qint64 lastDecodedNs = 0;
+    // Queued to the main thread, as the UI receives it
+    QObject::connect(decoder, &FrameDecoder::frameDecoded, &app, [&](const QImage &, const FrameTiming &timing) {
+        firstChunkToDecodedNs.push_back(timing.decodedNs - timing.firstChunkNs);
+        completeToDecodedNs.push_back(timing.decodedNs - timing.completeNs);
+        if (firstDecodedNs == 0)
+            firstDecodedNs = timing.decodedNs;
+        lastDecodedNs = timing.decodedNs;
+    });
+    decoderThread.start();
+
+    // --- Replay ---
+    std::atomic<bool> replaying{true};
+    quint64 framesSent = 0;
+    quint64 chunksLost = 0;
+    qint64 behindNs = 0;
+    std::thread link([&]() {
+        std::mt19937 random(1);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        const qint64 frameIntervalNs = qint64(1e9 / fps);
+        const double nsPerByte = 8e6 / kbps;
+        const qint64 startNs = monotonicNowNs();
+        qint64 linkFreeNs = startNs;
+        const quint64 frames = quint64(fps * seconds);
+        for (quint64 n = 0; n < frames; ++n) {
+            const qint64 frameDueNs = startNs + qint64(n) * frameIntervalNs;
+            linkFreeNs = qMax(linkFreeNs, frameDueNs);
+            for (const QByteArray &chunk : chunkFrame(jpegs[n % jpegs.size()], quint16(n), chunkPayload)) {
+                // A chunk arrives once the link has carried it
+                linkFreeNs += qint64(chunk.size() * nsPerByte);
+                while (monotonicNowNs() < linkFreeNs)
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                if (loss > 0.0 && uniform(random) < loss) {
+                    ++chunksLost;
+                    continue;
+                }
+                assembler.addChunk(chunk, monotonicNowNs());
+            }
+            ++framesSent;
+        }
+        // How far the link fell behind the camera's frame rate
+        behindNs = qMax<qint64>(0, linkFreeNs - (startNs + qint64(frames) * frameIntervalNs));
+        replaying = false;
+    });
+
+    while (replaying.load())
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    link.join();
+    // Let the last frame be decoded and delivered
+    QElapsedTimer drain;
+    drain.start();
+    while (drain.elapsed() < 500)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    decoderThread.quit();
+    decoderThread.wait();
+
+    // --- Report ---
+    const quint64 decoded = firstChunkToDecodedNs.size();
+    const double decodedSeconds = (lastDecodedNs - firstDecodedNs) / 1e9;
+    std::sort(firstChunkToDecodedNs.begin(), firstChunkToDecodedNs.end());
+    std::sort(completeToDecodedNs.begin(), completeToDecodedNs.end());
+    out() << "Sent: " << framesSent << " frames at " << fps << " fps";
+    if (chunksLost > 0)
+        out() << ", " << chunksLost << " chunks lost";
+    if (behindNs > 0)
+        out() << ", link finished " << QString::number(behindNs / 1e6, 'f', 0) << " ms behind the camera";
+    out() << Qt::endl;
+    out() << "Decoded: " << decoded << " frames, "
+          << QString::number(decoded > 1 && decodedSeconds > 0 ? (decoded - 1) / decodedSeconds : 0.0, 'f', 1)
+          << " fps, " << pool.droppedFrames() << " dropped" << Qt::endl;
+    for (const auto &[name, latencies] : {std::make_pair("first chunk to decoded", &firstChunkToDecodedNs),
+                                          std::make_pair("last chunk to decoded", &completeToDecodedNs)}) {
+        out() << "  " << name << " ms: p50 " << QString::number(percentileMs(*latencies, 0.50), 'f', 1)
+              << ", p95 " << QString::number(percentileMs(*latencies, 0.95), 'f', 1)
+              << ", p99 " << QString::number(percentileMs(*latencies, 0.99), 'f', 1)
+              << ", max " << QString::number(percentileMs(*latencies, 1.0), 'f', 1) << Qt::endl;
+    }
+    return 0;
+}
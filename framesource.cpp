@@ -0,0 +1,99 @@
+#include "framesource.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QTimer>
+
+#include "bleclient.h"
+
+// --- BleFrameSource ---
+
+BleFrameSource::BleFrameSource(BleClient *client, QObject *parent)
+    : FrameSource(parent), m_client(client)
+{
+}
+
+void BleFrameSource::start()
+{
+    if (m_connection)
+        return;
+    // Direct: frameDecoded is emitted on the decoder thread. Only one
+    // hand-off to this thread is queued at a time; it takes the newest frame
+    m_connection = connect(m_client, &BleClient::frameDecoded, this,
+                           [this](const QImage &image, const FrameTiming &timing) {
+                               if (m_latestFrame.put(image, timing))
+                                   QMetaObject::invokeMethod(this, &BleFrameSource::emitLatestFrame,
+                                                             Qt::QueuedConnection);
+                           }, Qt::DirectConnection);
+}
+
+void BleFrameSource::stop()
+{
+    disconnect(m_connection);
+    m_connection = QMetaObject::Connection();
+}
+
+void BleFrameSource::emitLatestFrame()
+{
+    QImage image;
+    FrameTiming timing;
+    // Taken even after stop(), so that a restart does not find a stale
+    // pending hand-off
+    if (m_latestFrame.take(image, timing) && m_connection)
+        emit frameReady(image, timing.decodedNs);
+}
+
+// --- DirectoryFrameSource ---
+
+DirectoryFrameSource::DirectoryFrameSource(const QString &directory, double framesPerSecond,
+                                           bool loop, QObject *parent)
+    : FrameSource(parent),
+      m_intervalNs(qint64(1e9 / qMax(0.1, framesPerSecond))),
+      m_loop(loop),
+      m_timer(new QTimer(this))
+{
+    const QDir dir(directory);
+    const QStringList names = dir.entryList({"*.jpg", "*.jpeg", "*.png", "*.bmp", "*.pgm"},
+                                            QDir::Files, QDir::Name);
+    for (const QString &name : names)
+        m_files.append(dir.filePath(name));
+    if (m_files.isEmpty())
+        qWarning() << "No images found in" << directory;
+
+    m_timer->setTimerType(Qt::PreciseTimer);
+    m_timer->setInterval(int(m_intervalNs / 1000000));
+    connect(m_timer, &QTimer::timeout, this, &DirectoryFrameSource::nextFrame);
+}
+
+void DirectoryFrameSource::start()
+{
+    if (m_files.isEmpty() || m_timer->isActive())
+        return;
+    m_index = 0;
+    m_framesPlayed = 0;
+    m_startNs = monotonicNowNs();
+    m_timer->start();
+}
+
+void DirectoryFrameSource::stop()
+{
+    m_timer->stop();
+}
+
+void DirectoryFrameSource::nextFrame()
+{
+    if (m_index >= m_files.size()) {
+        if (!m_loop) {
+            stop();
+            return;
+        }
+        m_index = 0;
+    }
+
+    const QImage image(m_files[m_index++]);
+    if (image.isNull()) {
+        qWarning() << "Cannot load" << m_files[m_index - 1];
+        return;
+    }
+    emit frameReady(image, m_startNs + m_framesPlayed++ * m_intervalNs);
+}
@@ -0,0 +1,86 @@
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include <QImage>
+#include <QObject>
+#include <QStringList>
+
+#include "cameraframes.h"
+
+class BleClient;
+class QTimer;
+
+// Anything that produces camera frames for analysis. Timestamps are
+// steady_clock based (see monotonicNowNs()).
+class FrameSource : public QObject
+{
+    Q_OBJECT
+
+public:
+    using QObject::QObject;
+
+public slots:
+    virtual void start() = 0;
+    virtual void stop() = 0;
+
+signals:
+    void frameReady(const QImage &image, qint64 timestampNs);
+};
+
+// Frames decoded from the ESP32-CAM stream of a BleClient. frameReady is
+// emitted on this object's thread with the newest frame only: frames decoded
+// while the analysis is still busy with an earlier one are skipped.
+class BleFrameSource : public FrameSource
+{
+    Q_OBJECT
+
+public:
+    explicit BleFrameSource(BleClient *client, QObject *parent = nullptr);
+
+    quint64 skippedFrames() const { return m_latestFrame.skippedFrames(); }
+
+public slots:
+    void start() override;
+    void stop() override;
+
+private slots:
+    void emitLatestFrame();
+
+private:
+    BleClient *m_client;
+    QMetaObject::Connection m_connection;
+    LatestFrame m_latestFrame;
+};
+
+// Plays back the images of a directory in file name order at a fixed rate,
+// for testing the analysis without a camera. Timestamps follow the nominal
+// rate, so a recording replays identically however busy the machine is.
+class DirectoryFrameSource : public FrameSource
+{
+    Q_OBJECT
+
+public:
+    explicit DirectoryFrameSource(const QString &directory, double framesPerSecond = 10.0,
+                                  bool loop = true, QObject *parent = nullptr);
+
+    int frameCount() const { return m_files.size(); }
+
+public slots:
+    void start() override;
+    void stop() override;
+
+private slots:
+    void nextFrame();
+
+private:
+    QStringList m_files;
+    qint64 m_intervalNs;
+    bool m_loop;
+    QTimer *m_timer;
+
+    int m_index = 0;
+    qint64 m_startNs = 0;
+    qint64 m_framesPlayed = 0;
+};
+
+#endif // FRAMESOURCE_H
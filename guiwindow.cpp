@@ -3,18 +3,29 @@
 // Required for layout management
 #include <QHBoxLayout>
 #include <QFrame>
-#include <QDateTime>
+#include <QGroupBox>
+#include <QPixmap>
 
 #include <QDir>
 #include <QFileInfo>
 
-#include <QtCore/qjniobject.h>
-#include <QtCore/qcoreapplication.h>
-#include <QtCore/private/qandroidextras_p.h>
 #include <QStringLiteral>
 
-GuiWindow::GuiWindow(BleClient *client, QWidget *parent)
-    : QWidget(parent), m_bleClient(client)
+#include "structuredlogger.h"
+
+// Scheduler intervals and tolerances (how late each task may run)
+static const int VITALS_REFRESH_TOLERANCE_MS = 250;
+static const int LATENCY_REPORT_INTERVAL_MS = 5000;
+static const int LATENCY_REPORT_TOLERANCE_MS = 2000;
+// Trend line under the vitals: last hour from the per-minute rollup tier
+static const int TREND_INTERVAL_MS = 60000;
+static const int TREND_TOLERANCE_MS = 10000;
+static const qint64 TREND_WINDOW_MS = 3600 * 1000;
+static const size_t TREND_TIER = 1;
+
+GuiWindow::GuiWindow(BleClient *client, MotionMonitor *motion, MonitorController *monitor, TickScheduler *scheduler,
+                     QWidget *parent)
+    : QWidget(parent), m_bleClient(client), m_motionMonitor(motion), m_monitor(monitor), m_scheduler(scheduler)
 {
     setWindowTitle(tr("ESP32 BLE Client"));
     setMinimumSize(300, 400);
@@ -22,27 +33,32 @@ GuiWindow::GuiWindow(BleClient *client, QWidget *parent)
     setupUi();
     setupConnections();
 
-    // Set initial state from client properties
-    updateStatus(m_bleClient->status());
-    updateData(m_bleClient->data());
-    updateScanButtonState();
-
-    if (QNativeInterface::QAndroidApplication::sdkVersion() >= __ANDROID_API_T__) {
-        const auto notificationPermission = QStringLiteral("android.permission.POST_NOTIFICATIONS");        auto requestResult = QtAndroidPrivate::requestPermission(notificationPermission);
-        if (requestResult.result() != QtAndroidPrivate::Authorized) {
-            qWarning() << "Failed to acquire permission to post notifications "
-                          "(required for Android 13+)";
-        }
-    }
+    // Set initial state: the client lives on the BLE thread, so ask it to
+    // re-emit its state instead of reading the properties directly
+    updateScanButtonState(false);
+    QMetaObject::invokeMethod(m_bleClient, &BleClient::publishState, Qt::QueuedConnection);
+    updateRiskState(m_monitor->riskState());
+
+    setupTasks();
+}
+
+void GuiWindow::setupTasks()
+{
+    // Samples arrive faster than anyone reads the labels; repaint at most
+    // once per tick with whatever arrived last
+    m_vitalsRefreshTask = m_scheduler->addDeferredTask("ui.vitals", VITALS_REFRESH_TOLERANCE_MS,
+                                                       TickScheduler::Priority::Normal, this,
+                                                       [this]() { refreshVitalsLabels(); });
 
-    connect(this, &GuiWindow::notificationChanged,
-            this, &GuiWindow::updateAndroidNotification);
+    connect(m_scheduler, &TickScheduler::statsUpdated, this, &GuiWindow::updateSchedulerStats);
 
-    // QTimer for periodic prediction (10 seconds)
-    m_predictionTimer = new QTimer(this);
-    m_predictionTimer->setInterval(10000);
-    connect(m_predictionTimer, &QTimer::timeout, this, &GuiWindow::onTestButtonClicked);
-    m_predictionTimer->start();
+    m_latencyTask = m_scheduler->addTask("ui.latency", LATENCY_REPORT_INTERVAL_MS, LATENCY_REPORT_TOLERANCE_MS,
+                                         TickScheduler::Priority::Background, this,
+                                         [this]() { updateLatencyStats(); });
+
+    m_trendTask = m_scheduler->addTask("ui.trends", TREND_INTERVAL_MS, TREND_TOLERANCE_MS,
+                                       TickScheduler::Priority::Background, this,
+                                       [this]() { updateTrends(); });
 }
 
 void GuiWindow::setupUi()
@@ -56,39 +72,69 @@ void GuiWindow::setupUi()
     m_statusLabel->setTextFormat(Qt::RichText);
     mainLayout->addWidget(m_statusLabel);
 
-    // --- Data Area: Two Labels for Temp and HR ---
+    // --- Data Area: Two Tiles for Temp and HR ---
+    // Painted directly; a new sample only repaints the value line of each tile
     QHBoxLayout *dataDisplayLayout = new QHBoxLayout();
     dataDisplayLayout->setSpacing(20);
     dataDisplayLayout->setContentsMargins(10, 10, 10, 10);
 
-    // 1. Temperature Label Setup
-    m_tempLabel = new QLabel("Temperature: <br><b>-- °C</b>", this);
-    m_tempLabel->setAlignment(Qt::AlignCenter);
-    m_tempLabel->setTextFormat(Qt::RichText);
-    m_tempLabel->setStyleSheet("QLabel { background-color: #E0F2F1; border-radius: 8px; padding: 15px; font-size: 16px; font-weight: bold; color: #004D40; border: 1px solid #B2DFDB; }");
-    m_tempLabel->setMinimumHeight(80);
+    // 1. Temperature Tile Setup
+    m_tempTile = new VitalsTile(tr("Temperature"), TileStyle::temperature(), this);
+    m_tempTile->setValue("-- °C");
+    m_tempTile->setMinimumHeight(80);
 
-    // 2. Heart Rate Label Setup
-    m_hrLabel = new QLabel("Heart Rate: <br><b>-- BPM</b>", this);
-    m_hrLabel->setAlignment(Qt::AlignCenter);
-    m_hrLabel->setTextFormat(Qt::RichText);
-    m_hrLabel->setStyleSheet("QLabel { background-color: #E3F2FD; border-radius: 8px; padding: 15px; font-size: 16px; font-weight: bold; color: #1565C0; border: 1px solid #BBDEFB; }");
-    m_hrLabel->setMinimumHeight(80);
+    // 2. Heart Rate Tile Setup
+    m_hrTile = new VitalsTile(tr("Heart Rate"), TileStyle::heartRate(), this);
+    m_hrTile->setValue("-- BPM");
+    m_hrTile->setMinimumHeight(80);
 
-    dataDisplayLayout->addWidget(m_tempLabel);
-    dataDisplayLayout->addWidget(m_hrLabel);
+    dataDisplayLayout->addWidget(m_tempTile);
+    dataDisplayLayout->addWidget(m_hrTile);
 
     mainLayout->addLayout(dataDisplayLayout);
 
-    // --- Prediction Result Label ---
-    m_predictionResultLabel = new QLabel("Prediction: Not Run", this);
-    m_predictionResultLabel->setAlignment(Qt::AlignCenter);
-    m_predictionResultLabel->setTextFormat(Qt::RichText);
-    m_predictionResultLabel->setStyleSheet("QLabel { background-color: #F3F4F6; border-radius: 8px; padding: 10px; font-size: 18px; font-weight: bold; color: #374151; border: 2px solid #D1D5DB; margin: 10px; }");
-    m_predictionResultLabel->setMinimumHeight(60);
-    mainLayout->addWidget(m_predictionResultLabel);
+    // --- Prediction Result Tile ---
+    m_predictionTile = new VitalsTile(tr("Prediction"), TileStyle::neutral(), this);
+    m_predictionTile->setValue(tr("Not Run"));
+    m_predictionTile->setContentsMargins(10, 10, 10, 10);
+    m_predictionTile->setMinimumHeight(60);
+    mainLayout->addWidget(m_predictionTile);
     // -------------------------------
 
+    // --- Camera Panel ---
+    QGroupBox *cameraBox = new QGroupBox(tr("Camera"), this);
+    QVBoxLayout *cameraLayout = new QVBoxLayout(cameraBox);
+    m_cameraLabel = new QLabel(tr("No camera frames."), cameraBox);
+    m_cameraLabel->setAlignment(Qt::AlignCenter);
+    m_cameraLabel->setMinimumHeight(120);
+    m_cameraStatsLabel = new QLabel(cameraBox);
+    m_cameraStatsLabel->setTextFormat(Qt::PlainText);
+    m_cameraStatsLabel->setStyleSheet("font-size: 11px; color: #4B5563;");
+    cameraLayout->addWidget(m_cameraLabel);
+    m_motionLabel = new QLabel(tr("Motion: waiting for frames."), cameraBox);
+    m_motionLabel->setTextFormat(Qt::PlainText);
+    cameraLayout->addWidget(m_cameraStatsLabel);
+    cameraLayout->addWidget(m_motionLabel);
+    mainLayout->addWidget(cameraBox);
+
+    // --- Link Diagnostics Panel ---
+    QGroupBox *diagnosticsBox = new QGroupBox(tr("Link diagnostics"), this);
+    QVBoxLayout *diagnosticsLayout = new QVBoxLayout(diagnosticsBox);
+    m_diagnosticsLabel = new QLabel(tr("No link data yet."), diagnosticsBox);
+    m_diagnosticsLabel->setTextFormat(Qt::PlainText);
+    m_diagnosticsLabel->setWordWrap(true);
+    m_diagnosticsLabel->setStyleSheet("font-size: 11px; color: #4B5563;");
+    diagnosticsLayout->addWidget(m_diagnosticsLabel);
+    m_schedulerLabel = new QLabel(tr("Wake-ups/min: measuring..."), diagnosticsBox);
+    m_schedulerLabel->setTextFormat(Qt::PlainText);
+    m_schedulerLabel->setStyleSheet("font-size: 11px; color: #4B5563;");
+    diagnosticsLayout->addWidget(m_schedulerLabel);
+    m_latencyLabel = new QLabel(tr("Sensor age: waiting for device timestamps."), diagnosticsBox);
+    m_latencyLabel->setTextFormat(Qt::PlainText);
+    m_latencyLabel->setStyleSheet("font-size: 11px; color: #4B5563;");
+    diagnosticsLayout->addWidget(m_latencyLabel);
+    mainLayout->addWidget(diagnosticsBox);
+
     // --- Control Buttons ---
     QHBoxLayout *buttonLayout = new QHBoxLayout();
 
@@ -115,15 +161,29 @@ void GuiWindow::setupUi()
 void GuiWindow::setupConnections()
 {
     // Connections from UI to BleClient methods
+    // (BleClient lives on the BLE I/O thread, so all of these are queued)
     connect(m_scanButton, &QPushButton::clicked, m_bleClient, &BleClient::startScan);
     connect(m_disconnectButton, &QPushButton::clicked, m_bleClient, &BleClient::disconnectDevice);
-    connect(m_testButton, &QPushButton::clicked, this, &GuiWindow::onTestButtonClicked);
+    connect(m_testButton, &QPushButton::clicked, m_monitor, &MonitorController::predictNow);
 
 
     // Connections from BleClient signals to UI update slots
     connect(m_bleClient, &BleClient::statusChanged, this, &GuiWindow::updateStatus);
-    connect(m_bleClient, &BleClient::dataReceived, this, &GuiWindow::updateData);
-    connect(m_bleClient, &BleClient::scanFinished, this, &GuiWindow::updateScanButtonState);
+    connect(m_bleClient, &BleClient::sampleReceived, this, &GuiWindow::updateSample);
+    connect(m_bleClient, &BleClient::sampleRejected, this, &GuiWindow::rejectSample);
+    connect(m_bleClient, &BleClient::scanningChanged, this, &GuiWindow::updateScanButtonState);
+    connect(m_bleClient, &BleClient::linkStatsUpdated, this, &GuiWindow::updateLinkStats);
+    // Direct: runs on the decoder thread and only queues a repaint if none
+    // is pending, so frames never pile up behind a busy GUI thread
+    connect(m_bleClient, &BleClient::frameDecoded, this, [this](const QImage &image, const FrameTiming &timing) {
+        if (m_latestFrame.put(image, timing))
+            QMetaObject::invokeMethod(this, &GuiWindow::updateFrame, Qt::QueuedConnection);
+    }, Qt::DirectConnection);
+    connect(m_motionMonitor, &MotionMonitor::motionUpdated, this, &GuiWindow::updateMotion);
+
+    // The monitor decides; this window only shows the outcome
+    connect(m_monitor, &MonitorController::riskStateChanged, this, &GuiWindow::updateRiskState);
+    connect(m_monitor, &MonitorController::predictionMade, this, &GuiWindow::recordPrediction);
 }
 
 void GuiWindow::updateStatus(const QString &newStatus)
@@ -136,288 +196,183 @@ void GuiWindow::updateStatus(const QString &newStatus)
     m_disconnectButton->setEnabled(newStatus.startsWith("Subscribed") || newStatus.startsWith("Connected"));
 }
 
-void GuiWindow::updateData(const QString &newData)
+void GuiWindow::updateSample(const VitalsSample &sample)
 {
-    qDebug() << "Received : " << newData;
-
-    // Data is expected to be a comma-separated string, e.g., "37.5,120"
-    QStringList parts = newData.split(',');
-    if (parts.size() == 2) {
-        bool okT, okHR;
-        float temp = parts[0].toFloat(&okT);
-        float hr = parts[1].toFloat(&okHR);
-
-        if (okT && okHR) {
-            // VITAL: Update the stored patient data with the received BLE values
-            m_babyData.temperature_c = temp;
-            m_babyData.heart_rate_bpm = hr;
-
-            // Update the new Labels with Rich Text for bold values
-            m_tempLabel->setText(QString("Temperature: <br><b>%1 °C</b>").arg(temp, 0, 'f', 1));
-            m_hrLabel->setText(QString("Heart Rate: <br><b>%1 BPM</b>").arg(hr, 0, 'f', 0));
-
-            qDebug() << "Updated Patient Data: Temp =" << m_babyData.temperature_c << ", HR =" << m_babyData.heart_rate_bpm;
-
-        } else {
-            // Handle invalid numeric data
-            m_tempLabel->setText("Temperature: <br><b>ERR</b>");
-            m_hrLabel->setText("Heart Rate: <br><b>ERR</b>");
-            qDebug() << "Invalid numeric BLE Data: " << newData;
-        }
-    } else {
-        // Handle incorrect format or unexpected data
-        m_tempLabel->setText("Temperature: <br><b>WAITING</b>");
-        m_hrLabel->setText("Heart Rate: <br><b>WAITING</b>");
-        qDebug() << "Raw BLE Data: " << newData;
+    // Track how long the sample waited in the queue and whether any went missing
+    const qint64 delayNs = monotonicNowNs() - sample.arrivalNs;
+    if (m_lastSampleSequence != 0 && sample.sequence > m_lastSampleSequence + 1) {
+        m_missedSamples += sample.sequence - m_lastSampleSequence - 1;
+        LOG_WARNING("ui.samples_missed").field("missed", m_missedSamples).field("seq", sample.sequence);
+    }
+    m_lastSampleSequence = sample.sequence;
+    if (delayNs > m_maxDeliveryDelayNs) {
+        m_maxDeliveryDelayNs = delayNs;
+        LOG_DEBUG("ui.delivery_delay_max").field("delay_ms", m_maxDeliveryDelayNs / 1e6);
     }
+
+    // The model inputs are updated by MonitorController; the rollup is kept
+    // on the monotonic clock, like every other sample timing
+    m_rollup.add(sample.arrivalNs / 1000000, sample.temperature_c, sample.heart_rate_bpm);
+
+    // Update the new Labels with Rich Text for bold values
+    setVitalsText(QString("%1 °C").arg(sample.temperature_c, 0, 'f', 1),
+                  QString("%1 BPM").arg(sample.heart_rate_bpm, 0, 'f', 0),
+                  sample.sensorNs);
+    m_latestSensorNs = sample.sensorNs;
+
+    LOG_DEBUG("ui.sample").field("seq", sample.sequence).field("temp_c", sample.temperature_c)
+        .field("hr_bpm", sample.heart_rate_bpm).field("delay_ms", delayNs / 1e6);
 }
 
-/**
- * @brief Runs an inference test using the compiled ONNX Runtime and the model.
- * @return A QString containing the prediction result prefixed with "PREDICTION_LABEL:X" or "ERROR:X" for easy parsing.
- */
-QString GuiWindow::testPrediction() {
-    // --- 1. Define Model and Data Parameters ---
-    // ... (unchanged) ...
-    std::vector<const char*> input_node_names = {
-        "gender", "gestational_age_weeks", "birth_weight_kg",
-        "birth_length_cm", "age_days", "weight_kg",
-        "length_cm", "temperature_c", "heart_rate_bpm"
-    };
-
-    const char* output_node_names[] = {"label", "probabilities"};
-
-    std::vector<int64_t> single_input_shape = {1, 1};
-
-    // Test data
-    std::string gender_str = m_babyData.gender.toStdString();
-    std::vector<float> numeric_values = {
-        m_babyData.gestational_age_weeks,  // gestational_age_weeks
-        m_babyData.birth_weight_kg,   // birth_weight_kg
-        m_babyData.birth_length_cm,  // birth_length_cm
-        m_babyData.age_days,  // age_days
-        m_babyData.weight_kg,   // weight_kg
-        m_babyData.length_cm,  // length_cm
-        m_babyData.temperature_c,  // temperature_c
-        m_babyData.heart_rate_bpm// heart_rate_bpm
-    };
-
-    // --- 2. Initialize ONNX Runtime Environment ---
-    Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "OrtTestPrediction");
-    Ort::SessionOptions session_options;
-
-    // --- 3. Find and Copy Model File (unchanged) ---
-    QString modelFilePath;
-    const QString ASSET_QRC_PATH = ":/health_classifier.onnx";
-
-    QFile assetFile(ASSET_QRC_PATH);
-    if (!assetFile.open(QIODevice::ReadOnly)) {
-        return QString("ERROR:Failed to open asset file: %1").arg(ASSET_QRC_PATH);
+void GuiWindow::setVitalsText(const QString &temperature, const QString &heartRate, qint64 sensorNs)
+{
+    m_pendingTempText = temperature;
+    m_pendingHrText = heartRate;
+    m_pendingSensorNs = sensorNs;
+    m_scheduler->trigger(m_vitalsRefreshTask);
+}
+
+void GuiWindow::refreshVitalsLabels()
+{
+    m_tempTile->setValue(m_pendingTempText);
+    m_hrTile->setValue(m_pendingHrText);
+    // Measured at the label update; the paint follows in the same event loop pass
+    if (m_pendingSensorNs >= 0) {
+        m_sensorToDisplay.record(monotonicNowNs() - m_pendingSensorNs);
+        m_pendingSensorNs = -1;
     }
+}
 
-    QString tempDir = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
-    modelFilePath = tempDir + QDir::separator() + QFileInfo("health_classifier.onnx").fileName();
+void GuiWindow::updateTrends()
+{
+    const qint64 sinceMs = monotonicNowNs() / 1000000 - TREND_WINDOW_MS;
+    const RollupBucket temperature = m_rollup.temperature().summary(TREND_TIER, sinceMs);
+    const RollupBucket heartRate = m_rollup.heartRate().summary(TREND_TIER, sinceMs);
+    // After a gap of an hour or more, the previous figures would be stale
+    m_tempTile->setDetail(temperature.count == 0
+                              ? tr("No data in the last hour")
+                              : tr("Last hour %1 - %2 °C, mean %3")
+                                    .arg(temperature.min, 0, 'f', 1).arg(temperature.max, 0, 'f', 1)
+                                    .arg(temperature.mean(), 0, 'f', 1));
+    m_hrTile->setDetail(heartRate.count == 0
+                            ? tr("No data in the last hour")
+                            : tr("Last hour %1 - %2 BPM, mean %3")
+                                  .arg(heartRate.min, 0, 'f', 0).arg(heartRate.max, 0, 'f', 0)
+                                  .arg(heartRate.mean(), 0, 'f', 0));
+}
 
-    if (!assetFile.copy(modelFilePath)) {
-        return QString("ERROR:Failed to copy asset to temp location: %1").arg(modelFilePath);
-    }
-    assetFile.close();
-
-    // --- 4. Load the Model and Create Session ---
-    try {
-        Ort::Session session(env, modelFilePath.toStdString().c_str(), session_options);
-
-        // --- 5. Create 9 Separate Input Tensors ---
-        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
-        std::vector<Ort::Value> input_tensors;
-
-        static const OrtApi* ortApi = OrtGetApiBase()->GetApi(ORT_API_VERSION);
-        Ort::AllocatorWithDefaultOptions default_allocator;
-
-        // 1. Create the 'gender' string tensor
-        const char* gender_c_str[] = {gender_str.c_str()};
-        OrtValue* gender_ort_value = nullptr;
-
-        OrtStatus* status = ortApi->CreateTensorAsOrtValue(
-            default_allocator,
-            single_input_shape.data(),
-            single_input_shape.size(),
-            ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING,
-            &gender_ort_value
-            );
-
-        if (status) {
-            QString error_msg = QString("Failed to create empty string tensor structure: %1").arg(ortApi->GetErrorMessage(status));
-            ortApi->ReleaseStatus(status);
-            throw Ort::Exception(error_msg.toStdString().c_str(), ORT_FAIL);
-        }
-
-        status = ortApi->FillStringTensor(
-            gender_ort_value,
-            gender_c_str,
-            1
-            );
-
-        if (status) {
-            QString error_msg = QString("Failed to fill string tensor data: %1").arg(ortApi->GetErrorMessage(status));
-            ortApi->ReleaseStatus(status);
-            ortApi->ReleaseValue(gender_ort_value);
-            throw Ort::Exception(error_msg.toStdString().c_str(), ORT_FAIL);
-        }
-
-        input_tensors.emplace_back(Ort::Value(gender_ort_value));
-
-        // 2. Create the 8 float tensors
-        for (float val : numeric_values) {
-            float* buffer = new float[1];
-            buffer[0] = val;
-
-            input_tensors.emplace_back(
-                Ort::Value::CreateTensor<float>(
-                    memory_info,
-                    buffer,
-                    1,
-                    single_input_shape.data(),
-                    single_input_shape.size()
-                    )
-                );
-        }
-
-        // --- 6. Run Inference ---
-        auto output_tensors = session.Run(
-            Ort::RunOptions{nullptr},
-            input_node_names.data(),
-            input_tensors.data(),
-            input_tensors.size(),
-            output_node_names,
-            2
-            );
-
-        // --- 7. Process Output ---
-        int64_t predicted_label = output_tensors[0].GetTensorData<int64_t>()[0];
-        const float* probabilities = output_tensors[1].GetTensorData<float>();
-        size_t num_classes = output_tensors[1].GetTensorTypeAndShapeInfo().GetShape()[1];
-
-        QString probabilityString = "";
-        for (size_t i = 0; i < num_classes; ++i) {
-            probabilityString += QString("Class %1: %2 | ").arg(i).arg(probabilities[i], 0, 'f', 4);
-        }
-
-        // --- 8. Cleanup and Return Result ---
-        QFile::remove(modelFilePath);
-
-        // MODIFIED RETURN FORMAT: Prefix with the predicted label for easy parsing in the slot
-        return QString("PREDICTION_LABEL:%1 | Scores: %2 | Raw Data: Temp:%3, HR:%4")
-            .arg(predicted_label)
-            .arg(probabilityString)
-            .arg(m_babyData.temperature_c, 0, 'f', 1)
-            .arg(m_babyData.heart_rate_bpm, 0, 'f', 0);
-
-
-    } catch (const Ort::Exception& e) {
-        QFile::remove(modelFilePath);
-        // MODIFIED ERROR RETURN: Prefix with ERROR:
-        return QString("ERROR:ONNX Runtime Error: %1").arg(e.what());
-    } catch (const std::exception& e) {
-        QFile::remove(modelFilePath);
-        // MODIFIED ERROR RETURN: Prefix with ERROR:
-        return QString("ERROR:Standard C++ Error: %1").arg(e.what());
+void GuiWindow::rejectSample(SampleRejection reason, const QString &rawData)
+{
+    // BleClient already classified the payload; nothing is re-parsed here
+    switch (reason) {
+    case SampleRejection::NotNumeric:
+        // Handle invalid numeric data
+        setVitalsText("ERR", "ERR");
+        LOG_DEBUG("ui.sample_rejected").field("reason", "not_numeric").field("raw", rawData);
+        break;
+    case SampleRejection::OutOfRange:
+        // A sensor fault rather than a reading
+        setVitalsText("ERR", "ERR");
+        LOG_DEBUG("ui.sample_rejected").field("reason", "out_of_range").field("raw", rawData);
+        break;
+    case SampleRejection::Format:
+        // Handle incorrect format or unexpected data
+        setVitalsText("WAITING", "WAITING");
+        LOG_DEBUG("ui.sample_rejected").field("reason", "format").field("raw", rawData);
+        break;
     }
 }
 
-void GuiWindow::onTestButtonClicked() {
-
-    QString result = testPrediction();
-
-    qDebug() << "Prediction Result:" << result;
-
-    // --- Prediction Parsing and Label Update Logic ---
-    if (result.startsWith("ERROR:")) {
-        // Handle Error Case
-        m_predictionResultLabel->setText(QString("❌ **Prediction Failed**<br>Details: %1").arg(result.mid(6)));
-        m_predictionResultLabel->setStyleSheet("QLabel { background-color: #FEE2E2; border-radius: 8px; padding: 10px; font-size: 18px; font-weight: bold; color: #991B1B; border: 2px solid #FCA5A5; margin: 10px; }");
-        setNotification("Prediction failed: Check debug logs.");
-    } else if (result.startsWith("PREDICTION_LABEL:")) {
-        // Handle Success Case
-        QString labelString = result.mid(result.indexOf(':') + 1, 1); // Extract the single digit label (0 or 1)
-        int predictedLabel = labelString.toInt();
-
-        QString message;
-        QString style;
-
-        if (predictedLabel == 1) {
-            // Class 1: At Risk (Warning/Danger Colors)
-            message = "⚠️ **STATUS: AT RISK**";
-            style = "QLabel { background-color: #FFFBEB; border-radius: 8px; padding: 10px; font-size: 18px; font-weight: bold; color: #92400E; border: 2px solid #FCD34D; margin: 10px; }";
-            setNotification("Warning: Baby predicted to be AT RISK (Label 1).");
-        } else {
-            // Class 0: Not At Risk (Success/Safe Colors)
-            message = "✅ **STATUS: NOT AT RISK**";
-            style = "QLabel { background-color: #ECFDF5; border-radius: 8px; padding: 10px; font-size: 18px; font-weight: bold; color: #065F46; border: 2px solid #A7F3D0; margin: 10px; }";
-            setNotification("Status normal: Baby predicted NOT AT RISK (Label 0).");
-        }
-
-        m_predictionResultLabel->setText(message);
-        m_predictionResultLabel->setStyleSheet(style);
+void GuiWindow::updateRiskState(MonitorController::RiskState state)
+{
+    switch (state) {
+    case MonitorController::RiskState::Unknown:
+        m_predictionTile->setValue(tr("Not Run"));
+        m_predictionTile->setTileStyle(TileStyle::neutral());
+        break;
+    case MonitorController::RiskState::Failed:
+        m_predictionTile->setValue("❌ Prediction Failed");
+        m_predictionTile->setDetail(QString("Details: %1").arg(m_monitor->lastPrediction().error));
+        m_predictionTile->setTileStyle(TileStyle::failure());
+        return;
+    case MonitorController::RiskState::AtRisk:
+        // At Risk (Warning/Danger Colors)
+        m_predictionTile->setValue("⚠️ STATUS: AT RISK");
+        m_predictionTile->setTileStyle(TileStyle::atRisk());
+        break;
+    case MonitorController::RiskState::Normal:
+        // Not At Risk (Success/Safe Colors)
+        m_predictionTile->setValue("✅ STATUS: NOT AT RISK");
+        m_predictionTile->setTileStyle(TileStyle::safe());
+        break;
     }
-    // -------------------------------------------------------------------
+    m_predictionTile->setDetail(QString());
+}
 
-    emit notificationChanged();
+void GuiWindow::recordPrediction(const PredictionResult &)
+{
+    if (m_latestSensorNs >= 0)
+        m_sensorToPrediction.record(monotonicNowNs() - m_latestSensorNs);
 }
 
-void GuiWindow::handleFormData(const BabyData& data)
+void GuiWindow::updateScanButtonState(bool isScanning)
 {
-    m_babyData = data;
-
-    // Debug output
-    qDebug() << "--- Patient Data Stored Successfully ---";
-    qDebug() << "  Gender:" << m_babyData.gender;
-    qDebug() << "  GA (weeks):" << m_babyData.gestational_age_weeks;
-    qDebug() << "  Birth Weight (kg):" << m_babyData.birth_weight_kg;
-    qDebug() << "  Birth Length (cm):" << m_babyData.birth_length_cm;
-    qDebug() << "  Age (days):" << m_babyData.age_days;
-    qDebug() << "  Current Weight (kg):" << m_babyData.weight_kg;
-    qDebug() << "  Current Length (cm):" << m_babyData.length_cm;
-    qDebug() << "  Temperature (C, BLE init):" << m_babyData.temperature_c;
-    qDebug() << "  Heart Rate (bpm, BLE init):" << m_babyData.heart_rate_bpm;
-    qDebug() << "------------------------------------------";
-
-    // Show the main BLE window
-    this->show();
+    m_scanButton->setEnabled(!isScanning);
+    m_scanButton->setText(isScanning ? tr("Scanning...") : tr("Start Scan"));
+}
 
+void GuiWindow::updateLinkStats(const LinkStatsSnapshot &stats)
+{
+    m_diagnosticsLabel->setText(stats.summary() + "\n" + stats.connectTimingText() + "\n" + stats.histogramText()
+                                + "\n" + stats.clock.summary());
 }
 
-void GuiWindow::setNotification(const QString &notification)
+void GuiWindow::updateLatencyStats()
 {
-    if (m_notification == notification)
+    const LatencyPercentiles display = m_sensorToDisplay.percentiles();
+    const LatencyPercentiles prediction = m_sensorToPrediction.percentiles();
+    if (display.count == 0 && prediction.count == 0)
         return;
-
-    //! [notification changed signal]
-    m_notification = notification;
-    emit notificationChanged();
-    //! [notification changed signal]
+    m_latencyLabel->setText(QString("Sensor -> display %1\nSensor -> prediction %2")
+                                .arg(display.text(), prediction.text()));
+    LOG_INFO("latency.e2e").field("display_p50_ms", display.p50Ms).field("display_p99_ms", display.p99Ms)
+        .field("prediction_p50_ms", prediction.p50Ms).field("prediction_p99_ms", prediction.p99Ms)
+        .field("samples", display.count);
 }
 
-QString GuiWindow::notification() const
+void GuiWindow::updateSchedulerStats(const TickStats &stats)
 {
-    return m_notification;
+    m_schedulerLabel->setText(stats.summary());
 }
 
-//! [Send notification message to Java]
-void GuiWindow::updateAndroidNotification()
+void GuiWindow::updateFrame()
 {
-    QJniObject javaNotification = QJniObject::fromString(m_notification);
-    QJniObject::callStaticMethod<void>(
-        "org/qtproject/example/androidnotifier/NotificationClient",
-        "notify",
-        "(Landroid/content/Context;Ljava/lang/String;)V",
-        QNativeInterface::QAndroidApplication::context(),
-        javaNotification.object<jstring>());
+    QImage image;
+    FrameTiming timing;
+    if (!m_latestFrame.take(image, timing))
+        return;
+
+    // Decoding already happened off this thread; only the scaled blit is left
+    m_cameraLabel->setPixmap(QPixmap::fromImage(image).scaled(
+        m_cameraLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
+
+    const double transferMs = (timing.completeNs - timing.firstChunkNs) / 1e6;
+    const double latencyMs = (monotonicNowNs() - timing.firstChunkNs) / 1e6;
+    m_cameraStatsLabel->setText(QString("Frame %1 | %2 fps | Transfer: %3 ms | First chunk to display: %4 ms | Dropped: %5 | Skipped: %6")
+                                    .arg(timing.frameId)
+                                    .arg(timing.framesPerSecond, 0, 'f', 1)
+                                    .arg(transferMs, 0, 'f', 1)
+                                    .arg(latencyMs, 0, 'f', 1)
+                                    .arg(timing.droppedFrames)
+                                    .arg(m_latestFrame.skippedFrames()));
 }
-void GuiWindow::updateScanButtonState()
+
+void GuiWindow::updateMotion(const MotionReading &reading)
 {
-    // The BleClient* m_bleClient must be available to call isScanning()
-    bool isScanning = m_bleClient->isScanning();
-    m_scanButton->setEnabled(!isScanning);
-    m_scanButton->setText(isScanning ? tr("Scanning...") : tr("Start Scan"));
+    m_motionLabel->setText(QString("Motion: %1 (%2% of pixels) | Breathing: %3 (periodicity %4)")
+                               .arg(reading.motionLevel, 0, 'f', 2)
+                               .arg(reading.changedFraction * 100.0, 0, 'f', 1)
+                               .arg(reading.breathingDetected ? QString("%1 /min").arg(reading.breathingRateBpm, 0, 'f', 0)
+                                                              : QString("not detected"))
+                               .arg(reading.periodicity, 0, 'f', 2));
 }
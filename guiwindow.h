@@ -16,50 +16,92 @@
 #include <onnxruntime/core/session/onnxruntime_cxx_api.h>
 
 
-#include "initialformwindow.h"
+#include "monitorcontroller.h"
+#include "predictionresult.h"
+#include "vitalsrollup.h"
+#include "latencywindow.h"
+#include "vitalstile.h"
+#include "motiondetector.h"
+#include "tickscheduler.h"
 
 class GuiWindow : public QWidget
 {
     Q_OBJECT
 
 public:
-    explicit GuiWindow(BleClient *client, QWidget *parent = nullptr);
+    // Presents the state of `monitor`; predictions and alerts live there
+    GuiWindow(BleClient *client, MotionMonitor *motion, MonitorController *monitor, TickScheduler *scheduler,
+              QWidget *parent = nullptr);
     ~GuiWindow() override = default;
 
-    void setNotification(const QString &notification);
-    QString notification() const;
-    void handleFormData(const BabyData& data);
-
-signals:
-    void notificationChanged();
-
 private slots:
     void updateStatus(const QString &newStatus);
-    void updateData(const QString &newData);
-    void updateScanButtonState();
-    void onTestButtonClicked();
-    void updateAndroidNotification();
+    void updateSample(const VitalsSample &sample);
+    void rejectSample(SampleRejection reason, const QString &rawData);
+    void updateScanButtonState(bool isScanning);
+    void updateLinkStats(const LinkStatsSnapshot &stats);
+    void updateFrame();
+    void updateMotion(const MotionReading &reading);
+    void updateSchedulerStats(const TickStats &stats);
+    void updateLatencyStats();
+    void updateRiskState(MonitorController::RiskState state);
+    void recordPrediction(const PredictionResult &result);
 
 private:
     BleClient *m_bleClient;
-    BabyData m_babyData;
+    MotionMonitor *m_motionMonitor;
+    MonitorController *m_monitor;
+    TickScheduler *m_scheduler;
 
     // UI Widgets
     QLabel *m_statusLabel;
-    QLabel *m_tempLabel;
-    QLabel *m_hrLabel;
-    QLabel *m_predictionResultLabel; // <-- ADDED
+    VitalsTile *m_tempTile;
+    VitalsTile *m_hrTile;
+    VitalsTile *m_predictionTile;
+    QLabel *m_diagnosticsLabel;
+    QLabel *m_schedulerLabel;
+    QLabel *m_latencyLabel;
+    QLabel *m_cameraLabel;
+    QLabel *m_cameraStatsLabel;
+    QLabel *m_motionLabel;
     QPushButton *m_scanButton;
     QPushButton *m_disconnectButton;
     QPushButton *m_testButton;
 
-    QTimer *m_predictionTimer;
+    // Scheduler tasks: coalesced label repaints (a burst of samples costs one
+    // wake-up) and the background reports
+    int m_vitalsRefreshTask = -1;
+    int m_latencyTask = -1;
+    int m_trendTask = -1;
+    QString m_pendingTempText;
+    QString m_pendingHrText;
+
+    // End-to-end age of the readings on the device's clock (see ClockSync):
+    // sensor to label update, and sensor to prediction result
+    qint64 m_pendingSensorNs = -1;
+    qint64 m_latestSensorNs = -1;
+    LatencyWindow m_sensorToDisplay;
+    LatencyWindow m_sensorToPrediction;
+
+    // Fixed-size per second / minute / hour trends for the whole session,
+    // keyed by monotonic arrival time; the last hour is shown under the tiles
+    VitalsRollup m_rollup;
+
+    // Newest decoded camera frame; a slow repaint skips frames instead of
+    // queueing them
+    LatestFrame m_latestFrame;
 
-    QString m_notification;
+    // Delivery health of the BLE thread -> UI thread hand-off
+    quint64 m_lastSampleSequence = 0;
+    quint64 m_missedSamples = 0;
+    qint64 m_maxDeliveryDelayNs = 0;
 
     void setupUi();
     void setupConnections();
-    QString testPrediction(); // Return string modified for easier parsing
+    void setupTasks();
+    void setVitalsText(const QString &temperature, const QString &heartRate, qint64 sensorNs = -1);
+    void refreshVitalsLabels();
+    void updateTrends();
 };
 
 #endif // GUIWINDOW_H
@@ -0,0 +1,172 @@
+#include "healthpredictor.h"
+
+#include <QString>
+
+namespace {
+
+const std::array<int64_t, 2> SINGLE_INPUT_SHAPE = {1, 1};
+
+Ort::Value createGenderTensor(const std::string &gender)
+{
+    static const OrtApi* ortApi = OrtGetApiBase()->GetApi(ORT_API_VERSION);
+    Ort::AllocatorWithDefaultOptions default_allocator;
+
+    const char* gender_c_str[] = {gender.c_str()};
+    OrtValue* gender_ort_value = nullptr;
+
+    OrtStatus* status = ortApi->CreateTensorAsOrtValue(
+        default_allocator,
+        SINGLE_INPUT_SHAPE.data(),
+        SINGLE_INPUT_SHAPE.size(),
+        ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING,
+        &gender_ort_value
+        );
+
+    if (status) {
+        QString error_msg = QString("Failed to create empty string tensor structure: %1").arg(ortApi->GetErrorMessage(status));
+        ortApi->ReleaseStatus(status);
+        throw Ort::Exception(error_msg.toStdString().c_str(), ORT_FAIL);
+    }
+
+    status = ortApi->FillStringTensor(
+        gender_ort_value,
+        gender_c_str,
+        1
+        );
+
+    if (status) {
+        QString error_msg = QString("Failed to fill string tensor data: %1").arg(ortApi->GetErrorMessage(status));
+        ortApi->ReleaseStatus(status);
+        ortApi->ReleaseValue(gender_ort_value);
+        throw Ort::Exception(error_msg.toStdString().c_str(), ORT_FAIL);
+    }
+
+    return Ort::Value(gender_ort_value);
+}
+
+} // namespace
+
+const std::array<const char *, HealthPredictor::OutputCount> &HealthPredictor::outputNames()
+{
+    static const std::array<const char *, OutputCount> names = {"label", "probabilities"};
+    return names;
+}
+
+HealthPredictor::HealthPredictor(Ort::Env &env, const std::string &modelPath,
+                                 const Ort::SessionOptions &options)
+    : m_session(env, modelPath.c_str(), options)
+{
+}
+
+void HealthPredictor::validateSignature()
+{
+    Ort::AllocatorWithDefaultOptions allocator;
+
+    if (m_session.GetInputCount() != InputCount) {
+        throw Ort::Exception(QString("Model has %1 inputs, expected %2")
+                                 .arg(m_session.GetInputCount()).arg(InputCount).toStdString(), ORT_INVALID_GRAPH);
+    }
+
+    // Model inputs may come in any order; each must match one schema entry
+    std::array<bool, InputCount> seen = {};
+    for (size_t i = 0; i < InputCount; ++i) {
+        const std::string name = m_session.GetInputNameAllocated(i, allocator).get();
+        const size_t index = featureschema::indexOf(name.c_str());
+        if (index == InputCount)
+            throw Ort::Exception(QString("Unexpected model input '%1'").arg(name.c_str()).toStdString(), ORT_INVALID_GRAPH);
+        if (seen[index])
+            throw Ort::Exception(QString("Model input '%1' appears twice").arg(name.c_str()).toStdString(), ORT_INVALID_GRAPH);
+        seen[index] = true;
+
+        const Ort::TypeInfo typeInfo = m_session.GetInputTypeInfo(i);
+        const auto info = typeInfo.GetTensorTypeAndShapeInfo();
+        const ONNXTensorElementDataType type = info.GetElementType();
+        const ONNXTensorElementDataType wanted = (index == featureschema::GenderIndex) ? ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING
+                                                                                       : ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+        if (type != wanted)
+            throw Ort::Exception(QString("Model input '%1' has element type %2, expected %3")
+                                     .arg(name.c_str()).arg(int(type)).arg(int(wanted)).toStdString(), ORT_INVALID_GRAPH);
+
+        // Every input is bound as a [1, 1] tensor; symbolic dimensions (-1) are fine
+        for (int64_t dimension : info.GetShape()) {
+            if (dimension != 1 && dimension != -1)
+                throw Ort::Exception(QString("Model input '%1' is not a single value per row")
+                                         .arg(name.c_str()).toStdString(), ORT_INVALID_GRAPH);
+        }
+    }
+
+    for (const char *output : outputNames()) {
+        bool found = false;
+        for (size_t i = 0; i < m_session.GetOutputCount() && !found; ++i)
+            found = (m_session.GetOutputNameAllocated(i, allocator).get() == std::string(output));
+        if (!found)
+            throw Ort::Exception(QString("Model output '%1' is missing").arg(output).toStdString(), ORT_INVALID_GRAPH);
+    }
+}
+
+int64_t HealthPredictor::predict(const HealthInputs &inputs, std::vector<float> *probabilities)
+{
+    // --- Run Inference ---
+    auto output_tensors = m_session.Run(
+        Ort::RunOptions{nullptr},
+        inputNames().data(),
+        inputs.tensors(),
+        inputs.size(),
+        outputNames().data(),
+        OutputCount
+        );
+
+    // --- Process Output ---
+    const int64_t predicted_label = output_tensors[0].GetTensorData<int64_t>()[0];
+    if (probabilities) {
+        const float* scores = output_tensors[1].GetTensorData<float>();
+        const size_t num_classes = output_tensors[1].GetTensorTypeAndShapeInfo().GetShape()[1];
+        probabilities->assign(scores, scores + num_classes);
+    }
+    return predicted_label;
+}
+
+int64_t HealthPredictor::predict(const BabyData &data, std::vector<float> *probabilities)
+{
+    HealthInputs inputs;
+    inputs.setProfile(data);
+    return predict(inputs, probabilities);
+}
+
+// --- HealthInputs ---
+
+HealthInputs::HealthInputs()
+{
+    static const Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+
+    // Slot 0 is the gender string tensor, filled by setGender(); the float
+    // tensors follow in schema order, one per value slot
+    m_tensors.reserve(HealthPredictor::InputCount);
+    m_tensors.emplace_back(nullptr);
+    for (float &val : m_values) {
+        m_tensors.emplace_back(
+            Ort::Value::CreateTensor<float>(
+                memory_info,
+                &val,
+                1,
+                SINGLE_INPUT_SHAPE.data(),
+                SINGLE_INPUT_SHAPE.size()
+                )
+            );
+    }
+    setGender(BabyData().gender);
+}
+
+void HealthInputs::setGender(const QString &gender)
+{
+    if (!m_gender.isNull() && gender == m_gender)
+        return;
+    m_tensors[0] = createGenderTensor(gender.toStdString());
+    m_gender = gender;
+}
+
+void HealthInputs::setProfile(const BabyData &profile)
+{
+    setGender(profile.gender);
+    featureschema::assemble(profile, m_values);
+}
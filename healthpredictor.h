@@ -0,0 +1,86 @@
+#ifndef HEALTHPREDICTOR_H
+#define HEALTHPREDICTOR_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <onnxruntime/core/session/onnxruntime_cxx_api.h>
+
+#include "babydata.h"
+#include "featureschema.h"
+
+// The 9 input tensors of the classifier, bound once over stable buffers.
+//
+// The 8 float tensors wrap m_values directly, so updating a value is a plain
+// store and never reallocates. The gender string tensor is only rebuilt when
+// the gender actually changes. Not copyable: the tensors point into this object.
+class HealthInputs
+{
+public:
+    HealthInputs();
+    HealthInputs(const HealthInputs &) = delete;
+    HealthInputs &operator=(const HealthInputs &) = delete;
+
+    // Writes every input: the gender, the form values and the vitals
+    void setProfile(const BabyData &profile);
+
+    // Per-sample update of the temperature_c and heart_rate_bpm buffers
+    void setVitals(float temperature_c, float heart_rate_bpm)
+    {
+        m_values[TemperatureIndex] = temperature_c;
+        m_values[HeartRateIndex] = heart_rate_bpm;
+    }
+
+    // In the order of HealthPredictor::inputNames()
+    const Ort::Value *tensors() const { return m_tensors.data(); }
+    size_t size() const { return m_tensors.size(); }
+
+private:
+    // Positions in m_values (inputNames() minus the leading "gender")
+    static constexpr size_t TemperatureIndex = featureschema::slotOf("temperature_c");
+    static constexpr size_t HeartRateIndex = featureschema::slotOf("heart_rate_bpm");
+
+    std::array<float, featureschema::NumericCount> m_values = {};
+    std::vector<Ort::Value> m_tensors;
+    QString m_gender;
+
+    void setGender(const QString &gender);
+};
+
+// Wraps one ONNX Runtime session of health_classifier.onnx (or any model with
+// the same 9-input / 2-output signature). Shared by MonitorController and the
+// command-line tools. All methods throw Ort::Exception on failure.
+class HealthPredictor
+{
+public:
+    static constexpr size_t InputCount = featureschema::InputCount;
+    static constexpr size_t OutputCount = 2;
+
+    // Model input names, in the order the tensors are bound (see featureschema.h)
+    static const std::array<const char *, InputCount> &inputNames() { return featureschema::NAMES; }
+    static const std::array<const char *, OutputCount> &outputNames();
+
+    HealthPredictor(Ort::Env &env, const std::string &modelPath,
+                    const Ort::SessionOptions &options = Ort::SessionOptions());
+
+    // Checks the session's inputs against the feature schema (every input
+    // present once, string gender, float for the rest, one value per tensor)
+    // and the outputs against outputNames()
+    void validateSignature();
+
+    // Runs one inference on pre-bound inputs and returns the predicted label.
+    // The class probabilities are written to `probabilities` when it is not null.
+    int64_t predict(const HealthInputs &inputs, std::vector<float> *probabilities = nullptr);
+
+    // Convenience overload that binds a temporary HealthInputs for `data`
+    int64_t predict(const BabyData &data, std::vector<float> *probabilities = nullptr);
+
+    // For memory statistics (see InferenceMemory)
+    const Ort::Session &session() const { return m_session; }
+
+private:
+    Ort::Session m_session;
+};
+
+#endif // HEALTHPREDICTOR_H
@@ -0,0 +1,141 @@
+#include "inferencememory.h"
+
+#include <QByteArray>
+
+#include <cstring>
+
+#include "processmemory.h"
+
+namespace {
+
+// kSameAsRequested: grow the arena by what is needed, not by doubling
+const int ARENA_EXTEND_SAME_AS_REQUESTED = 1;
+const int ARENA_INITIAL_CHUNK_BYTES = 256 * 1024;
+
+} // namespace
+
+// --- MemoryBudget ---
+
+bool MemoryBudget::parse(const QString &spec, MemoryBudget &budget)
+{
+    const QString mode = spec.section(':', 0, 0).trimmed().toLower();
+    if (mode == "default") {
+        budget.arena = Arena::Default;
+        return true;
+    }
+    if (mode == "off") {
+        budget.arena = Arena::Disabled;
+        return true;
+    }
+    if (mode != "limited")
+        return false;
+
+    budget.arena = Arena::Limited;
+    const QString limit = spec.section(':', 1, 1).trimmed();
+    if (!limit.isEmpty()) {
+        bool ok = false;
+        const int megabytes = limit.toInt(&ok);
+        if (!ok || megabytes <= 0)
+            return false;
+        budget.arenaLimitBytes = size_t(megabytes) * 1024 * 1024;
+    }
+    return true;
+}
+
+MemoryBudget MemoryBudget::fromArguments(const QStringList &arguments)
+{
+    MemoryBudget budget;
+    const int index = arguments.indexOf("--arena");
+    if (index >= 0 && !parse(arguments.value(index + 1), budget))
+        budget = MemoryBudget();
+    return budget;
+}
+
+QString MemoryBudget::toString() const
+{
+    switch (arena) {
+    case Arena::Default: return "default";
+    case Arena::Disabled: return "off";
+    case Arena::Limited: break;
+    }
+    return QString("limited:%1").arg(arenaLimitBytes / (1024 * 1024));
+}
+
+void MemoryBudget::registerSharedAllocator(Ort::Env &env) const
+{
+    if (arena == Arena::Default)
+        return;
+
+    if (arena == Arena::Limited) {
+        const Ort::MemoryInfo info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        const Ort::ArenaCfg config(arenaLimitBytes, ARENA_EXTEND_SAME_AS_REQUESTED, ARENA_INITIAL_CHUNK_BYTES, -1);
+        env.CreateAndRegisterAllocator(info, config);
+    } else {
+        const Ort::MemoryInfo info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+        env.CreateAndRegisterAllocator(info, nullptr);
+    }
+}
+
+Ort::SessionOptions MemoryBudget::sessionOptions(int intraOpThreads) const
+{
+    Ort::SessionOptions options;
+    options.SetIntraOpNumThreads(intraOpThreads);
+    if (arena != Arena::Default)
+        options.AddConfigEntry("session.use_env_allocators", "1");
+    if (arena == Arena::Disabled) {
+        options.DisableCpuMemArena();
+        // Memory patterns preallocate one block per planned shape
+        options.DisableMemPattern();
+    }
+    return options;
+}
+
+// --- InferenceMemory ---
+
+InferenceMemory InferenceMemory::sample(const Ort::Session &session)
+{
+    InferenceMemory memory;
+    memory.rssKb = currentRssKb();
+
+#if ORT_API_VERSION >= 23
+    try {
+        const Ort::MemoryInfo info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        const Ort::Allocator allocator(session, info);
+
+        OrtKeyValuePairs *stats = nullptr;
+        Ort::ThrowOnError(Ort::GetApi().AllocatorGetStats(allocator, &stats));
+        const char *const *keys = nullptr;
+        const char *const *values = nullptr;
+        size_t count = 0;
+        Ort::GetApi().GetKeyValuePairs(stats, &keys, &values, &count);
+        for (size_t i = 0; i < count; ++i) {
+            const qint64 value = QByteArray(values[i]).toLongLong();
+            if (std::strcmp(keys[i], "InUse") == 0)
+                memory.arenaInUseBytes = value;
+            else if (std::strcmp(keys[i], "TotalAllocated") == 0)
+                memory.arenaReservedBytes = value;
+            else if (std::strcmp(keys[i], "MaxInUse") == 0)
+                memory.arenaPeakBytes = value;
+            else if (std::strcmp(keys[i], "Limit") == 0)
+                memory.arenaLimitBytes = value;
+        }
+        Ort::GetApi().ReleaseKeyValuePairs(stats);
+        memory.arenaValid = count > 0;
+    } catch (const Ort::Exception &) {
+        // No arena (Disabled budget) or no statistics for this allocator
+    }
+#else
+    Q_UNUSED(session);
+#endif
+    return memory;
+}
+
+QString InferenceMemory::summary() const
+{
+    QString text = QString("RSS %1 KB").arg(rssKb);
+    if (arenaValid) {
+        text += QString(" | arena in use %1 KB, reserved %2 KB, peak %3 KB")
+                    .arg(arenaInUseBytes / 1024).arg(arenaReservedBytes / 1024).arg(arenaPeakBytes / 1024);
+    }
+    return text;
+}
@@ -0,0 +1,52 @@
+#ifndef INFERENCEMEMORY_H
+#define INFERENCEMEMORY_H
+
+#include <QString>
+#include <QStringList>
+#include <cstddef>
+
+#include <onnxruntime/core/session/onnxruntime_cxx_api.h>
+
+// How ONNX Runtime may use memory for CPU inference.
+//
+// Default keeps ONNX Runtime's per-session growing arena. Limited and
+// Disabled register one CPU allocator on the Ort::Env, which every session
+// created with sessionOptions() uses instead of its own, so a model swap
+// or the command-line tools never hold two arenas. Limited caps that arena
+// (an allocation beyond the cap fails the inference instead of growing
+// the process); Disabled allocates straight from the heap.
+struct MemoryBudget {
+    enum class Arena { Default, Limited, Disabled };
+
+    Arena arena = Arena::Default;
+    // Cap for "limited" without a size
+    size_t arenaLimitBytes = 16 * 1024 * 1024;
+
+    // "default", "limited[:MB]" or "off"; returns false for anything else
+    static bool parse(const QString &spec, MemoryBudget &budget);
+    // From "--arena <spec>" in `arguments`, Default otherwise
+    static MemoryBudget fromArguments(const QStringList &arguments);
+    QString toString() const;
+
+    // Call once per Env, before creating sessions (no-op for Default)
+    void registerSharedAllocator(Ort::Env &env) const;
+    Ort::SessionOptions sessionOptions(int intraOpThreads = 1) const;
+};
+
+// Process and arena memory at one point in time
+struct InferenceMemory {
+    qint64 rssKb = 0;
+
+    // From the CPU allocator the session uses; invalid if the ONNX Runtime
+    // build cannot report allocator statistics
+    bool arenaValid = false;
+    qint64 arenaInUseBytes = 0;
+    qint64 arenaReservedBytes = 0;
+    qint64 arenaPeakBytes = 0;
+    qint64 arenaLimitBytes = 0;
+
+    static InferenceMemory sample(const Ort::Session &session);
+    QString summary() const;
+};
+
+#endif // INFERENCEMEMORY_H
@@ -4,6 +4,21 @@
 #include <QMessageBox>
 #include <QDoubleValidator> // Added this required header for completeness
 
+#include "featureschema.h"
+
+namespace {
+
+// Range and decimals come from the feature schema; Index is checked at compile time
+template <size_t Index>
+QDoubleValidator *schemaValidator(QObject *parent)
+{
+    static_assert(Index < featureschema::InputCount, "not a model input");
+    constexpr FeatureSpec spec = featureschema::INPUTS[Index];
+    return new QDoubleValidator(spec.minimum, spec.maximum, spec.decimals, parent);
+}
+
+} // namespace
+
 InitialFormWindow::InitialFormWindow(QWidget *parent)
     : QWidget(parent)
 {
@@ -40,42 +55,42 @@ void InitialFormWindow::setupUi()
     // 2. Gestational Age (float)
     m_gaWeeksInput = new QLineEdit(this);
     m_gaWeeksInput->setPlaceholderText(tr("e.g., 38.5"));
-    m_gaWeeksInput->setValidator(new QDoubleValidator(0.0, 50.0, 1, m_gaWeeksInput));
+    m_gaWeeksInput->setValidator(schemaValidator<featureschema::indexOf("gestational_age_weeks")>(m_gaWeeksInput));
     formLayout->addRow(tr("GA (Weeks):"), m_gaWeeksInput);
     connect(m_gaWeeksInput, &QLineEdit::textChanged, this, &InitialFormWindow::forceUpdate); // <-- WORKAROUND
 
     // 3. Birth Weight (float)
     m_birthWeightInput = new QLineEdit(this);
     m_birthWeightInput->setPlaceholderText(tr("e.g., 3.2"));
-    m_birthWeightInput->setValidator(new QDoubleValidator(0.0, 10.0, 2, m_birthWeightInput));
+    m_birthWeightInput->setValidator(schemaValidator<featureschema::indexOf("birth_weight_kg")>(m_birthWeightInput));
     formLayout->addRow(tr("Birth Weight (kg):"), m_birthWeightInput);
     connect(m_birthWeightInput, &QLineEdit::textChanged, this, &InitialFormWindow::forceUpdate); // <-- WORKAROUND
 
     // 4. Birth Length (float)
     m_birthLengthInput = new QLineEdit(this);
     m_birthLengthInput->setPlaceholderText(tr("e.g., 50.0"));
-    m_birthLengthInput->setValidator(new QDoubleValidator(0.0, 100.0, 2, m_birthLengthInput));
+    m_birthLengthInput->setValidator(schemaValidator<featureschema::indexOf("birth_length_cm")>(m_birthLengthInput));
     formLayout->addRow(tr("Birth Length (cm):"), m_birthLengthInput);
     connect(m_birthLengthInput, &QLineEdit::textChanged, this, &InitialFormWindow::forceUpdate); // <-- WORKAROUND
 
     // 5. Age (float, days)
     m_ageDaysInput = new QLineEdit(this);
     m_ageDaysInput->setPlaceholderText(tr("e.g., 15"));
-    m_ageDaysInput->setValidator(new QDoubleValidator(0.0, 1000.0, 0, m_ageDaysInput));
+    m_ageDaysInput->setValidator(schemaValidator<featureschema::indexOf("age_days")>(m_ageDaysInput));
     formLayout->addRow(tr("Age (days):"), m_ageDaysInput);
     connect(m_ageDaysInput, &QLineEdit::textChanged, this, &InitialFormWindow::forceUpdate); // <-- WORKAROUND
 
     // 6. Current Weight (float)
     m_weightInput = new QLineEdit(this);
     m_weightInput->setPlaceholderText(tr("e.g., 3.5"));
-    m_weightInput->setValidator(new QDoubleValidator(0.0, 10.0, 2, m_weightInput));
+    m_weightInput->setValidator(schemaValidator<featureschema::indexOf("weight_kg")>(m_weightInput));
     formLayout->addRow(tr("Current Weight (kg):"), m_weightInput);
     connect(m_weightInput, &QLineEdit::textChanged, this, &InitialFormWindow::forceUpdate); // <-- WORKAROUND
 
     // 7. Current Length (float)
     m_lengthInput = new QLineEdit(this);
     m_lengthInput->setPlaceholderText(tr("e.g., 52.0"));
-    m_lengthInput->setValidator(new QDoubleValidator(0.0, 100.0, 2, m_lengthInput));
+    m_lengthInput->setValidator(schemaValidator<featureschema::indexOf("length_cm")>(m_lengthInput));
     formLayout->addRow(tr("Current Length (cm):"), m_lengthInput);
     connect(m_lengthInput, &QLineEdit::textChanged, this, &InitialFormWindow::forceUpdate); // <-- WORKAROUND
 
@@ -126,6 +141,17 @@ void InitialFormWindow::submitForm()
     data.weight_kg = m_weightInput->text().toFloat(&ok); if (!ok) { QMessageBox::critical(this, tr("Error"), tr("Invalid Current Weight.")); return; }
     data.length_cm = m_lengthInput->text().toFloat(&ok); if (!ok) { QMessageBox::critical(this, tr("Error"), tr("Invalid Current Length.")); return; }
 
+    // The validators accept intermediate input; enforce the schema ranges here
+    for (size_t i = 0; i < featureschema::InputCount; ++i) {
+        const FeatureSpec &spec = featureschema::INPUTS[i];
+        if (spec.field && spec.source == FeatureSpec::Source::Profile && !featureschema::inRange(i, data.*spec.field)) {
+            QMessageBox::critical(this, tr("Error"), tr("%1 must be between %2 and %3.")
+                                                         .arg(QString::fromLatin1(spec.name))
+                                                         .arg(spec.minimum).arg(spec.maximum));
+            return;
+        }
+    }
+
     // Emit the signal with the collected data
     emit dataSubmitted(data);
 }
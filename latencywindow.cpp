@@ -0,0 +1,47 @@
+#include "latencywindow.h"
+
+#include <algorithm>
+#include <cmath>
+
+void LatencyWindow::record(qint64 durationNs)
+{
+    m_values[m_next] = durationNs;
+    m_next = (m_next + 1) % Capacity;
+    m_count = qMin(m_count + 1, Capacity);
+}
+
+void LatencyWindow::reset()
+{
+    m_next = 0;
+    m_count = 0;
+}
+
+LatencyPercentiles LatencyWindow::percentiles() const
+{
+    LatencyPercentiles result;
+    result.count = m_count;
+    if (m_count == 0)
+        return result;
+
+    // Order does not matter once sorted, so the ring is copied as is
+    std::copy(m_values.begin(), m_values.begin() + m_count, m_sorted.begin());
+    std::sort(m_sorted.begin(), m_sorted.begin() + m_count);
+    auto rank = [this](double q) {
+        // Nearest-rank percentile
+        const int index = int(std::ceil(q * m_count)) - 1;
+        return m_sorted[qBound(0, index, m_count - 1)] / 1e6;
+    };
+    result.p50Ms = rank(0.50);
+    result.p90Ms = rank(0.90);
+    result.p99Ms = rank(0.99);
+    result.maxMs = m_sorted[m_count - 1] / 1e6;
+    return result;
+}
+
+QString LatencyPercentiles::text() const
+{
+    if (count == 0)
+        return QString("n/a");
+    return QString("p50/p90/p99/max: %1/%2/%3/%4 ms (n=%5)")
+        .arg(p50Ms, 0, 'f', 1).arg(p90Ms, 0, 'f', 1).arg(p99Ms, 0, 'f', 1).arg(maxMs, 0, 'f', 1).arg(count);
+}
@@ -0,0 +1,37 @@
+#ifndef LATENCYWINDOW_H
+#define LATENCYWINDOW_H
+
+#include <QString>
+#include <QtGlobal>
+#include <array>
+
+struct LatencyPercentiles {
+    int count = 0;
+    double p50Ms = 0.0;
+    double p90Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+
+    // "p50/p90/p99/max: 12.1/15.0/30.2/41.7 ms (n=512)"
+    QString text() const;
+};
+
+// The last Capacity durations, for percentiles over a sliding window.
+// Recording is a store into a fixed ring; sorting happens on demand.
+class LatencyWindow
+{
+public:
+    static constexpr int Capacity = 1024;
+
+    void record(qint64 durationNs);
+    void reset();
+    LatencyPercentiles percentiles() const;
+
+private:
+    std::array<qint64, Capacity> m_values = {};
+    int m_next = 0;
+    int m_count = 0;
+    mutable std::array<qint64, Capacity> m_sorted = {};
+};
+
+#endif // LATENCYWINDOW_H
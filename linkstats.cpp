@@ -0,0 +1,139 @@
+#include "linkstats.h"
+
+#include <cmath>
+
+namespace {
+
+const qint64 NS_PER_SECOND = 1000000000;
+
+} // namespace
+
+const std::array<double, LinkStats::BucketCount - 1> &LinkStats::histogramEdgesMs()
+{
+    static const std::array<double, BucketCount - 1> edges = {
+        10, 20, 50, 100, 200, 500, 1000, 2000, 5000
+    };
+    return edges;
+}
+
+int LinkStats::bucketFor(double valueMs)
+{
+    const auto &edges = histogramEdgesMs();
+    for (int i = 0; i < int(edges.size()); ++i) {
+        if (valueMs < edges[i])
+            return i;
+    }
+    return BucketCount - 1;
+}
+
+void LinkStats::recordArrival(qint64 arrivalNs)
+{
+    if (m_notifications > 0) {
+        const double interArrivalMs = (arrivalNs - m_lastArrivalNs) / 1e6;
+        ++m_interArrivalHistogram[bucketFor(interArrivalMs)];
+
+        if (m_lastInterArrivalMs >= 0.0) {
+            // J += (|D| - J) / 16, as in RFC 3550 section 6.4.1
+            const double deviation = std::abs(interArrivalMs - m_lastInterArrivalMs);
+            m_jitterMs += (deviation - m_jitterMs) / 16.0;
+            ++m_jitterHistogram[bucketFor(deviation)];
+        }
+        m_lastInterArrivalMs = interArrivalMs;
+    }
+    m_lastArrivalNs = arrivalNs;
+    ++m_notifications;
+
+    const qint64 second = arrivalNs / NS_PER_SECOND;
+    const int slot = int(second % RateWindowSeconds);
+    if (m_secondStamps[slot] != second) {
+        m_secondStamps[slot] = second;
+        m_secondCounts[slot] = 0;
+    }
+    ++m_secondCounts[slot];
+}
+
+void LinkStats::recordRssi(qint16 rssi)
+{
+    m_rssi = rssi;
+    m_rssiValid = true;
+}
+
+void LinkStats::recordConnectTiming(qint64 scanToFoundMs, qint64 scanToConnectedMs, qint64 scanToSubscribedMs)
+{
+    m_scanToFoundMs = scanToFoundMs;
+    m_scanToConnectedMs = scanToConnectedMs;
+    m_scanToSubscribedMs = scanToSubscribedMs;
+}
+
+void LinkStats::reset()
+{
+    *this = LinkStats();
+}
+
+double LinkStats::rateOver(int seconds, qint64 nowSecond) const
+{
+    quint64 count = 0;
+    for (int i = 0; i < RateWindowSeconds; ++i) {
+        const qint64 age = nowSecond - m_secondStamps[i];
+        if (age >= 0 && age < seconds)
+            count += m_secondCounts[i];
+    }
+    return double(count) / seconds;
+}
+
+LinkStatsSnapshot LinkStats::snapshot(qint64 nowNs) const
+{
+    LinkStatsSnapshot snap;
+    snap.rssiValid = m_rssiValid;
+    snap.rssi = m_rssi;
+    snap.notifications = m_notifications;
+    snap.lastInterArrivalMs = qMax(0.0, m_lastInterArrivalMs);
+    snap.jitterMs = m_jitterMs;
+    snap.scanToFoundMs = m_scanToFoundMs;
+    snap.scanToConnectedMs = m_scanToConnectedMs;
+    snap.scanToSubscribedMs = m_scanToSubscribedMs;
+
+    // The current second is still filling up, so the windows end at the last full one
+    const qint64 lastFullSecond = nowNs / NS_PER_SECOND - 1;
+    snap.rate1s = rateOver(1, lastFullSecond);
+    snap.rate10s = rateOver(10, lastFullSecond);
+    snap.rate60s = rateOver(RateWindowSeconds, lastFullSecond);
+
+    snap.interArrivalHistogram = QList<quint32>(m_interArrivalHistogram.begin(), m_interArrivalHistogram.end());
+    snap.jitterHistogram = QList<quint32>(m_jitterHistogram.begin(), m_jitterHistogram.end());
+    return snap;
+}
+
+// --- Snapshot formatting ---
+
+QString LinkStatsSnapshot::summary() const
+{
+    return QString("RSSI: %1 | Rate 1s/10s/60s: %2/%3/%4 Hz | Inter-arrival: %5 ms | Jitter: %6 ms | Total: %7")
+        .arg(rssiValid ? QString("%1 dBm").arg(rssi) : QString("n/a"))
+        .arg(rate1s, 0, 'f', 1)
+        .arg(rate10s, 0, 'f', 2)
+        .arg(rate60s, 0, 'f', 2)
+        .arg(lastInterArrivalMs, 0, 'f', 1)
+        .arg(jitterMs, 0, 'f', 1)
+        .arg(notifications);
+}
+
+QString LinkStatsSnapshot::connectTimingText() const
+{
+    return QString("Scan -> found/connected/subscribed: %1/%2/%3 ms")
+        .arg(scanToFoundMs).arg(scanToConnectedMs).arg(scanToSubscribedMs);
+}
+
+QString LinkStatsSnapshot::histogramText() const
+{
+    const auto &edges = LinkStats::histogramEdgesMs();
+    auto row = [&edges](const QString &title, const QList<quint32> &counts) {
+        QString text = title;
+        for (int i = 0; i < counts.size(); ++i) {
+            const QString bound = (i < int(edges.size())) ? QString("<%1").arg(edges[i]) : QString(">=%1").arg(edges.back());
+            text += QString(" %1:%2").arg(bound).arg(counts[i]);
+        }
+        return text;
+    };
+    return row("Inter-arrival (ms):", interArrivalHistogram) + "\n" + row("Jitter (ms):", jitterHistogram);
+}
@@ -0,0 +1,85 @@
+#ifndef LINKSTATS_H
+#define LINKSTATS_H
+
+#include <QList>
+#include <QMetaType>
+#include <QString>
+#include <array>
+
+#include "clocksync.h"
+
+// Point-in-time copy of the radio link telemetry, safe to send across threads
+struct LinkStatsSnapshot {
+    bool rssiValid = false;
+    qint16 rssi = 0;
+
+    quint64 notifications = 0;
+    double lastInterArrivalMs = 0.0;
+    // RFC 3550 style smoothed jitter of the inter-arrival time
+    double jitterMs = 0.0;
+
+    // Notifications per second over the last 1, 10 and 60 seconds
+    double rate1s = 0.0;
+    double rate10s = 0.0;
+    double rate60s = 0.0;
+
+    // Scan start to target found / connected / subscribed, -1 if not reached
+    qint64 scanToFoundMs = -1;
+    qint64 scanToConnectedMs = -1;
+    qint64 scanToSubscribedMs = -1;
+
+    // Bucket counts, see LinkStats::histogramEdgesMs() for the bucket bounds
+    QList<quint32> interArrivalHistogram;
+    QList<quint32> jitterHistogram;
+
+    // Filled in by BleClient, which owns the clock estimator
+    ClockEstimate clock;
+
+    // One line summary used for the log and the diagnostics panel
+    QString summary() const;
+    QString connectTimingText() const;
+    QString histogramText() const;
+};
+Q_DECLARE_METATYPE(LinkStatsSnapshot)
+
+class LinkStats
+{
+public:
+    static constexpr int BucketCount = 10;
+    static constexpr int RateWindowSeconds = 60;
+
+    // Upper bounds (exclusive) of all but the last, open-ended, bucket
+    static const std::array<double, BucketCount - 1> &histogramEdgesMs();
+
+    void recordArrival(qint64 arrivalNs);
+    void recordRssi(qint16 rssi);
+    void recordConnectTiming(qint64 scanToFoundMs, qint64 scanToConnectedMs, qint64 scanToSubscribedMs);
+    void reset();
+
+    LinkStatsSnapshot snapshot(qint64 nowNs) const;
+
+private:
+    bool m_rssiValid = false;
+    qint16 m_rssi = 0;
+
+    quint64 m_notifications = 0;
+    qint64 m_lastArrivalNs = 0;
+    double m_lastInterArrivalMs = -1.0;
+    double m_jitterMs = 0.0;
+
+    qint64 m_scanToFoundMs = -1;
+    qint64 m_scanToConnectedMs = -1;
+    qint64 m_scanToSubscribedMs = -1;
+
+    std::array<quint32, BucketCount> m_interArrivalHistogram = {};
+    std::array<quint32, BucketCount> m_jitterHistogram = {};
+
+    // Per-second notification counts, indexed by second modulo the window
+    std::array<quint32, RateWindowSeconds> m_secondCounts = {};
+    std::array<qint64, RateWindowSeconds> m_secondStamps = {};
+
+    static int bucketFor(double valueMs);
+    double rateOver(int seconds, qint64 nowSecond) const;
+};
+
+#endif // LINKSTATS_H
@@ -1,18 +1,96 @@
 #include <QApplication>
+#include <QQmlApplicationEngine>
+#include <QThread>
 #include "guiwindow.h"
 #include "bleclient.h"
+#include "dashboardcontroller.h"
+#include "framesource.h"
+#include "initialformwindow.h"
+#include "monitorcontroller.h"
+#include "motiondetector.h"
+#include "structuredlogger.h"
+#include "tickscheduler.h"
+#include "vitalsserver.h"
 
 int main(int argc, char *argv[])
 {
     // QApplication is required for Qt Widgets applications
     QApplication a(argc, argv);
+    StructuredLogger::start();
 
-    // Instantiate the BLE client logic
-    BleClient bleClient;
+    // "--quick" selects the Qt Quick dashboard (Main.qml) instead of GuiWindow
+    const bool useQuickUi = a.arguments().contains(QStringLiteral("--quick"));
+    // "--frames <dir>" analyses a directory of images instead of the camera
+    const int framesArg = a.arguments().indexOf(QStringLiteral("--frames"));
+    const QString framesDir = (framesArg >= 0) ? a.arguments().value(framesArg + 1) : QString();
+    // "--serve [port]" mirrors samples and predictions to secondary screens over WebSocket
+    const int serveArg = a.arguments().indexOf(QStringLiteral("--serve"));
+
+    // All periodic work shares this scheduler's wake-ups; non-critical tasks
+    // are stretched while the app is not in the foreground
+    TickScheduler scheduler;
+    QObject::connect(&a, &QGuiApplication::applicationStateChanged, &scheduler, [&scheduler](Qt::ApplicationState state) {
+        scheduler.setLowPowerMode(state != Qt::ApplicationActive);
+    });
+
+    // Instantiate the BLE client logic on its own I/O thread, so that widget
+    // painting, dialogs and inference on the GUI thread cannot hold back
+    // characteristicChanged. Only parsed samples cross back via queued signals.
+    QThread bleThread;
+    bleThread.setObjectName(QStringLiteral("BleIoThread"));
+    BleClient *bleClient = new BleClient();
+    bleClient->setScheduler(&scheduler);
+    bleClient->moveToThread(&bleThread);
+    QObject::connect(&bleThread, &QThread::finished, bleClient, &QObject::deleteLater);
+    bleThread.start();
+
+    // Motion analysis gets its own thread too; it only sends readings back
+    QThread motionThread;
+    motionThread.setObjectName(QStringLiteral("MotionThread"));
+    FrameSource *frameSource = framesDir.isEmpty()
+        ? static_cast<FrameSource *>(new BleFrameSource(bleClient))
+        : static_cast<FrameSource *>(new DirectoryFrameSource(framesDir));
+    MotionMonitor *motionMonitor = new MotionMonitor();
+    frameSource->moveToThread(&motionThread);
+    motionMonitor->moveToThread(&motionThread);
+    // Same thread, so direct: the source only emits the newest frame, and
+    // processFrame never works through a backlog of older ones
+    QObject::connect(frameSource, &FrameSource::frameReady, motionMonitor, &MotionMonitor::processFrame);
+    QObject::connect(&motionThread, &QThread::started, frameSource, &FrameSource::start);
+    QObject::connect(&motionThread, &QThread::finished, frameSource, &QObject::deleteLater);
+    QObject::connect(&motionThread, &QThread::finished, motionMonitor, &QObject::deleteLater);
+    motionThread.start();
+
+    // Fan-out to secondary screens, off the GUI and BLE threads
+    QThread fanoutThread;
+    VitalsServer *vitalsServer = nullptr;
+    if (serveArg >= 0) {
+        fanoutThread.setObjectName(QStringLiteral("FanoutThread"));
+        vitalsServer = new VitalsServer();
+        vitalsServer->moveToThread(&fanoutThread);
+        QObject::connect(&fanoutThread, &QThread::finished, vitalsServer, &QObject::deleteLater);
+        QObject::connect(bleClient, &BleClient::sampleReceived, vitalsServer, &VitalsServer::publishSample);
+        fanoutThread.start();
+
+        // "--serve-address <ip>" picks the interface (default: this device
+        // only); screens must add "?token=<token>" to the URL, given with
+        // "--serve-token" or generated and logged at start
+        const QStringList arguments = a.arguments();
+        const quint16 servePort = quint16(arguments.value(serveArg + 1).toUInt());
+        const quint16 port = servePort ? servePort : quint16(8765);
+        const int addressArg = arguments.indexOf(QStringLiteral("--serve-address"));
+        const QHostAddress address(addressArg >= 0 ? arguments.value(addressArg + 1) : QStringLiteral("127.0.0.1"));
+        const int tokenArg = arguments.indexOf(QStringLiteral("--serve-token"));
+        const QString token = (tokenArg >= 0) ? arguments.value(tokenArg + 1) : VitalsServer::generateToken();
+        LOG_INFO("fanout.url").field("url", QString("ws://%1:%2/?token=%3").arg(address.toString()).arg(port).arg(token));
+        QMetaObject::invokeMethod(vitalsServer, [vitalsServer, port, token, address]() {
+            vitalsServer->start(port, token, address);
+        });
+    }
 
     InitialFormWindow *initialForm = new InitialFormWindow();
     QObject::connect(initialForm, &InitialFormWindow::dataSubmitted,
-                     &a, [&bleClient, &initialForm](const BabyData& data) {
+                     &a, [&a, bleClient, motionMonitor, vitalsServer, &scheduler, &initialForm, useQuickUi](const BabyData& data) {
 
                          // This lambda executes when the form is submitted
 
@@ -20,18 +98,38 @@ int main(int argc, char *argv[])
                          initialForm->close();
                          initialForm->deleteLater();
 
-                         // 2. Create the main window, passing the client and the form data
-                         GuiWindow *mainWindow = new GuiWindow(&bleClient);
+                         // 2. Predictions and alerts run the same way behind either front-end
+                         MonitorController *monitor = new MonitorController(bleClient, motionMonitor, &scheduler, &a);
+                         monitor->setProfile(data);
+                         if (vitalsServer)
+                             QObject::connect(monitor, &MonitorController::predictionMade, vitalsServer, &VitalsServer::publishPrediction);
 
-                         // Manually call the handler to set the initial data
-                         mainWindow->handleFormData(data);
+                         if (useQuickUi) {
+                             // 3. Create the dashboard backend and load the QML front-end
+                             DashboardController *dashboard = new DashboardController(bleClient, monitor, &a);
+                             QQmlApplicationEngine *engine = new QQmlApplicationEngine(&a);
+                             engine->setInitialProperties({{"dashboard", QVariant::fromValue(dashboard)}});
+                             engine->loadFromModule("untitled1", "Main");
+                             return;
+                         }
 
-                         // 3. Show the main window for the first time
-                         // NOTE: This call is redundant as mainWindow->handleFormData(data) now calls show()
-                         // but leaving it doesn't harm anything.
-                         // mainWindow->show();
+                         // 3. Create the main window and show it
+                         GuiWindow *mainWindow = new GuiWindow(bleClient, motionMonitor, monitor, &scheduler);
+                         mainWindow->show();
                      });
 
     initialForm->show();
-    return a.exec();
+    const int exitCode = a.exec();
+
+    // Stop the frame consumers before the BLE client that feeds them
+    if (vitalsServer) {
+        fanoutThread.quit();
+        fanoutThread.wait();
+    }
+    motionThread.quit();
+    motionThread.wait();
+    bleThread.quit();
+    bleThread.wait();
+    StructuredLogger::shutdown();
+    return exitCode;
 }
@@ -0,0 +1,470 @@
+// Command-line benchmarking harness for health classifier candidates.
+//
+// Streams a recorded dataset through one or more .onnx models that share the
+// 9-input signature of health_classifier.onnx and reports latency percentiles,
+// throughput, memory and label agreement with a reference model.
+//
+//   modelbench --dataset night.csv [--reference current.onnx] a.onnx b.onnx
+//   modelbench --dataset night.csv --arena limited:8 --soak 20000 model.onnx
+//   modelbench --dataset night.csv --swap 20 [--callers 4] a.onnx [b.onnx]
+//
+// --swap hot-swaps the models in turn through ModelManager while --callers
+// threads keep predicting, and reports the callers' latency and failures
+// during the swaps against the steady state in between.
+//
+// Runs on the desktop (Linux x86) as well as on the device (adb shell).
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "featureschema.h"
+#include "healthpredictor.h"
+#include "inferencememory.h"
+#include "modelmanager.h"
+#include "processmemory.h"
+#include "vitalsdataset.h"
+
+// --- Allocation Counting ---
+
+// Every C++ heap allocation in the process (ONNX Runtime included) goes through
+// these, which lets the report show allocations per prediction
+static std::atomic<quint64> g_allocations{0};
+
+void *operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+// RSS growth accepted between the first and last soak checkpoint
+const qint64 SOAK_RSS_TOLERANCE_KB = 256;
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// --- Measurements ---
+
+struct ModelReport {
+    QString name;
+    std::vector<qint64> latenciesNs;
+    quint64 allocations = 0;
+    std::vector<int64_t> labels;
+    double wallSeconds = 0.0;
+    qint64 rssBeforeKb = 0;
+    qint64 rssAfterKb = 0;
+    qint64 peakRssKb = 0;
+    QString error;
+};
+
+double percentileUs(std::vector<qint64> sorted, double q)
+{
+    if (sorted.empty())
+        return 0.0;
+    std::sort(sorted.begin(), sorted.end());
+    // Nearest-rank percentile
+    const size_t rank = size_t(std::ceil(q * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)] / 1000.0;
+}
+
+// With `reuseInputs` the tensors are bound once per patient profile and only the
+// vitals are rewritten, as in the app; otherwise every call binds all 9 inputs
+ModelReport runModel(Ort::Env &env, const QString &modelPath, const std::vector<BabyData> &rows,
+                     int repeat, int warmup, int threads, bool reuseInputs, const MemoryBudget &budget)
+{
+    ModelReport report;
+    report.name = QFileInfo(modelPath).fileName();
+    report.rssBeforeKb = currentRssKb();
+
+    try {
+        HealthPredictor predictor(env, modelPath.toStdString(), budget.sessionOptions(threads));
+
+        for (int i = 0; i < warmup && !rows.empty(); ++i)
+            predictor.predict(rows[i % rows.size()]);
+
+        report.latenciesNs.reserve(rows.size() * repeat);
+        report.labels.reserve(rows.size());
+
+        HealthInputs inputs;
+        const BabyData *boundProfile = nullptr;
+
+        QElapsedTimer wall;
+        QElapsedTimer call;
+        wall.start();
+        for (int pass = 0; pass < repeat; ++pass) {
+            for (const BabyData &row : rows) {
+                const quint64 allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+                call.start();
+                int64_t label;
+                if (reuseInputs) {
+                    if (!boundProfile || !vitalsdataset::sameProfile(*boundProfile, row))
+                        inputs.setProfile(row);
+                    else
+                        inputs.setVitals(row.temperature_c, row.heart_rate_bpm);
+                    boundProfile = &row;
+                    label = predictor.predict(inputs);
+                } else {
+                    label = predictor.predict(row);
+                }
+                report.latenciesNs.push_back(call.nsecsElapsed());
+                report.allocations += g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+                if (pass == 0)
+                    report.labels.push_back(label);
+            }
+        }
+        report.wallSeconds = wall.nsecsElapsed() / 1e9;
+    } catch (const Ort::Exception &e) {
+        report.error = QString("ONNX Runtime Error: %1").arg(e.what());
+    }
+
+    report.rssAfterKb = currentRssKb();
+    report.peakRssKb = peakRssKb();
+    return report;
+}
+
+// Runs `predictions` inferences in the app's pattern (inputs bound once, vitals
+// rewritten per call) and prints RSS and arena usage at 20 checkpoints. Memory
+// must level off after the first checkpoint; returns false if RSS kept growing.
+// Nanoseconds per row to gather the float inputs of every dataset row, via
+// the feature schema and via the hand-ordered list it replaced. Both should
+// compile to the same loads and stores.
+std::pair<double, double> timeFeatureAssembly(const std::vector<BabyData> &rows)
+{
+    if (rows.empty())
+        return {0.0, 0.0};
+    const int passes = qMax(1, 2000000 / int(rows.size()));
+    std::array<float, featureschema::NumericCount> values = {};
+    float checksum = 0.0f;
+
+    // Untimed pass so that neither variant pays for cold caches
+    for (const BabyData &row : rows) {
+        featureschema::assemble(row, values);
+        checksum += values[0];
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const BabyData &row : rows) {
+            featureschema::assemble(row, values);
+            checksum += values[size_t(pass) % values.size()];
+        }
+    }
+    const qint64 schemaNs = timer.nsecsElapsed();
+
+    timer.start();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const BabyData &row : rows) {
+            values = {row.gestational_age_weeks, row.birth_weight_kg, row.birth_length_cm, row.age_days,
+                      row.weight_kg, row.length_cm, row.temperature_c, row.heart_rate_bpm};
+            checksum += values[size_t(pass) % values.size()];
+        }
+    }
+    const qint64 handNs = timer.nsecsElapsed();
+
+    // Keeps both loops from being optimised away
+    static volatile float sink;
+    sink = checksum;
+    const double calls = double(passes) * rows.size();
+    return {schemaNs / calls, handNs / calls};
+}
+
+bool runSoak(Ort::Env &env, const QString &modelPath, const std::vector<BabyData> &rows,
+             int predictions, int threads, const MemoryBudget &budget)
+{
+    if (rows.empty()) {
+        err() << "ERROR: the soak test needs at least one dataset row" << Qt::endl;
+        return false;
+    }
+    const int checkpoints = 20;
+    const int interval = qMax(1, predictions / checkpoints);
+    std::vector<InferenceMemory> samples;
+
+    try {
+        HealthPredictor predictor(env, modelPath.toStdString(), budget.sessionOptions(threads));
+        HealthInputs inputs;
+        inputs.setProfile(rows.front());
+        std::vector<float> probabilities;
+
+        out() << Qt::left << qSetFieldWidth(14) << "predictions" << "RSS KB"
+              << "arena use KB" << "arena res KB" << "arena peak KB" << qSetFieldWidth(0) << Qt::endl;
+        for (int i = 1; i <= predictions; ++i) {
+            const BabyData &row = rows[size_t(i) % rows.size()];
+            inputs.setVitals(row.temperature_c, row.heart_rate_bpm);
+            predictor.predict(inputs, &probabilities);
+
+            if (i % interval == 0 || i == predictions) {
+                const InferenceMemory memory = InferenceMemory::sample(predictor.session());
+                samples.push_back(memory);
+                out() << qSetFieldWidth(14) << QString::number(i) << QString::number(memory.rssKb)
+                      << (memory.arenaValid ? QString::number(memory.arenaInUseBytes / 1024) : QString("n/a"))
+                      << (memory.arenaValid ? QString::number(memory.arenaReservedBytes / 1024) : QString("n/a"))
+                      << (memory.arenaValid ? QString::number(memory.arenaPeakBytes / 1024) : QString("n/a"))
+                      << qSetFieldWidth(0) << Qt::endl;
+            }
+        }
+    } catch (const Ort::Exception &e) {
+        err() << "ERROR: ONNX Runtime Error: " << e.what() << Qt::endl;
+        return false;
+    }
+
+    // The first checkpoint includes one-time warm-up; compare the rest to it
+    const qint64 growthKb = samples.back().rssKb - samples.front().rssKb;
+    const qint64 arenaGrowth = samples.back().arenaReservedBytes - samples.front().arenaReservedBytes;
+    out() << "RSS growth after warm-up: " << growthKb << " KB, arena growth: " << arenaGrowth / 1024
+          << " KB (budget " << budget.toString() << ")" << Qt::endl;
+    // A few pages of allocator noise are tolerated, a trend is not
+    return growthKb <= SOAK_RSS_TOLERANCE_KB && arenaGrowth <= 0;
+}
+
+// Hot-swaps `models` in turn, `swaps` times, through ModelManager while
+// `callers` threads predict without pause. A prediction counts as "during a
+// swap" if it started between loadModel() and modelSwapped(). Returns false
+// if any prediction failed or a swap was rejected.
+bool runSwapUnderLoad(const QStringList &models, const std::vector<BabyData> &rows, int swaps, int callers,
+                      const MemoryBudget &budget)
+{
+    if (rows.empty()) {
+        err() << "ERROR: the swap test needs at least one dataset row" << Qt::endl;
+        return false;
+    }
+    ModelManager manager(budget);
+    std::atomic<int> swapped{0};
+    std::atomic<int> rejected{0};
+    std::vector<double> switchOverUs;
+    QObject::connect(&manager, &ModelManager::modelSwapped, &manager,
+                     [&](const QString &, double, double swapUs) {
+                         switchOverUs.push_back(swapUs);
+                         ++swapped;
+                     }, Qt::DirectConnection);
+    QObject::connect(&manager, &ModelManager::modelRejected, &manager,
+                     [&](const QString &path, const QString &error) {
+                         err() << "ERROR: " << path << " rejected: " << error << Qt::endl;
+                         ++rejected;
+                     }, Qt::DirectConnection);
+
+    auto waitForSwaps = [&](int count) {
+        while (swapped.load() + rejected.load() < count)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    };
+    manager.loadModel(models.front());
+    waitForSwaps(1);
+    if (rejected.load() > 0)
+        return false;
+
+    std::atomic<bool> swapping{false};
+    std::atomic<bool> running{true};
+    std::atomic<quint64> failures{0};
+    std::vector<std::vector<qint64>> steadyNs(size_t(callers));
+    std::vector<std::vector<qint64>> swapNs(size_t(callers));
+    std::vector<std::thread> threads;
+    for (int c = 0; c < callers; ++c) {
+        threads.emplace_back([&, c]() {
+            HealthInputs inputs;
+            inputs.setProfile(rows.front());
+            std::vector<float> probabilities;
+            QElapsedTimer call;
+            for (size_t i = size_t(c); running.load(); ++i) {
+                const BabyData &row = rows[i % rows.size()];
+                inputs.setVitals(row.temperature_c, row.heart_rate_bpm);
+                const bool duringSwap = swapping.load();
+                call.start();
+                try {
+                    manager.predict(inputs, &probabilities);
+                } catch (const Ort::Exception &) {
+                    ++failures;
+                    continue;
+                }
+                (duringSwap ? swapNs : steadyNs)[size_t(c)].push_back(call.nsecsElapsed());
+            }
+        });
+    }
+
+    // Let the callers settle, then swap with the same pause between swaps
+    const auto pause = std::chrono::milliseconds(200);
+    std::this_thread::sleep_for(pause);
+    for (int i = 1; i <= swaps; ++i) {
+        swapping = true;
+        manager.loadModel(models[i % models.size()]);
+        waitForSwaps(1 + i);
+        swapping = false;
+        std::this_thread::sleep_for(pause);
+    }
+    running = false;
+    for (std::thread &thread : threads)
+        thread.join();
+
+    std::vector<qint64> steady;
+    std::vector<qint64> during;
+    for (int c = 0; c < callers; ++c) {
+        steady.insert(steady.end(), steadyNs[size_t(c)].begin(), steadyNs[size_t(c)].end());
+        during.insert(during.end(), swapNs[size_t(c)].begin(), swapNs[size_t(c)].end());
+    }
+    std::sort(switchOverUs.begin(), switchOverUs.end());
+    out() << "Swaps: " << swaps << " across " << models.size() << " model(s), " << callers
+          << " calling threads, " << rejected.load() << " rejected" << Qt::endl;
+    out() << "Switch-over us: median "
+          << QString::number(switchOverUs.empty() ? 0.0 : switchOverUs[switchOverUs.size() / 2], 'f', 1)
+          << ", max " << QString::number(switchOverUs.empty() ? 0.0 : switchOverUs.back(), 'f', 1) << Qt::endl;
+    for (const auto &[name, latencies] : {std::make_pair("steady", &steady), std::make_pair("during swaps", &during)}) {
+        out() << "  " << name << ": " << latencies->size() << " predictions, p50 "
+              << QString::number(percentileUs(*latencies, 0.50), 'f', 1) << " us, p99 "
+              << QString::number(percentileUs(*latencies, 0.99), 'f', 1) << " us, max "
+              << QString::number(percentileUs(*latencies, 1.0), 'f', 1) << " us" << Qt::endl;
+    }
+    out() << "Failed predictions: " << failures.load() << Qt::endl;
+    return failures.load() == 0 && rejected.load() == 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("modelbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks health classifier .onnx models against a recorded dataset.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("models", "Candidate .onnx models.", "model.onnx...");
+    QCommandLineOption datasetOption({"d", "dataset"}, "CSV (with header) or VTLS binary dataset.", "file");
+    QCommandLineOption referenceOption({"r", "reference"}, "Reference model for label agreement (default: first model).", "model");
+    QCommandLineOption repeatOption({"n", "repeat"}, "Passes over the dataset.", "count", "1");
+    QCommandLineOption warmupOption({"w", "warmup"}, "Untimed warm-up predictions per model.", "count", "10");
+    QCommandLineOption threadsOption({"t", "threads"}, "ONNX Runtime intra-op threads.", "count", "1");
+    QCommandLineOption reuseInputsOption("reuse-inputs", "Bind the profile tensors once and only update the vitals per row.");
+    QCommandLineOption arenaOption("arena", "Memory budget: default, limited[:MB] or off.", "spec", "default");
+    QCommandLineOption soakOption("soak", "Run this many predictions on the first model and report memory over time.", "count");
+    QCommandLineOption swapOption("swap", "Hot-swap the models in turn this many times while predicting.", "count");
+    QCommandLineOption callersOption("callers", "Predicting threads during --swap.", "count", "4");
+    parser.addOptions({datasetOption, referenceOption, repeatOption, warmupOption, threadsOption, reuseInputsOption,
+                       arenaOption, soakOption, swapOption, callersOption});
+    parser.process(app);
+
+    QStringList models = parser.positionalArguments();
+    if (models.isEmpty() || !parser.isSet(datasetOption))
+        parser.showHelp(1);
+
+    // The reference always runs first so every other model can be compared to it
+    QString reference = parser.value(referenceOption);
+    if (reference.isEmpty())
+        reference = models.first();
+    models.removeAll(reference);
+    models.prepend(reference);
+
+    // --- Load the Dataset ---
+    const QString datasetPath = parser.value(datasetOption);
+    std::vector<BabyData> rows;
+    QString error;
+    if (!vitalsdataset::load(datasetPath, rows, error)) {
+        err() << "ERROR: " << error << Qt::endl;
+        return 1;
+    }
+    out() << "Dataset: " << datasetPath << " (" << rows.size() << " rows)" << Qt::endl;
+    const auto [schemaNs, handNs] = timeFeatureAssembly(rows);
+    out() << "Feature assembly: schema " << QString::number(schemaNs, 'f', 2) << " ns/row, hand-ordered "
+          << QString::number(handNs, 'f', 2) << " ns/row" << Qt::endl;
+
+    const int repeat = qMax(1, parser.value(repeatOption).toInt());
+    const int warmup = qMax(0, parser.value(warmupOption).toInt());
+    const int threads = qMax(1, parser.value(threadsOption).toInt());
+
+    MemoryBudget budget;
+    if (!MemoryBudget::parse(parser.value(arenaOption), budget)) {
+        err() << "ERROR: invalid --arena " << parser.value(arenaOption) << Qt::endl;
+        return 1;
+    }
+
+    if (parser.isSet(swapOption)) {
+        // ModelManager registers the shared allocator on its own env
+        const int swaps = qMax(1, parser.value(swapOption).toInt());
+        const int callers = qMax(1, parser.value(callersOption).toInt());
+        return runSwapUnderLoad(models, rows, swaps, callers, budget) ? 0 : 2;
+    }
+
+    // All sessions share the allocator registered here, as in the app
+    Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "ModelBench");
+    budget.registerSharedAllocator(env);
+
+    if (parser.isSet(soakOption)) {
+        const int predictions = qMax(1, parser.value(soakOption).toInt());
+        return runSoak(env, models.front(), rows, predictions, threads, budget) ? 0 : 2;
+    }
+
+    // --- Run Every Model ---
+    std::vector<ModelReport> reports;
+    for (const QString &model : std::as_const(models))
+        reports.push_back(runModel(env, model, rows, repeat, warmup, threads, parser.isSet(reuseInputsOption), budget));
+
+    // --- Report ---
+    out() << Qt::left
+          << qSetFieldWidth(28) << "model"
+          << qSetFieldWidth(12) << "p50 (us)" << "p99 (us)" << "rows/s"
+          << "allocs/call" << "RSS +KB" << "peak KB" << "agree %"
+          << qSetFieldWidth(0) << Qt::endl;
+
+    const std::vector<int64_t> &referenceLabels = reports.front().labels;
+    for (const ModelReport &report : reports) {
+        if (!report.error.isEmpty()) {
+            out() << qSetFieldWidth(28) << report.name << qSetFieldWidth(0)
+                  << "ERROR: " << report.error << Qt::endl;
+            continue;
+        }
+
+        QString agreement = "n/a";
+        if (!referenceLabels.empty() && report.labels.size() == referenceLabels.size()) {
+            size_t matches = 0;
+            for (size_t i = 0; i < report.labels.size(); ++i)
+                matches += (report.labels[i] == referenceLabels[i]);
+            agreement = QString::number(100.0 * matches / report.labels.size(), 'f', 2);
+        }
+
+        const double throughput = report.wallSeconds > 0 ? report.latenciesNs.size() / report.wallSeconds : 0.0;
+        out() << qSetFieldWidth(28) << report.name
+              << qSetFieldWidth(12)
+              << QString::number(percentileUs(report.latenciesNs, 0.50), 'f', 1)
+              << QString::number(percentileUs(report.latenciesNs, 0.99), 'f', 1)
+              << QString::number(throughput, 'f', 0)
+              << QString::number(report.latenciesNs.empty() ? 0.0 : double(report.allocations) / report.latenciesNs.size(), 'f', 1)
+              << QString::number(report.rssAfterKb - report.rssBeforeKb)
+              << QString::number(report.peakRssKb)
+              << agreement
+              << qSetFieldWidth(0) << Qt::endl;
+    }
+    out() << "Reference: " << reports.front().name << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,284 @@
+#include "modelmanager.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QStandardPaths>
+#include <QTimer>
+
+#include <cmath>
+
+#include "processmemory.h"
+#include "structuredlogger.h"
+
+namespace {
+
+const QString ASSET_QRC_PATH = ":/health_classifier.onnx";
+const QString MODEL_FILE_NAME = "health_classifier.onnx";
+
+// Give a file that is still being copied (e.g. adb push) time to settle
+const int RELOAD_DEBOUNCE_MS = 1000;
+
+// Plausible profile used to smoke-test a candidate before it goes live
+BabyData validationProfile()
+{
+    BabyData data;
+    data.gender = "female";
+    data.gestational_age_weeks = 39.0f;
+    data.birth_weight_kg = 3.3f;
+    data.birth_length_cm = 50.0f;
+    data.age_days = 10.0f;
+    data.weight_kg = 3.5f;
+    data.length_cm = 51.0f;
+    data.temperature_c = 36.8f;
+    data.heart_rate_bpm = 130.0f;
+    return data;
+}
+
+} // namespace
+
+ModelManager::ModelManager(const MemoryBudget &budget, QObject *parent)
+    : QObject(parent), m_env(ORT_LOGGING_LEVEL_WARNING, "HealthClassifier"), m_budget(budget)
+{
+    try {
+        m_budget.registerSharedAllocator(m_env);
+    } catch (const Ort::Exception &e) {
+        // Sessions then fall back to their own default arenas
+        LOG_WARNING("model.shared_allocator_unavailable").field("error", e.what());
+        m_budget.arena = MemoryBudget::Arena::Default;
+    }
+    LOG_INFO("model.memory_budget").field("budget", m_budget.toString());
+
+    m_loaderPool.setMaxThreadCount(1);
+
+    // Watch app storage for a replacement model
+    const QString modelsDir = QFileInfo(replacementModelPath()).absolutePath();
+    QDir().mkpath(modelsDir);
+    m_watcher = new QFileSystemWatcher(this);
+    m_watcher->addPath(modelsDir);
+
+    m_reloadDebounce = new QTimer(this);
+    m_reloadDebounce->setSingleShot(true);
+    m_reloadDebounce->setInterval(RELOAD_DEBOUNCE_MS);
+    connect(m_reloadDebounce, &QTimer::timeout, this, &ModelManager::checkReplacementModel);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, m_reloadDebounce, qOverload<>(&QTimer::start));
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, m_reloadDebounce, qOverload<>(&QTimer::start));
+}
+
+ModelManager::~ModelManager()
+{
+    // A load still running references m_env and this object
+    m_loaderPool.waitForDone();
+}
+
+QString ModelManager::replacementModelPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+           + QDir::separator() + "models" + QDir::separator() + MODEL_FILE_NAME;
+}
+
+void ModelManager::loadInitialModel()
+{
+    if (QFile::exists(replacementModelPath())) {
+        m_replacementStamp = QFileInfo(replacementModelPath()).lastModified().toMSecsSinceEpoch();
+        m_watcher->addPath(replacementModelPath());
+        loadModel(replacementModelPath());
+        return;
+    }
+
+    // ONNX Runtime needs a real file, so the bundled model is extracted once
+    const QString bundledPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                                + QDir::separator() + MODEL_FILE_NAME;
+    QFile::remove(bundledPath);
+    if (!QFile::copy(ASSET_QRC_PATH, bundledPath)) {
+        emit modelRejected(bundledPath, QString("Failed to copy asset %1").arg(ASSET_QRC_PATH));
+        return;
+    }
+    QFile::setPermissions(bundledPath, QFile::ReadOwner | QFile::WriteOwner);
+    loadModel(bundledPath);
+}
+
+bool ModelManager::hasModel() const
+{
+    return std::atomic_load(&m_current) != nullptr || hasEnsemble();
+}
+
+bool ModelManager::hasEnsemble() const
+{
+    return std::atomic_load(&m_ensemble) != nullptr;
+}
+
+QString ModelManager::modelPath() const
+{
+    std::shared_ptr<LoadedModel> model = std::atomic_load(&m_current);
+    return model ? model->path : QString();
+}
+
+InferenceMemory ModelManager::memorySnapshot() const
+{
+    // The ensemble's sessions share the env allocator, so its first one stands for all
+    std::shared_ptr<EnsembleRunner> ensemble = std::atomic_load(&m_ensemble);
+    if (ensemble)
+        return InferenceMemory::sample(ensemble->session(0));
+
+    std::shared_ptr<LoadedModel> model = std::atomic_load(&m_current);
+    if (!model) {
+        InferenceMemory memory;
+        memory.rssKb = currentRssKb();
+        return memory;
+    }
+    return InferenceMemory::sample(model->predictor->session());
+}
+
+int64_t ModelManager::predict(const HealthInputs &inputs, std::vector<float> *probabilities)
+{
+    struct InFlight {
+        std::atomic<int> &counter;
+        explicit InFlight(std::atomic<int> &c) : counter(c) { ++counter; }
+        ~InFlight() { --counter; }
+    } inFlight(m_inFlight);
+
+    // Our own reference keeps this session alive even if a swap happens meanwhile
+    std::shared_ptr<EnsembleRunner> ensemble = std::atomic_load(&m_ensemble);
+    if (ensemble)
+        return ensemble->predict(inputs, probabilities);
+
+    std::shared_ptr<LoadedModel> model = std::atomic_load(&m_current);
+    if (!model)
+        throw Ort::Exception("No model loaded yet", ORT_FAIL);
+
+    const int64_t label = model->predictor->predict(inputs, probabilities);
+    ++model->served;
+    return label;
+}
+
+// --- Loading ---
+
+void ModelManager::loadModel(const QString &path)
+{
+    m_loaderPool.start([this, path]() { buildAndSwap(path); });
+}
+
+void ModelManager::buildAndSwap(const QString &path)
+{
+    // Runs on the loader thread
+    QElapsedTimer buildTimer;
+    buildTimer.start();
+
+    auto candidate = std::make_shared<LoadedModel>();
+    candidate->path = path;
+    try {
+        candidate->predictor = std::make_unique<HealthPredictor>(m_env, path.toStdString(), m_budget.sessionOptions());
+        candidate->predictor->validateSignature();
+
+        std::vector<float> probabilities;
+        const int64_t label = candidate->predictor->predict(validationProfile(), &probabilities);
+        if (label < 0 || label >= int64_t(probabilities.size()))
+            throw Ort::Exception(QString("Smoke test returned label %1 for %2 classes")
+                                     .arg(label).arg(probabilities.size()).toStdString(), ORT_FAIL);
+        for (float p : probabilities) {
+            if (!std::isfinite(p))
+                throw Ort::Exception("Smoke test returned a non-finite probability", ORT_FAIL);
+        }
+    } catch (const Ort::Exception &e) {
+        // The error first: text fields share a small budget per record
+        LOG_WARNING("model.rejected").field("error", e.what()).field("path", path);
+        emit modelRejected(path, QString::fromUtf8(e.what()));
+        return;
+    }
+    const double buildMs = buildTimer.nsecsElapsed() / 1e6;
+    candidate->generation = m_nextGeneration++;
+
+    // --- Atomic switch-over ---
+    QElapsedTimer swapTimer;
+    swapTimer.start();
+    const int inFlightAtSwap = m_inFlight.load();
+    std::shared_ptr<LoadedModel> previous = std::atomic_exchange(&m_current, candidate);
+    // The model loaded last is the one that predicts, so it also replaces an ensemble
+    std::shared_ptr<EnsembleRunner> ensemble = std::atomic_exchange(&m_ensemble, std::shared_ptr<EnsembleRunner>());
+    const double swapUs = swapTimer.nsecsElapsed() / 1e3;
+
+    // build_ms covers building and validating the candidate; in_flight
+    // predictions finish on the model they started on
+    if (ensemble) {
+        LOG_INFO("model.swapped").field("path", path).field("replaced", "ensemble")
+            .field("generation", candidate->generation).field("build_ms", buildMs).field("swap_us", swapUs)
+            .field("in_flight", inFlightAtSwap);
+    } else if (previous) {
+        LOG_INFO("model.swapped").field("path", path).field("generation", candidate->generation)
+            .field("build_ms", buildMs).field("swap_us", swapUs)
+            .field("previous_served", previous->served.load()).field("in_flight", inFlightAtSwap);
+    } else {
+        LOG_INFO("model.loaded").field("path", path).field("generation", candidate->generation)
+            .field("build_ms", buildMs);
+    }
+    // Dropping `previous` here frees the old session unless a prediction still holds it
+    emit modelSwapped(path, buildMs, swapUs);
+}
+
+void ModelManager::loadEnsemble(const EnsembleSpec &spec)
+{
+    m_loaderPool.start([this, spec]() { buildEnsemble(spec); });
+}
+
+void ModelManager::buildEnsemble(EnsembleSpec spec)
+{
+    // Runs on the loader thread
+    QElapsedTimer buildTimer;
+    buildTimer.start();
+
+    const QDir modelsDir = QFileInfo(replacementModelPath()).absoluteDir();
+    for (EnsembleSpec::Member &member : spec.members) {
+        if (QFileInfo(member.path).isRelative())
+            member.path = modelsDir.absoluteFilePath(member.path);
+    }
+
+    std::shared_ptr<EnsembleRunner> ensemble;
+    try {
+        ensemble = std::make_shared<EnsembleRunner>(m_env, m_budget, spec);
+
+        HealthInputs inputs;
+        inputs.setProfile(validationProfile());
+        EnsembleResult result;
+        ensemble->predict(inputs, result);
+        for (float p : result.probabilities) {
+            if (!std::isfinite(p))
+                throw Ort::Exception("Smoke test returned a non-finite probability", ORT_FAIL);
+        }
+    } catch (const Ort::Exception &e) {
+        LOG_WARNING("ensemble.rejected").field("error", e.what()).field("spec", spec.toString());
+        emit modelRejected(spec.toString(), QString::fromUtf8(e.what()));
+        return;
+    }
+    const double buildMs = buildTimer.nsecsElapsed() / 1e6;
+
+    QElapsedTimer swapTimer;
+    swapTimer.start();
+    const int inFlightAtSwap = m_inFlight.load();
+    std::atomic_exchange(&m_ensemble, ensemble);
+    const double swapUs = swapTimer.nsecsElapsed() / 1e3;
+
+    LOG_INFO("ensemble.loaded").field("spec", spec.toString()).field("models", int(ensemble->size()))
+        .field("workers", ensemble->workers()).field("build_ms", buildMs).field("swap_us", swapUs)
+        .field("in_flight", inFlightAtSwap);
+    emit modelSwapped(spec.toString(), buildMs, swapUs);
+}
+
+void ModelManager::checkReplacementModel()
+{
+    const QFileInfo replacement(replacementModelPath());
+    if (!replacement.exists())
+        return;
+
+    // QFileSystemWatcher drops files that were replaced, so re-arm it each time
+    if (!m_watcher->files().contains(replacement.absoluteFilePath()))
+        m_watcher->addPath(replacement.absoluteFilePath());
+
+    const qint64 stamp = replacement.lastModified().toMSecsSinceEpoch();
+    if (stamp == m_replacementStamp)
+        return;
+    m_replacementStamp = stamp;
+    loadModel(replacement.absoluteFilePath());
+}
@@ -0,0 +1,96 @@
+#ifndef MODELMANAGER_H
+#define MODELMANAGER_H
+
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+#include "ensemblerunner.h"
+#include "healthpredictor.h"
+#include "inferencememory.h"
+
+class QFileSystemWatcher;
+class QTimer;
+
+// Owns the health classifier session and allows replacing the model while
+// monitoring keeps running.
+//
+// A replacement is built and validated on a background thread, then published
+// with a single atomic shared_ptr exchange. predict() takes its own reference
+// to the current session, so a prediction that is already running when the
+// swap happens completes on the old session, which is released afterwards.
+//
+// With an ensemble configured (see EnsembleSpec), predict() scores every
+// ensemble model instead and returns their combined prediction. Whichever
+// load finishes last wins: a later loadModel() (e.g. a replacement model
+// pushed to app storage) swaps the ensemble out as well.
+class ModelManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ModelManager(const MemoryBudget &budget = MemoryBudget(), QObject *parent = nullptr);
+    ~ModelManager() override;
+
+    // App storage location watched for replacement models
+    static QString replacementModelPath();
+
+    // Loads the replacement model when present, otherwise the bundled one
+    void loadInitialModel();
+    // Builds the ensemble in the background; relative model paths are looked
+    // up next to the replacement model
+    void loadEnsemble(const EnsembleSpec &spec);
+
+    bool hasModel() const;
+    QString modelPath() const;
+    bool hasEnsemble() const;
+    const MemoryBudget &memoryBudget() const { return m_budget; }
+
+    // RSS and arena usage of the current session (RSS only without a model)
+    InferenceMemory memorySnapshot() const;
+
+    // Thread-safe. Throws Ort::Exception (also when no model is loaded yet).
+    int64_t predict(const HealthInputs &inputs, std::vector<float> *probabilities = nullptr);
+
+public slots:
+    // Builds, validates and swaps in the model at `path` in the background
+    void loadModel(const QString &path);
+
+signals:
+    void modelSwapped(const QString &path, double buildMs, double swapUs);
+    void modelRejected(const QString &path, const QString &error);
+
+private slots:
+    void checkReplacementModel();
+
+private:
+    struct LoadedModel {
+        std::unique_ptr<HealthPredictor> predictor;
+        QString path;
+        quint64 generation = 0;
+        std::atomic<quint64> served{0};
+    };
+
+    Ort::Env m_env;
+    // Every generation's session uses the allocator registered on m_env
+    MemoryBudget m_budget;
+    // Only ever accessed through std::atomic_load / std::atomic_exchange
+    std::shared_ptr<LoadedModel> m_current;
+    std::shared_ptr<EnsembleRunner> m_ensemble;
+    std::atomic<int> m_inFlight{0};
+    std::atomic<quint64> m_nextGeneration{1};
+
+    // Single worker, so overlapping load requests are built one after another
+    QThreadPool m_loaderPool;
+
+    QFileSystemWatcher *m_watcher = nullptr;
+    QTimer *m_reloadDebounce = nullptr;
+    qint64 m_replacementStamp = 0;
+
+    void buildAndSwap(const QString &path);
+    void buildEnsemble(EnsembleSpec spec);
+};
+
+#endif // MODELMANAGER_H
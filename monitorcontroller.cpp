@@ -0,0 +1,197 @@
+#include "monitorcontroller.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <QtCore/qjniobject.h>
+#include <QtCore/private/qandroidextras_p.h>
+
+#include "structuredlogger.h"
+
+// Camera frames without movement or breathing before the user is alerted
+static const qint64 INACTIVITY_ALERT_NS = 20LL * 1000000000;
+
+// Scheduler intervals and tolerances (how late each task may run)
+static const int PREDICTION_INTERVAL_MS = 10000;
+static const int PREDICTION_TOLERANCE_MS = 2000;
+static const int NOTIFICATION_TOLERANCE_MS = 1000;
+static const int MEMORY_REPORT_INTERVAL_MS = 5000;
+static const int MEMORY_REPORT_TOLERANCE_MS = 2000;
+
+MonitorController::MonitorController(BleClient *client, MotionMonitor *motion, TickScheduler *scheduler,
+                                     QObject *parent)
+    : QObject(parent), m_scheduler(scheduler)
+{
+    if (QNativeInterface::QAndroidApplication::sdkVersion() >= __ANDROID_API_T__) {
+        const auto notificationPermission = QStringLiteral("android.permission.POST_NOTIFICATIONS");
+        auto requestResult = QtAndroidPrivate::requestPermission(notificationPermission);
+        if (requestResult.result() != QtAndroidPrivate::Authorized) {
+            // Required for Android 13+; alerts then only show in the app
+            LOG_WARNING("notification.permission_denied").field("sdk", QNativeInterface::QAndroidApplication::sdkVersion());
+        }
+    }
+
+    // The model is loaded in the background and can be replaced at runtime
+    // "--arena default|limited[:MB]|off" selects the inference memory budget
+    m_modelManager = new ModelManager(MemoryBudget::fromArguments(QCoreApplication::arguments()), this);
+    // ModelManager already logs model.rejected / ensemble.rejected
+    connect(m_modelManager, &ModelManager::modelRejected, this, [this](const QString &, const QString &error) {
+        setNotification(QString("Model update rejected: %1").arg(error));
+    });
+    m_modelManager->loadInitialModel();
+    // "--ensemble mean|majority|any:<model>[=weight],..." scores several models per prediction
+    EnsembleSpec ensemble;
+    if (EnsembleSpec::fromArguments(QCoreApplication::arguments(), ensemble))
+        m_modelManager->loadEnsemble(ensemble);
+    // "--smoothing alpha:enter:leave" tunes how quickly the at-risk state follows the model
+    m_riskSmoother = RiskSmoother(RiskSmoother::Config::fromArguments(QCoreApplication::arguments()));
+    LOG_INFO("risk.smoothing").field("config", m_riskSmoother.config().toString());
+
+    connect(client, &BleClient::sampleReceived, this, &MonitorController::updateSample);
+    connect(motion, &MotionMonitor::motionUpdated, this, &MonitorController::updateMotion);
+
+    // Periodic prediction (10 seconds). Critical: the screen-off night is
+    // when it matters most, and the smoother already adds its own delay
+    m_predictionTask = m_scheduler->addTask("monitor.prediction", PREDICTION_INTERVAL_MS, PREDICTION_TOLERANCE_MS,
+                                            TickScheduler::Priority::Critical, this,
+                                            [this]() { predictNow(); });
+
+    // Alerts must not wait for low-power stretching; a burst of changes
+    // costs one post
+    m_notificationTask = m_scheduler->addDeferredTask("monitor.notification", NOTIFICATION_TOLERANCE_MS,
+                                                      TickScheduler::Priority::Critical, this,
+                                                      [this]() { postAndroidNotification(); });
+
+    // Reads /proc, so it runs with the background reports rather than
+    // around every prediction
+    m_memoryTask = m_scheduler->addTask("monitor.memory", MEMORY_REPORT_INTERVAL_MS, MEMORY_REPORT_TOLERANCE_MS,
+                                        TickScheduler::Priority::Background, this,
+                                        [this]() { logInferenceMemory(); });
+}
+
+void MonitorController::setProfile(const BabyData &data)
+{
+    m_babyData = data;
+    // Build the profile tensors once; updateSample() only rewrites the vitals
+    m_modelInputs.setProfile(m_babyData);
+    // A new profile starts without history
+    m_riskSmoother.reset();
+    setRiskState(RiskState::Unknown);
+
+    // Debug output
+    qDebug() << "--- Patient Data Stored Successfully ---";
+    qDebug() << "  Gender:" << m_babyData.gender;
+    qDebug() << "  GA (weeks):" << m_babyData.gestational_age_weeks;
+    qDebug() << "  Birth Weight (kg):" << m_babyData.birth_weight_kg;
+    qDebug() << "  Birth Length (cm):" << m_babyData.birth_length_cm;
+    qDebug() << "  Age (days):" << m_babyData.age_days;
+    qDebug() << "  Current Weight (kg):" << m_babyData.weight_kg;
+    qDebug() << "  Current Length (cm):" << m_babyData.length_cm;
+    qDebug() << "  Temperature (C, BLE init):" << m_babyData.temperature_c;
+    qDebug() << "  Heart Rate (bpm, BLE init):" << m_babyData.heart_rate_bpm;
+    qDebug() << "------------------------------------------";
+}
+
+void MonitorController::updateSample(const VitalsSample &sample)
+{
+    m_babyData.temperature_c = sample.temperature_c;
+    m_babyData.heart_rate_bpm = sample.heart_rate_bpm;
+    m_modelInputs.setVitals(sample.temperature_c, sample.heart_rate_bpm);
+}
+
+/**
+ * @brief Runs an inference using the compiled ONNX Runtime and the model.
+ */
+void MonitorController::predictNow()
+{
+    // The session is owned by m_modelManager and reused across calls; if the
+    // model is being swapped, this call still completes on the current one
+    try {
+        const int64_t predicted_label = m_modelManager->predict(m_modelInputs, &m_probabilities);
+        m_prediction.setScores(predicted_label, m_probabilities);
+    } catch (const Ort::Exception& e) {
+        m_prediction.setError(QString("ONNX Runtime Error: %1").arg(e.what()));
+    } catch (const std::exception& e) {
+        m_prediction.setError(QString("Standard C++ Error: %1").arg(e.what()));
+    }
+
+    if (!m_prediction.ok) {
+        LOG_WARNING("prediction.failed").field("error", m_prediction.error);
+        setRiskState(RiskState::Failed);
+        setNotification("Prediction failed: Check debug logs.");
+        return;
+    }
+
+    const RiskSmoother::Update update = m_riskSmoother.add(m_prediction.riskProbability());
+    LOG_DEBUG("prediction").field("label", m_prediction.label)
+        .field("p_at_risk", double(m_prediction.riskProbability())).field("p_smoothed", double(update.smoothed));
+    emit predictionMade(m_prediction);
+
+    // Repeated predictions of the same state cost nothing past this point
+    const RiskState state = (update.state == RiskSmoother::State::AtRisk) ? RiskState::AtRisk : RiskState::Normal;
+    if (state == m_riskState)
+        return;
+    LOG_INFO("prediction.state").field("at_risk", state == RiskState::AtRisk)
+        .field("p_smoothed", double(update.smoothed));
+    setRiskState(state);
+    setNotification(state == RiskState::AtRisk ? "Warning: Baby predicted to be AT RISK."
+                                               : "Status normal: Baby predicted NOT AT RISK.");
+}
+
+void MonitorController::setRiskState(RiskState state)
+{
+    // Failures carry a new error each time, so they are always published
+    if (state == m_riskState && state != RiskState::Failed)
+        return;
+    m_riskState = state;
+    emit riskStateChanged(m_riskState);
+}
+
+void MonitorController::updateMotion(const MotionReading &reading)
+{
+    if (reading.moving || reading.breathingDetected || m_lastActivityNs == 0) {
+        m_lastActivityNs = reading.timestampNs;
+        if (m_inactivityAlerted) {
+            m_inactivityAlerted = false;
+            setNotification("Movement detected again.");
+        }
+        return;
+    }
+
+    // Frames keep coming but show neither movement nor a breathing rhythm
+    if (!m_inactivityAlerted && reading.timestampNs - m_lastActivityNs >= INACTIVITY_ALERT_NS) {
+        m_inactivityAlerted = true;
+        setNotification(QString("Warning: No movement or breathing activity seen for %1 s.")
+                            .arg(INACTIVITY_ALERT_NS / 1000000000));
+    }
+}
+
+void MonitorController::setNotification(const QString &notification)
+{
+    // Only a changed text schedules a post
+    if (m_notification == notification)
+        return;
+    m_notification = notification;
+    emit notificationChanged(m_notification);
+    m_scheduler->trigger(m_notificationTask);
+}
+
+//! [Send notification message to Java]
+void MonitorController::postAndroidNotification()
+{
+    QJniObject javaNotification = QJniObject::fromString(m_notification);
+    QJniObject::callStaticMethod<void>(
+        "org/qtproject/example/androidnotifier/NotificationClient",
+        "notify",
+        "(Landroid/content/Context;Ljava/lang/String;)V",
+        QNativeInterface::QAndroidApplication::context(),
+        javaNotification.object<jstring>());
+}
+
+void MonitorController::logInferenceMemory()
+{
+    const InferenceMemory memory = m_modelManager->memorySnapshot();
+    LOG_INFO("inference.memory").field("rss_kb", memory.rssKb)
+        .field("arena_in_use_kb", memory.arenaInUseBytes / 1024).field("arena_reserved_kb", memory.arenaReservedBytes / 1024)
+        .field("arena_peak_kb", memory.arenaPeakBytes / 1024);
+}
@@ -0,0 +1,93 @@
+#ifndef MONITORCONTROLLER_H
+#define MONITORCONTROLLER_H
+
+#include <QObject>
+#include <QString>
+#include <vector>
+
+#include "babydata.h"
+#include "bleclient.h"
+#include "modelmanager.h"
+#include "motiondetector.h"
+#include "predictionresult.h"
+#include "risksmoother.h"
+#include "tickscheduler.h"
+
+// What the monitor decides, independent of the front-end.
+//
+// Owns the classifier (ModelManager), the profile and vitals it is fed with,
+// the periodic prediction, the at-risk smoothing, the inactivity alert from
+// the camera and the Android notification. GuiWindow and the Qt Quick
+// dashboard (DashboardController) only present its state. Lives on the GUI
+// thread; the BleClient and MotionMonitor signals arrive queued.
+class MonitorController : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Unknown until the first prediction; Failed until the next success
+    enum class RiskState { Unknown, Normal, AtRisk, Failed };
+    Q_ENUM(RiskState)
+
+    MonitorController(BleClient *client, MotionMonitor *motion, TickScheduler *scheduler,
+                      QObject *parent = nullptr);
+
+    // Binds the profile tensors once and starts without risk history
+    void setProfile(const BabyData &data);
+    const BabyData &profile() const { return m_babyData; }
+
+    RiskState riskState() const { return m_riskState; }
+    // Exponential moving average of the at-risk probability
+    float smoothedRisk() const { return m_riskSmoother.smoothed(); }
+    // The last prediction, or the last failure
+    const PredictionResult &lastPrediction() const { return m_prediction; }
+    QString notification() const { return m_notification; }
+
+public slots:
+    // Runs a prediction now (also runs every 10 s)
+    void predictNow();
+
+signals:
+    // After every successful prediction, e.g. for VitalsServer
+    void predictionMade(const PredictionResult &result);
+    // Only when the state shown to the user changes; a failure is reported
+    // every time, with lastPrediction().error
+    void riskStateChanged(MonitorController::RiskState state);
+    void notificationChanged(const QString &notification);
+
+private slots:
+    void updateSample(const VitalsSample &sample);
+    void updateMotion(const MotionReading &reading);
+    void postAndroidNotification();
+
+private:
+    TickScheduler *m_scheduler;
+    BabyData m_babyData;
+
+    // Owns the classifier session; supports hot-swapping the model file
+    ModelManager *m_modelManager;
+    // Input tensors bound once per profile; only the vitals change per sample
+    HealthInputs m_modelInputs;
+    std::vector<float> m_probabilities;
+    PredictionResult m_prediction;
+    // Only a change of the smoothed state is published; after a failure the
+    // next success is published whatever its state
+    RiskSmoother m_riskSmoother;
+    RiskState m_riskState = RiskState::Unknown;
+
+    // Last frame with movement or a breathing rhythm, for the inactivity alert
+    qint64 m_lastActivityNs = 0;
+    bool m_inactivityAlerted = false;
+
+    QString m_notification;
+
+    int m_predictionTask = -1;
+    int m_notificationTask = -1;
+    int m_memoryTask = -1;
+
+    void setRiskState(RiskState state);
+    void setNotification(const QString &notification);
+    void logInferenceMemory();
+};
+
+#endif // MONITORCONTROLLER_H
@@ -0,0 +1,167 @@
+// Command-line benchmark of the camera motion analysis.
+//
+// Times MotionDetector::process() and its kernels per frame on synthetic
+// QVGA and VGA frames (or the images of a directory), on the calling thread
+// only, so the numbers are single-core cost.
+//
+//   motionbench [--frames 500] [--images dir]
+//
+// Runs on the desktop (Linux x86) as well as on the device (adb shell).
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QImage>
+#include <QTextStream>
+
+#include <algorithm>
+#include <vector>
+
+#include "motiondetector.h"
+
+namespace {
+
+// Results are written here so the compiler cannot drop the timed calls
+volatile quint64 g_sink = 0;
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+// A textured background with a slowly moving bright patch, in the format
+// the JPEG decoder produces
+std::vector<QImage> syntheticFrames(const QSize &size, int count)
+{
+    QImage background(size, QImage::Format_RGB32);
+    quint32 seed = 12345;
+    for (int y = 0; y < size.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(background.scanLine(y));
+        for (int x = 0; x < size.width(); ++x) {
+            seed = seed * 1664525u + 1013904223u;
+            const int level = 64 + int(seed >> 26);
+            line[x] = qRgb(level, level, level);
+        }
+    }
+
+    std::vector<QImage> frames;
+    const int patch = size.width() / 8;
+    for (int i = 0; i < count; ++i) {
+        QImage frame = background.copy();
+        const int x0 = (i * 3) % (size.width() - patch);
+        const int y0 = size.height() / 2 - patch / 2;
+        for (int y = y0; y < y0 + patch; ++y) {
+            QRgb *line = reinterpret_cast<QRgb *>(frame.scanLine(y));
+            std::fill(line + x0, line + x0 + patch, qRgb(220, 220, 220));
+        }
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+double percentileUs(std::vector<qint64> samplesNs, double p)
+{
+    if (samplesNs.empty())
+        return 0.0;
+    std::sort(samplesNs.begin(), samplesNs.end());
+    const size_t index = std::min(samplesNs.size() - 1, size_t(p * samplesNs.size()));
+    return samplesNs[index] / 1000.0;
+}
+
+void runBenchmark(const QString &name, const std::vector<QImage> &frames, int iterations)
+{
+    MotionDetector detector;
+    std::vector<qint64> processNs;
+    std::vector<qint64> downscaleNs;
+    std::vector<qint64> simdNs;
+    std::vector<qint64> scalarNs;
+
+    constexpr int pixels = MotionDetector::AnalysisWidth * MotionDetector::AnalysisHeight;
+    std::vector<quint8> previous(pixels);
+    std::vector<quint8> current(pixels);
+    quint64 checksum = 0;
+
+    QElapsedTimer timer;
+    for (int i = 0; i < iterations; ++i) {
+        const QImage &frame = frames[size_t(i) % frames.size()];
+        const qint64 timestampNs = qint64(i) * 100000000; // 10 fps
+
+        timer.start();
+        const MotionReading reading = detector.process(frame, timestampNs);
+        processNs.push_back(timer.nsecsElapsed());
+        checksum += quint64(reading.motionLevel);
+
+        timer.start();
+        motionkernels::downscaleToGray(frame, current.data(), MotionDetector::AnalysisWidth, MotionDetector::AnalysisHeight);
+        downscaleNs.push_back(timer.nsecsElapsed());
+
+        timer.start();
+        checksum += motionkernels::diffFrames(current.data(), previous.data(), pixels, MotionDetector::PixelThreshold).changedPixels;
+        simdNs.push_back(timer.nsecsElapsed());
+
+        timer.start();
+        checksum += motionkernels::diffFramesScalar(current.data(), previous.data(), pixels, MotionDetector::PixelThreshold).changedPixels;
+        scalarNs.push_back(timer.nsecsElapsed());
+
+        previous.swap(current);
+    }
+
+    out() << qSetFieldWidth(16) << name << qSetFieldWidth(12)
+          << QString::number(percentileUs(processNs, 0.50), 'f', 1)
+          << QString::number(percentileUs(processNs, 0.99), 'f', 1)
+          << QString::number(percentileUs(downscaleNs, 0.50), 'f', 1)
+          << QString::number(percentileUs(simdNs, 0.50), 'f', 2)
+          << QString::number(percentileUs(scalarNs, 0.50), 'f', 2)
+          << qSetFieldWidth(0) << Qt::endl;
+    g_sink = checksum;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // No GUI needed, so it also runs from adb shell
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("motionbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks the camera motion analysis per frame on one core.");
+    parser.addHelpOption();
+    QCommandLineOption framesOption({"n", "frames"}, "Frames processed per resolution.", "count", "500");
+    QCommandLineOption imagesOption({"i", "images"}, "Also run on the images of this directory.", "dir");
+    parser.addOptions({framesOption, imagesOption});
+    parser.process(app);
+
+    const int iterations = qMax(2, parser.value(framesOption).toInt());
+
+    out() << "Analysis " << MotionDetector::AnalysisWidth << "x" << MotionDetector::AnalysisHeight
+          << ", diff kernel: " << motionkernels::diffFramesIsa() << Qt::endl;
+    out() << Qt::left
+          << qSetFieldWidth(16) << "input"
+          << qSetFieldWidth(12) << "p50 (us)" << "p99 (us)" << "scale (us)"
+          << "diff (us)" << "scalar (us)"
+          << qSetFieldWidth(0) << Qt::endl;
+
+    runBenchmark("QVGA 320x240", syntheticFrames(QSize(320, 240), 64), iterations);
+    runBenchmark("VGA 640x480", syntheticFrames(QSize(640, 480), 64), iterations);
+
+    if (parser.isSet(imagesOption)) {
+        const QDir dir(parser.value(imagesOption));
+        std::vector<QImage> images;
+        for (const QString &name : dir.entryList({"*.jpg", "*.jpeg", "*.png", "*.bmp"}, QDir::Files, QDir::Name)) {
+            // Decoded up front: the benchmark measures analysis, not JPEG decoding
+            QImage image(dir.filePath(name));
+            if (!image.isNull())
+                images.push_back(image);
+        }
+        if (images.empty()) {
+            out() << "No images in " << dir.path() << Qt::endl;
+            return 1;
+        }
+        runBenchmark(QString("%1x%2 dir").arg(images.front().width()).arg(images.front().height()),
+                     images, iterations);
+    }
+    return 0;
+}
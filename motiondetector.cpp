@@ -0,0 +1,335 @@
+#include "motiondetector.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MOTION_DIFF_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MOTION_DIFF_NEON 1
+#endif
+
+namespace {
+
+const qint64 NS_PER_SECOND = 1000000000;
+
+// ITU-R BT.601 luma weights scaled by 256
+inline quint32 luma256(QRgb pixel)
+{
+    return 77 * qRed(pixel) + 150 * qGreen(pixel) + 29 * qBlue(pixel);
+}
+
+} // namespace
+
+// --- Kernels ---
+
+namespace motionkernels {
+
+void downscaleToGray(const QImage &frame, quint8 *dst, int dstWidth, int dstHeight)
+{
+    QImage source = frame;
+    if (source.format() != QImage::Format_Grayscale8
+        && source.format() != QImage::Format_RGB32
+        && source.format() != QImage::Format_ARGB32) {
+        source = source.convertToFormat(QImage::Format_RGB32);
+    }
+    const bool gray = source.format() == QImage::Format_Grayscale8;
+    const int width = source.width();
+    const int height = source.height();
+
+    // Each output pixel averages the block of source pixels it covers
+    for (int dy = 0; dy < dstHeight; ++dy) {
+        const int y0 = dy * height / dstHeight;
+        const int y1 = qMax(y0 + 1, (dy + 1) * height / dstHeight);
+        for (int dx = 0; dx < dstWidth; ++dx) {
+            const int x0 = dx * width / dstWidth;
+            const int x1 = qMax(x0 + 1, (dx + 1) * width / dstWidth);
+
+            quint32 sum = 0;
+            for (int sy = y0; sy < y1; ++sy) {
+                if (gray) {
+                    const quint8 *line = source.constScanLine(sy);
+                    for (int sx = x0; sx < x1; ++sx)
+                        sum += quint32(line[sx]) << 8;
+                } else {
+                    const QRgb *line = reinterpret_cast<const QRgb *>(source.constScanLine(sy));
+                    for (int sx = x0; sx < x1; ++sx)
+                        sum += luma256(line[sx]);
+                }
+            }
+            const quint32 pixels = quint32((y1 - y0) * (x1 - x0));
+            dst[dy * dstWidth + dx] = quint8(sum / (pixels << 8));
+        }
+    }
+}
+
+FrameDiff diffFramesScalar(const quint8 *a, const quint8 *b, size_t count, quint8 threshold)
+{
+    FrameDiff diff;
+    for (size_t i = 0; i < count; ++i) {
+        const int d = std::abs(int(a[i]) - int(b[i]));
+        diff.sumAbsDiff += quint64(d);
+        diff.changedPixels += (d > threshold);
+    }
+    return diff;
+}
+
+#if defined(MOTION_DIFF_SSE2)
+
+FrameDiff diffFrames(const quint8 *a, const quint8 *b, size_t count, quint8 threshold)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i limit = _mm_set1_epi8(char(threshold));
+    const __m128i allOnes = _mm_set1_epi8(-1);
+    __m128i sad = _mm_setzero_si128();
+    __m128i changedTotal = _mm_setzero_si128();
+
+    size_t i = 0;
+    while (i + 16 <= count) {
+        // Byte counters of changed pixels; folded before they can overflow
+        __m128i changed = _mm_setzero_si128();
+        for (int block = 0; block < 255 && i + 16 <= count; ++block, i += 16) {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+            sad = _mm_add_epi64(sad, _mm_sad_epu8(va, vb));
+
+            const __m128i absDiff = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+            // Lanes above the threshold are non-zero after the saturating subtract;
+            // the compare yields -1 for the others, so subtracting it counts them
+            const __m128i unchanged = _mm_cmpeq_epi8(_mm_subs_epu8(absDiff, limit), zero);
+            changed = _mm_sub_epi8(changed, _mm_xor_si128(unchanged, allOnes));
+        }
+        changedTotal = _mm_add_epi64(changedTotal, _mm_sad_epu8(changed, zero));
+    }
+
+    alignas(16) quint64 sadLanes[2];
+    alignas(16) quint64 changedLanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(sadLanes), sad);
+    _mm_store_si128(reinterpret_cast<__m128i *>(changedLanes), changedTotal);
+
+    FrameDiff diff;
+    diff.sumAbsDiff = sadLanes[0] + sadLanes[1];
+    diff.changedPixels = changedLanes[0] + changedLanes[1];
+
+    const FrameDiff tail = diffFramesScalar(a + i, b + i, count - i, threshold);
+    diff.sumAbsDiff += tail.sumAbsDiff;
+    diff.changedPixels += tail.changedPixels;
+    return diff;
+}
+
+const char *diffFramesIsa()
+{
+    return "sse2";
+}
+
+#elif defined(MOTION_DIFF_NEON)
+
+FrameDiff diffFrames(const quint8 *a, const quint8 *b, size_t count, quint8 threshold)
+{
+    const uint8x16_t limit = vdupq_n_u8(threshold);
+    uint32x4_t sad = vdupq_n_u32(0);
+    uint32x4_t changed = vdupq_n_u32(0);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t absDiff = vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+        sad = vpadalq_u16(sad, vpaddlq_u8(absDiff));
+        // 0xFF where changed, shifted down to 1
+        const uint8x16_t over = vshrq_n_u8(vcgtq_u8(absDiff, limit), 7);
+        changed = vpadalq_u16(changed, vpaddlq_u8(over));
+    }
+
+    FrameDiff diff;
+    diff.sumAbsDiff = quint64(vgetq_lane_u32(sad, 0)) + vgetq_lane_u32(sad, 1)
+                      + vgetq_lane_u32(sad, 2) + vgetq_lane_u32(sad, 3);
+    diff.changedPixels = quint64(vgetq_lane_u32(changed, 0)) + vgetq_lane_u32(changed, 1)
+                         + vgetq_lane_u32(changed, 2) + vgetq_lane_u32(changed, 3);
+
+    const FrameDiff tail = diffFramesScalar(a + i, b + i, count - i, threshold);
+    diff.sumAbsDiff += tail.sumAbsDiff;
+    diff.changedPixels += tail.changedPixels;
+    return diff;
+}
+
+const char *diffFramesIsa()
+{
+    return "neon";
+}
+
+#else
+
+FrameDiff diffFrames(const quint8 *a, const quint8 *b, size_t count, quint8 threshold)
+{
+    return diffFramesScalar(a, b, count, threshold);
+}
+
+const char *diffFramesIsa()
+{
+    return "scalar";
+}
+
+#endif
+
+} // namespace motionkernels
+
+// --- BreathingTracker ---
+
+void BreathingTracker::reset()
+{
+    *this = BreathingTracker();
+}
+
+void BreathingTracker::push(float value)
+{
+    m_bins[m_head] = value;
+    m_head = (m_head + 1) % WindowBins;
+    m_count = qMin(m_count + 1, WindowBins);
+}
+
+float BreathingTracker::at(int index) const
+{
+    // index 0 is the oldest bin in the window
+    return m_bins[(m_head - m_count + index + WindowBins) % WindowBins];
+}
+
+void BreathingTracker::add(qint64 timestampNs, double motionLevel)
+{
+    const qint64 bin = timestampNs / (NS_PER_SECOND / BinsPerSecond);
+
+    if (m_openBin >= 0 && bin > m_openBin) {
+        const float value = float(m_openSum / m_openSamples);
+        push(value);
+        // Frames arrive slower than the grid: hold the last value across the gap
+        const qint64 gap = qMin<qint64>(bin - m_openBin - 1, WindowBins);
+        for (qint64 i = 0; i < gap; ++i)
+            push(value);
+        m_openSum = 0.0;
+        m_openSamples = 0;
+    }
+    if (m_openBin < 0 || bin > m_openBin)
+        m_openBin = bin;
+
+    // Late frames are folded into the open bin
+    m_openSum += motionLevel;
+    ++m_openSamples;
+}
+
+void BreathingTracker::estimate(double &periodicity, double &rateBpm) const
+{
+    periodicity = 0.0;
+    rateBpm = 0.0;
+    if (m_count < MinimumBins)
+        return;
+
+    double mean = 0.0;
+    for (int i = 0; i < m_count; ++i)
+        mean += at(i);
+    mean /= m_count;
+
+    auto autocorrelation = [this, mean](int lag) {
+        double sum = 0.0;
+        for (int i = lag; i < m_count; ++i)
+            sum += (at(i) - mean) * (at(i - lag) - mean);
+        return sum;
+    };
+
+    const double energy = autocorrelation(0);
+    if (energy <= 1e-9)
+        return;
+
+    // Half a breath in bins, see the class comment
+    const int minLag = qMax(2, int(std::floor(30.0 / MaxRateBpm * BinsPerSecond)));
+    const int maxLag = int(std::ceil(30.0 / MinRateBpm * BinsPerSecond));
+
+    std::array<double, 64> correlations = {};
+    for (int lag = minLag - 1; lag <= maxLag + 1; ++lag)
+        correlations[lag] = autocorrelation(lag);
+
+    // Only local maxima are periods; the decay from lag 0 is not
+    double best = 0.0;
+    for (int lag = minLag; lag <= maxLag; ++lag) {
+        if (correlations[lag] > correlations[lag - 1] && correlations[lag] >= correlations[lag + 1])
+            best = qMax(best, correlations[lag]);
+    }
+    // Multiples of the period peak almost as high; take the shortest strong one
+    int bestLag = 0;
+    for (int lag = minLag; lag <= maxLag && bestLag == 0; ++lag) {
+        if (correlations[lag] > correlations[lag - 1] && correlations[lag] >= correlations[lag + 1]
+            && correlations[lag] >= 0.8 * best && best > 0.0) {
+            bestLag = lag;
+        }
+    }
+    if (bestLag == 0)
+        return;
+
+    // Parabolic interpolation around the peak for a sub-bin period
+    const double peak = correlations[bestLag];
+    const double left = correlations[bestLag - 1];
+    const double right = correlations[bestLag + 1];
+    const double curvature = left - 2.0 * peak + right;
+    const double lag = bestLag + (curvature < 0.0 ? 0.5 * (left - right) / curvature : 0.0);
+
+    periodicity = qBound(0.0, peak / energy, 1.0);
+    rateBpm = 60.0 * BinsPerSecond / (2.0 * lag);
+}
+
+// --- MotionDetector ---
+
+MotionDetector::MotionDetector()
+    : m_previous(AnalysisWidth * AnalysisHeight),
+      m_current(AnalysisWidth * AnalysisHeight)
+{
+}
+
+void MotionDetector::reset()
+{
+    m_hasPrevious = false;
+    m_breathing.reset();
+}
+
+MotionReading MotionDetector::process(const QImage &frame, qint64 timestampNs)
+{
+    MotionReading reading;
+    reading.timestampNs = timestampNs;
+    if (frame.isNull())
+        return reading;
+
+    motionkernels::downscaleToGray(frame, m_current.data(), AnalysisWidth, AnalysisHeight);
+
+    if (m_hasPrevious) {
+        const size_t pixels = m_current.size();
+        const motionkernels::FrameDiff diff =
+            motionkernels::diffFrames(m_current.data(), m_previous.data(), pixels, PixelThreshold);
+        reading.motionLevel = double(diff.sumAbsDiff) / pixels;
+        reading.changedFraction = double(diff.changedPixels) / pixels;
+        reading.moving = reading.changedFraction >= MovingFraction;
+
+        m_breathing.add(timestampNs, reading.motionLevel);
+        m_breathing.estimate(reading.periodicity, reading.breathingRateBpm);
+        reading.breathingDetected = reading.periodicity >= BreathingPeriodicity;
+        if (!reading.breathingDetected)
+            reading.breathingRateBpm = 0.0;
+    }
+
+    m_previous.swap(m_current);
+    m_hasPrevious = true;
+    return reading;
+}
+
+// --- MotionMonitor ---
+
+MotionMonitor::MotionMonitor(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void MotionMonitor::processFrame(const QImage &image, qint64 timestampNs)
+{
+    emit motionUpdated(m_detector.process(image, timestampNs));
+}
+
+void MotionMonitor::reset()
+{
+    m_detector.reset();
+}
@@ -0,0 +1,128 @@
+#ifndef MOTIONDETECTOR_H
+#define MOTIONDETECTOR_H
+
+#include <QImage>
+#include <QMetaType>
+#include <QObject>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Result of analysing one camera frame
+struct MotionReading {
+    qint64 timestampNs = 0;
+    // Mean absolute grey-level difference to the previous frame (0..255)
+    double motionLevel = 0.0;
+    // Share of analysis pixels that changed by more than the pixel threshold
+    double changedFraction = 0.0;
+    bool moving = false;
+
+    // Breathing-activity proxy: strength (0..1) of the periodic component of
+    // the motion signal and the rate it corresponds to, 0 if none was found
+    double periodicity = 0.0;
+    double breathingRateBpm = 0.0;
+    bool breathingDetected = false;
+};
+Q_DECLARE_METATYPE(MotionReading)
+
+// --- Kernels ---
+
+// Exposed for motionbench; MotionDetector is the intended entry point
+namespace motionkernels {
+
+struct FrameDiff {
+    quint64 sumAbsDiff = 0;
+    quint64 changedPixels = 0;
+};
+
+// Box-filtered grey-scale downscale of `frame` into a dstWidth x dstHeight plane
+void downscaleToGray(const QImage &frame, quint8 *dst, int dstWidth, int dstHeight);
+
+// Sum of |a - b| and the count of pixels where |a - b| > threshold. Uses SSE2
+// or NEON when the target has it, diffFramesScalar() otherwise.
+FrameDiff diffFrames(const quint8 *a, const quint8 *b, size_t count, quint8 threshold);
+FrameDiff diffFramesScalar(const quint8 *a, const quint8 *b, size_t count, quint8 threshold);
+
+// Name of the diffFrames() implementation compiled in ("sse2", "neon", "scalar")
+const char *diffFramesIsa();
+
+} // namespace motionkernels
+
+// Resamples the per-frame motion level onto a fixed grid and looks for a
+// periodic component by autocorrelation. The motion level follows the speed
+// of the chest, which peaks twice per breath, so the detected period is half
+// a breath.
+class BreathingTracker
+{
+public:
+    static constexpr int BinsPerSecond = 8;
+    static constexpr int WindowBins = 32 * BinsPerSecond;
+    // Needs this much history before it reports anything
+    static constexpr int MinimumBins = 12 * BinsPerSecond;
+    static constexpr double MinRateBpm = 15.0;
+    static constexpr double MaxRateBpm = 80.0;
+
+    void add(qint64 timestampNs, double motionLevel);
+    void reset();
+
+    // Periodicity (0..1) and breaths per minute of the current window
+    void estimate(double &periodicity, double &rateBpm) const;
+
+private:
+    std::array<float, WindowBins> m_bins = {};
+    int m_head = 0;
+    int m_count = 0;
+
+    // The bin currently being filled
+    qint64 m_openBin = -1;
+    double m_openSum = 0.0;
+    int m_openSamples = 0;
+
+    void push(float value);
+    float at(int index) const;
+};
+
+class MotionDetector
+{
+public:
+    // Analysis resolution; every input size is reduced to this first
+    static constexpr int AnalysisWidth = 160;
+    static constexpr int AnalysisHeight = 120;
+    static constexpr quint8 PixelThreshold = 12;
+    static constexpr double MovingFraction = 0.002;
+    static constexpr double BreathingPeriodicity = 0.3;
+
+    MotionDetector();
+
+    MotionReading process(const QImage &frame, qint64 timestampNs);
+    void reset();
+
+private:
+    // Two preallocated planes, swapped every frame
+    std::vector<quint8> m_previous;
+    std::vector<quint8> m_current;
+    bool m_hasPrevious = false;
+
+    BreathingTracker m_breathing;
+};
+
+// Runs a MotionDetector on whatever thread it is moved to
+class MotionMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MotionMonitor(QObject *parent = nullptr);
+
+public slots:
+    void processFrame(const QImage &image, qint64 timestampNs);
+    void reset();
+
+signals:
+    void motionUpdated(const MotionReading &reading);
+
+private:
+    MotionDetector m_detector;
+};
+
+#endif // MOTIONDETECTOR_H
@@ -0,0 +1,213 @@
+// Command-line benchmark and fuzzer for the vitals payload parser.
+//
+// Compares vitalsparser::parseFields() on the notification bytes with the
+// previous path (QString::fromUtf8, split(','), toFloat) on the same payloads:
+//
+//   parsebench [--calls 1000000]
+//   parsebench --fuzz 5000000 [--seed 1]
+//
+// The fuzzer mutates valid payloads and generates random bytes, feeds each
+// one to both parsers from an exactly sized buffer (build with
+// -fsanitize=address to catch over-reads) and fails on any disagreement that
+// is not a documented difference: the old path accepts "inf"/"nan" and
+// non-ASCII whitespace, which the byte parser rejects on purpose.
+//
+// Runs on the desktop (Linux x86) as well as on the device (adb shell).
+
+#include <QByteArray>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "vitalsparser.h"
+
+namespace {
+
+const int MAX_FIELDS = 4;
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// Mix of what the ESP32 sends and what a flaky link or old sketch produces
+const char *const PAYLOADS[] = {
+    "37.5,120", "36.9,131", "38.25,98", " 37.0 , 142 ", "37.5,120\r\n",
+    "37.5", "37.5,abc", "", "37.5,120,1",
+};
+
+// The parser the byte parser replaces; -1 if malformed, as parseFields()
+int legacyParse(const char *data, int size, float *values, int maxFields)
+{
+    const QString text = QString::fromUtf8(data, size);
+    if (text.isEmpty())
+        return 0;
+    const QStringList parts = text.split(',');
+    if (parts.size() > maxFields)
+        return -1;
+    for (int i = 0; i < parts.size(); ++i) {
+        bool ok = false;
+        values[i] = parts[i].toFloat(&ok);
+        if (!ok)
+            return -1;
+    }
+    return int(parts.size());
+}
+
+// --- Benchmark ---
+
+double timeCalls(int calls, const std::function<int(const char *, int, float *)> &parse, float &checksum)
+{
+    const int payloadCount = int(std::size(PAYLOADS));
+    std::vector<int> sizes;
+    for (const char *payload : PAYLOADS)
+        sizes.push_back(int(std::strlen(payload)));
+
+    float values[MAX_FIELDS] = {};
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < calls; ++i) {
+        const int p = i % payloadCount;
+        if (parse(PAYLOADS[p], sizes[p], values) > 0)
+            checksum += values[0];
+    }
+    return double(timer.nsecsElapsed()) / calls;
+}
+
+// --- Fuzzing ---
+
+std::vector<char> mutate(std::mt19937 &rng, const char *seed)
+{
+    static const char alphabet[] = "0123456789.,-+eE \t\r\ninfaINx";
+    std::vector<char> bytes(seed, seed + std::strlen(seed));
+    const int edits = 1 + int(rng() % 4);
+    for (int e = 0; e < edits; ++e) {
+        const char c = (rng() % 8 == 0) ? char(rng() % 256) : alphabet[rng() % (sizeof(alphabet) - 1)];
+        const size_t at = bytes.empty() ? 0 : rng() % (bytes.size() + 1);
+        switch (rng() % 3) {
+        case 0: bytes.insert(bytes.begin() + at, c); break;
+        case 1: if (at < bytes.size()) bytes.erase(bytes.begin() + at); break;
+        default: if (at < bytes.size()) bytes[at] = c; break;
+        }
+    }
+    return bytes;
+}
+
+std::vector<char> randomBytes(std::mt19937 &rng)
+{
+    std::vector<char> bytes(rng() % 24);
+    for (char &c : bytes)
+        c = char(rng() % 256);
+    return bytes;
+}
+
+bool isAscii(const std::vector<char> &bytes)
+{
+    for (char c : bytes) {
+        if (static_cast<unsigned char>(c) >= 0x80)
+            return false;
+    }
+    return true;
+}
+
+// Returns the number of unexplained disagreements
+quint64 fuzz(quint64 iterations, quint32 seed)
+{
+    std::mt19937 rng(seed);
+    quint64 mismatches = 0;
+    quint64 accepted = 0;
+    quint64 documented = 0;
+
+    for (quint64 i = 0; i < iterations; ++i) {
+        // Exactly sized heap buffer: any read past the end is an ASan error
+        const std::vector<char> bytes = (i % 4 == 3) ? randomBytes(rng)
+                                                     : mutate(rng, PAYLOADS[rng() % std::size(PAYLOADS)]);
+        const char *begin = bytes.empty() ? nullptr : bytes.data();
+        float fast[MAX_FIELDS] = {};
+        float legacy[MAX_FIELDS] = {};
+        const int fastCount = vitalsparser::parseFields(begin, begin + bytes.size(), fast, MAX_FIELDS);
+        const int legacyCount = legacyParse(begin, int(bytes.size()), legacy, MAX_FIELDS);
+
+        bool agree = (fastCount == legacyCount);
+        for (int f = 0; agree && f < fastCount; ++f)
+            agree = (fast[f] == legacy[f]) && std::isfinite(fast[f]);
+        if (fastCount > 0)
+            ++accepted;
+        if (agree)
+            continue;
+
+        // Only rejections by the byte parser may differ, and only for a reason
+        bool explained = (fastCount < 0 && legacyCount >= 0) && !isAscii(bytes);
+        for (int f = 0; !explained && fastCount < 0 && f < legacyCount; ++f)
+            explained = !std::isfinite(legacy[f]);
+        if (explained) {
+            ++documented;
+            continue;
+        }
+
+        if (++mismatches <= 20) {
+            err() << "MISMATCH \"" << QByteArray(begin, qsizetype(bytes.size())).toHex(' ') << "\": parser "
+                  << fastCount << ", legacy " << legacyCount << Qt::endl;
+        }
+    }
+
+    out() << "Fuzzed " << iterations << " payloads (seed " << seed << "): " << accepted << " accepted, "
+          << documented << " documented differences, " << mismatches << " mismatches" << Qt::endl;
+    return mismatches;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("parsebench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks and fuzzes the vitals payload parser against the QString path.");
+    parser.addHelpOption();
+    QCommandLineOption callsOption({"n", "calls"}, "Payloads parsed per variant.", "count", "1000000");
+    QCommandLineOption fuzzOption("fuzz", "Fuzz both parsers with this many payloads instead.", "count");
+    QCommandLineOption seedOption("seed", "Fuzzer seed.", "seed", "1");
+    parser.addOptions({callsOption, fuzzOption, seedOption});
+    parser.process(app);
+
+    if (parser.isSet(fuzzOption)) {
+        const quint64 iterations = qMax<quint64>(1, parser.value(fuzzOption).toULongLong());
+        return fuzz(iterations, parser.value(seedOption).toUInt()) == 0 ? 0 : 2;
+    }
+
+    const int calls = qMax(1, parser.value(callsOption).toInt());
+    float checksum = 0.0f;
+    const double legacyNs = timeCalls(calls, [](const char *data, int size, float *values) {
+        return legacyParse(data, size, values, MAX_FIELDS);
+    }, checksum);
+    const double fastNs = timeCalls(calls, [](const char *data, int size, float *values) {
+        return vitalsparser::parseFields(data, data + size, values, MAX_FIELDS);
+    }, checksum);
+
+    out() << "Payloads per variant: " << calls << " (" << std::size(PAYLOADS) << " distinct, checksum "
+          << checksum << ")" << Qt::endl;
+    out() << "QString split/toFloat: " << QString::number(legacyNs, 'f', 1) << " ns/payload" << Qt::endl;
+    out() << "vitalsparser:          " << QString::number(fastNs, 'f', 1) << " ns/payload, no allocations"
+          << Qt::endl;
+    out() << "Speed-up:              " << QString::number(fastNs > 0 ? legacyNs / fastNs : 0.0, 'f', 1) << "x"
+          << Qt::endl;
+    return 0;
+}
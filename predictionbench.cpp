@@ -0,0 +1,390 @@
+// Cost of handing a prediction to the UI, and how often the shown state flips.
+//
+//   predictionbench [--predictions 100000] [--smoothing 0.3:0.6:0.4]
+//   predictionbench --scores scores.csv
+//
+// Per-prediction cost compares the former path (format label and scores into
+// a QString, parse the label back out, copy the probabilities into a QList
+// for predictionMade) with the typed one (PredictionResult plus RiskSmoother),
+// in nanoseconds and heap allocations.
+//
+// Flapping counts the state changes, i.e. tile repaints and notifications,
+// over a night of predictions every 10 s, raw (label 1 = at risk) and
+// smoothed. Without --scores the night is simulated: a borderline baseline
+// with noisy at-risk episodes, which also gives the delay until an episode is
+// shown and how many are missed. --scores reads the per-row output of
+// sessionscore (p_class0 column) instead.
+//
+// The ensemble case runs the same smoother behind each combination policy of
+// EnsembleRunner on a simulated ensemble of three specialist models, where
+// every episode is seen by one or two of them.
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QTextStream>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "ensemblerunner.h"
+#include "predictionresult.h"
+#include "risksmoother.h"
+
+// --- Allocation Counting ---
+
+static std::atomic<quint64> g_allocations{0};
+
+void *operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// One prediction every 10 s
+const int PREDICTIONS_PER_NIGHT = 12 * 360;
+
+struct Cost {
+    double nsPerPrediction = 0.0;
+    double allocationsPerPrediction = 0.0;
+};
+
+// Keeps results alive so the optimizer cannot drop the work
+volatile qint64 g_sink = 0;
+
+template <typename Step>
+Cost timePredictions(const std::vector<std::vector<float>> &scores, int predictions, Step step)
+{
+    for (int i = 0; i < 100; ++i)
+        step(scores[size_t(i) % scores.size()]);
+    const quint64 allocationsBefore = g_allocations.load();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < predictions; ++i)
+        step(scores[size_t(i) % scores.size()]);
+    Cost cost;
+    cost.nsPerPrediction = double(timer.nsecsElapsed()) / predictions;
+    cost.allocationsPerPrediction = double(g_allocations.load() - allocationsBefore) / predictions;
+    return cost;
+}
+
+// --- Flapping ---
+
+struct Night {
+    std::vector<float> risk;
+    // Simulated ground truth, empty for recorded scores
+    std::vector<bool> episode;
+};
+
+// Baseline risk around 0.4 with the noise of a borderline patient, and an
+// episode at 0.7 for 5 to 30 minutes roughly every 2 hours
+Night simulateNight(std::mt19937 &random)
+{
+    Night night;
+    std::normal_distribution<float> noise(0.0f, 0.15f);
+    std::uniform_int_distribution<int> gap(6 * 60, 18 * 60);
+    std::uniform_int_distribution<int> length(30, 180);
+    int nextEpisode = gap(random);
+    int episodeLeft = 0;
+    for (int i = 0; i < PREDICTIONS_PER_NIGHT; ++i) {
+        if (episodeLeft == 0 && i >= nextEpisode) {
+            episodeLeft = length(random);
+            nextEpisode = i + episodeLeft + gap(random);
+        }
+        const bool inEpisode = episodeLeft > 0;
+        if (episodeLeft > 0)
+            --episodeLeft;
+        night.risk.push_back(qBound(0.0f, (inEpisode ? 0.7f : 0.4f) + noise(random), 1.0f));
+        night.episode.push_back(inEpisode);
+    }
+    return night;
+}
+
+bool loadScores(const QString &path, Night &night, QString &error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        error = QString("cannot open %1").arg(path);
+        return false;
+    }
+    QTextStream stream(&file);
+    const int column = stream.readLine().split(',').indexOf("p_class0");
+    if (column < 0) {
+        error = QString("%1 has no p_class0 column").arg(path);
+        return false;
+    }
+    while (!stream.atEnd()) {
+        const QStringList fields = stream.readLine().split(',');
+        bool ok = false;
+        const float p0 = fields.value(column).toFloat(&ok);
+        if (ok)
+            night.risk.push_back(1.0f - p0);
+    }
+    return true;
+}
+
+struct Flapping {
+    int changes = 0;
+    int episodes = 0;
+    int shown = 0;
+    // Predictions from the start of an episode until it is shown
+    qint64 delaySum = 0;
+
+    int missed() const { return episodes - shown; }
+};
+
+// A raw label is `smoothing` with alpha 1 and enter = leave = 0.5. An episode
+// counts as shown if the state goes at risk before it ends or up to
+// LATE_PREDICTIONS after.
+const int LATE_PREDICTIONS = 6;
+
+void countChanges(const Night &night, const RiskSmoother::Config &smoothing, Flapping &result)
+{
+    RiskSmoother smoother(smoothing);
+    int episodeStart = -1;
+    int deadline = -1;
+    bool shown = false;
+    for (size_t i = 0; i < night.risk.size(); ++i) {
+        const RiskSmoother::Update update = smoother.add(night.risk[i]);
+        // The first state is not a change on screen
+        if (update.changed && i > 0)
+            ++result.changes;
+        if (night.episode.empty())
+            continue;
+
+        const bool inEpisode = night.episode[i];
+        if (inEpisode && episodeStart < 0) {
+            episodeStart = int(i);
+            deadline = -1;
+            shown = false;
+            ++result.episodes;
+        }
+        if (episodeStart < 0)
+            continue;
+        if (!shown && update.state == RiskSmoother::State::AtRisk) {
+            shown = true;
+            ++result.shown;
+            result.delaySum += int(i) - episodeStart;
+        }
+        if (!inEpisode && deadline < 0)
+            deadline = int(i) + LATE_PREDICTIONS;
+        if (deadline >= 0 && (shown || int(i) >= deadline))
+            episodeStart = -1;
+    }
+}
+
+// --- Ensemble Policies ---
+
+const int ENSEMBLE_MEMBERS = 3;
+
+// Specialist models (e.g. fever, bradycardia, tachycardia): each sits around
+// 0.25 and rises to 0.75 for the episodes it recognises; an episode is seen
+// by one or two of them. `night.risk` holds member m's risk at index
+// ENSEMBLE_MEMBERS * prediction + m.
+Night simulateEnsembleNight(std::mt19937 &random)
+{
+    Night night;
+    std::normal_distribution<float> noise(0.0f, 0.12f);
+    std::uniform_int_distribution<int> gap(6 * 60, 18 * 60);
+    std::uniform_int_distribution<int> length(30, 180);
+    std::uniform_int_distribution<int> firstMember(0, ENSEMBLE_MEMBERS - 1);
+    std::uniform_int_distribution<int> memberCount(1, 2);
+    int nextEpisode = gap(random);
+    int episodeLeft = 0;
+    int seenFrom = 0;
+    int seenCount = 0;
+    for (int i = 0; i < PREDICTIONS_PER_NIGHT; ++i) {
+        if (episodeLeft == 0 && i >= nextEpisode) {
+            episodeLeft = length(random);
+            nextEpisode = i + episodeLeft + gap(random);
+            seenFrom = firstMember(random);
+            seenCount = memberCount(random);
+        }
+        const bool inEpisode = episodeLeft > 0;
+        if (episodeLeft > 0)
+            --episodeLeft;
+        for (int m = 0; m < ENSEMBLE_MEMBERS; ++m) {
+            const bool sees = inEpisode && (m - seenFrom + ENSEMBLE_MEMBERS) % ENSEMBLE_MEMBERS < seenCount;
+            night.risk.push_back(qBound(0.0f, (sees ? 0.75f : 0.25f) + noise(random), 1.0f));
+        }
+        night.episode.push_back(inEpisode);
+    }
+    return night;
+}
+
+// The risk the smoother sees for every prediction of `night` under `policy`
+Night combineNight(const Night &night, EnsembleSpec::Policy policy)
+{
+    EnsembleSpec spec;
+    spec.policy = policy;
+    spec.members.resize(ENSEMBLE_MEMBERS);
+    EnsembleResult result;
+    result.members.resize(ENSEMBLE_MEMBERS);
+    PredictionResult prediction;
+
+    Night combined;
+    combined.episode = night.episode;
+    for (size_t i = 0; i < night.episode.size(); ++i) {
+        for (int m = 0; m < ENSEMBLE_MEMBERS; ++m) {
+            const float risk = night.risk[i * ENSEMBLE_MEMBERS + size_t(m)];
+            result.members[size_t(m)].label = risk > 0.5f ? 1 : 0;
+            result.members[size_t(m)].probabilities = {1.0f - risk, risk};
+        }
+        EnsembleRunner::combine(spec, result);
+        prediction.setScores(result.label, result.probabilities);
+        combined.risk.push_back(prediction.riskProbability());
+    }
+    return combined;
+}
+
+void printFlapping(const char *name, const RiskSmoother::Config &config, const Flapping &total, size_t nights)
+{
+    out() << "  " << name << " (" << config.toString() << "): "
+          << QString::number(double(total.changes) / nights, 'f', 1) << " state changes per night";
+    if (total.episodes > 0) {
+        const double delaySeconds = total.shown > 0 ? 10.0 * total.delaySum / total.shown : 0.0;
+        out() << ", episodes shown after " << QString::number(delaySeconds, 'f', 0) << " s on average, "
+              << total.missed() << " of " << total.episodes << " missed";
+    }
+    out() << Qt::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("predictionbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Per-prediction cost of the result path and state flapping with and without smoothing.");
+    parser.addHelpOption();
+    QCommandLineOption predictionsOption({"n", "predictions"}, "Timed predictions per variant.", "count", "100000");
+    QCommandLineOption smoothingOption("smoothing", "Smoother alpha:enter:leave.", "spec", RiskSmoother::Config().toString());
+    QCommandLineOption scoresOption("scores", "Per-row scores written by sessionscore -o.", "file");
+    QCommandLineOption nightsOption("nights", "Simulated nights for the flapping count.", "count", "20");
+    parser.addOptions({predictionsOption, smoothingOption, scoresOption, nightsOption});
+    parser.process(app);
+
+    const int predictions = qMax(1, parser.value(predictionsOption).toInt());
+    RiskSmoother::Config smoothing;
+    if (!RiskSmoother::Config::parse(parser.value(smoothingOption), smoothing)) {
+        err() << "ERROR: invalid --smoothing " << parser.value(smoothingOption) << Qt::endl;
+        return 1;
+    }
+    RiskSmoother::Config raw;
+    raw.alpha = 1.0f;
+    raw.enter = 0.5f;
+    raw.leave = 0.5f;
+
+    // --- Per-prediction Cost ---
+    std::mt19937 random(2024);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::vector<std::vector<float>> scores(64);
+    for (std::vector<float> &s : scores) {
+        const float p1 = uniform(random);
+        s = {1.0f - p1, p1};
+    }
+
+    const Cost stringCost = timePredictions(scores, predictions, [](const std::vector<float> &probabilities) {
+        const int64_t predictedLabel = probabilities[1] > probabilities[0] ? 1 : 0;
+        QString probabilityString = "";
+        for (size_t i = 0; i < probabilities.size(); ++i)
+            probabilityString += QString("Class %1: %2 | ").arg(i).arg(probabilities[i], 0, 'f', 4);
+        const QString result = QString("PREDICTION_LABEL:%1 | Scores: %2 | Raw Data: Temp:%3, HR:%4")
+                                   .arg(predictedLabel).arg(probabilityString).arg(36.8, 0, 'f', 1).arg(130.0, 0, 'f', 0);
+        if (result.startsWith("PREDICTION_LABEL:")) {
+            const int label = result.mid(result.indexOf(':') + 1, 1).toInt();
+            const QList<float> emitted(probabilities.begin(), probabilities.end());
+            g_sink = g_sink + label + emitted.size();
+        }
+    });
+
+    PredictionResult result;
+    RiskSmoother smoother(smoothing);
+    const Cost typedCost = timePredictions(scores, predictions, [&](const std::vector<float> &probabilities) {
+        result.setScores(probabilities[1] > probabilities[0] ? 1 : 0, probabilities);
+        const RiskSmoother::Update update = smoother.add(result.riskProbability());
+        // By value, as a queued predictionMade() would copy it
+        const PredictionResult emitted = result;
+        g_sink = g_sink + emitted.label + update.changed;
+    });
+
+    out() << "Per prediction (" << predictions << " predictions):" << Qt::endl;
+    out() << "  QString format + parse: " << QString::number(stringCost.nsPerPrediction, 'f', 0) << " ns, "
+          << QString::number(stringCost.allocationsPerPrediction, 'f', 1) << " allocations" << Qt::endl;
+    out() << "  PredictionResult + RiskSmoother: " << QString::number(typedCost.nsPerPrediction, 'f', 0) << " ns, "
+          << QString::number(typedCost.allocationsPerPrediction, 'f', 1) << " allocations" << Qt::endl;
+
+    // --- Flapping ---
+    std::vector<Night> nights;
+    if (parser.isSet(scoresOption)) {
+        Night night;
+        QString error;
+        if (!loadScores(parser.value(scoresOption), night, error)) {
+            err() << "ERROR: " << error << Qt::endl;
+            return 1;
+        }
+        nights.push_back(night);
+        out() << "Scores: " << parser.value(scoresOption) << " (" << night.risk.size() << " predictions)" << Qt::endl;
+    } else {
+        const int count = qMax(1, parser.value(nightsOption).toInt());
+        for (int i = 0; i < count; ++i)
+            nights.push_back(simulateNight(random));
+        out() << "Simulated: " << count << " nights of " << PREDICTIONS_PER_NIGHT << " predictions" << Qt::endl;
+    }
+
+    for (const auto &[name, config] : {std::make_pair("raw label", raw), std::make_pair("smoothed", smoothing)}) {
+        Flapping total;
+        for (const Night &night : nights)
+            countChanges(night, config, total);
+        printFlapping(name, config, total, nights.size());
+    }
+
+    // --- Ensemble Policies ---
+    const size_t ensembleNights = parser.isSet(scoresOption) ? 1 : nights.size();
+    std::vector<Night> memberNights;
+    for (size_t i = 0; i < ensembleNights; ++i)
+        memberNights.push_back(simulateEnsembleNight(random));
+    out() << "Ensemble of " << ENSEMBLE_MEMBERS << " specialists, each episode seen by one or two (" << ensembleNights
+          << " simulated nights, smoothed):" << Qt::endl;
+    for (const EnsembleSpec::Policy policy : {EnsembleSpec::Policy::Mean, EnsembleSpec::Policy::Majority,
+                                              EnsembleSpec::Policy::Any}) {
+        Flapping total;
+        for (const Night &night : memberNights)
+            countChanges(combineNight(night, policy), smoothing, total);
+        printFlapping(EnsembleSpec::policyName(policy).toUtf8().constData(), smoothing, total, memberNights.size());
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+#ifndef PREDICTIONRESULT_H
+#define PREDICTIONRESULT_H
+
+#include <QMetaType>
+#include <QString>
+#include <QtGlobal>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Outcome of one classifier (or ensemble) prediction.
+//
+// The probabilities live in a fixed array, so filling a result and passing it
+// on by value never touches the heap; only a failure carries a string.
+struct PredictionResult {
+    static constexpr int MaxClasses = 8;
+
+    bool ok = false;
+    int64_t label = -1;
+    int classes = 0;
+    std::array<float, MaxClasses> probabilities = {};
+    // Set when !ok
+    QString error;
+
+    // Classes beyond MaxClasses are dropped
+    void setScores(int64_t predictedLabel, const std::vector<float> &scores)
+    {
+        ok = true;
+        label = predictedLabel;
+        classes = int(std::min<size_t>(scores.size(), MaxClasses));
+        std::copy_n(scores.begin(), classes, probabilities.begin());
+        error.clear();
+    }
+
+    void setError(const QString &message)
+    {
+        ok = false;
+        label = -1;
+        classes = 0;
+        error = message;
+    }
+
+    // Probability of any class but 0 ("normal"); for the binary classifier
+    // that is simply the at-risk probability
+    float riskProbability() const { return classes > 0 ? 1.0f - probabilities[0] : 0.0f; }
+};
+Q_DECLARE_METATYPE(PredictionResult)
+
+#endif // PREDICTIONRESULT_H
@@ -0,0 +1,47 @@
+#include "processmemory.h"
+
+#include <QByteArray>
+#include <QFile>
+
+#if defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+// Returns the value of a "Key:   1234 kB" line of /proc/self/status
+qint64 readStatusField(const char *key)
+{
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly))
+        return 0;
+
+    const QByteArray prefix = QByteArray(key) + ':';
+    const QList<QByteArray> lines = status.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.startsWith(prefix))
+            return line.mid(prefix.size()).trimmed().split(' ').value(0).toLongLong();
+    }
+    return 0;
+}
+
+} // namespace
+
+qint64 currentRssKb()
+{
+    return readStatusField("VmRSS");
+}
+
+qint64 peakRssKb()
+{
+    qint64 peak = readStatusField("VmHWM");
+#if defined(Q_OS_UNIX) && !defined(Q_OS_DARWIN)
+    if (peak == 0) {
+        // ru_maxrss is reported in kilobytes on Linux
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+            peak = usage.ru_maxrss;
+    }
+#endif
+    return peak;
+}
@@ -0,0 +1,13 @@
+#ifndef PROCESSMEMORY_H
+#define PROCESSMEMORY_H
+
+#include <QtGlobal>
+
+// Resident set size of the current process, in kilobytes.
+// Read from /proc/self/status on Linux and Android; 0 when unavailable.
+qint64 currentRssKb();
+
+// High-water mark of the resident set size since process start (VmHWM)
+qint64 peakRssKb();
+
+#endif // PROCESSMEMORY_H
@@ -0,0 +1,325 @@
+// Frame-time benchmark of the Qt Quick dashboard against the widget UI.
+//
+//   quickbench [--frames 1000] [--rhi]
+//
+// Both front-ends get the same stream of samples at the window size of
+// Main.qml (640x560), and every sample is followed by one full frame: the
+// Quick scene (the dashboard's tiles, prediction tile and two WaveformItem
+// traces) through QQuickWindow::grabWindow(), the widget page (status label,
+// VitalsTile tiles, prediction tile and buttons as laid out in GuiWindow)
+// through QWidget::grab(). Frame time covers the update, sync/polish and rendering
+// into an image, and is reported as percentiles.
+//
+// The Quick scene uses the software scene graph by default, so that both
+// sides rasterize on the CPU; --rhi uses the default graphics backend instead
+// (the grab then includes a read-back from the GPU).
+//
+// Runs offscreen unless QT_QPA_PLATFORM is set, on the desktop or the device.
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QHBoxLayout>
+#include <QImage>
+#include <QLabel>
+#include <QPixmap>
+#include <QPushButton>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQuickWindow>
+#include <QSGRendererInterface>
+#include <QTextStream>
+#include <QVBoxLayout>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "vitalstile.h"
+#include "waveformitem.h"
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// The window size of Main.qml
+const QSize WINDOW_SIZE(640, 560);
+
+// The tiles and traces of Main.qml, without the DashboardController: the
+// benchmark sets the values and appends to the traces through addSample()
+const char *const QUICK_SCENE = R"(
+import QtQuick
+import Monitor
+
+Window {
+    id: root
+    property real temperature: 0
+    property real heartRate: 0
+
+    function addSample(t, h) {
+        temperature = t
+        heartRate = h
+        temperatureTrace.append(t)
+        heartRateTrace.append(h)
+    }
+
+    color: "#FFFFFF"
+
+    component VitalTile: Rectangle {
+        property alias caption: captionText.text
+        property alias value: valueText.text
+        property alias textColor: valueText.color
+        radius: 8
+        border.width: 1
+        height: 80
+        Column {
+            anchors.centerIn: parent
+            Text { id: captionText; anchors.horizontalCenter: parent.horizontalCenter
+                   font.pixelSize: 16; font.bold: true; color: valueText.color }
+            Text { id: valueText; anchors.horizontalCenter: parent.horizontalCenter
+                   font.pixelSize: 20; font.bold: true }
+        }
+    }
+
+    Column {
+        anchors.fill: parent
+        anchors.margins: 10
+        spacing: 10
+
+        Text {
+            width: parent.width
+            text: "Status: Subscribed to notifications."
+            color: "#10B981"
+            font.pixelSize: 18
+            font.bold: true
+        }
+        Row {
+            width: parent.width
+            spacing: 20
+            VitalTile {
+                width: (parent.width - parent.spacing) / 2
+                color: "#E0F2F1"; border.color: "#B2DFDB"; textColor: "#004D40"
+                caption: "Temperature"
+                value: root.temperature.toFixed(1) + " °C"
+            }
+            VitalTile {
+                width: (parent.width - parent.spacing) / 2
+                color: "#E3F2FD"; border.color: "#BBDEFB"; textColor: "#1565C0"
+                caption: "Heart Rate"
+                value: root.heartRate.toFixed(0) + " BPM"
+            }
+        }
+        VitalTile {
+            width: parent.width
+            color: "#ECFDF5"; border.color: "#A7F3D0"; border.width: 2; textColor: "#065F46"
+            caption: "Prediction"
+            value: "✅ STATUS: NOT AT RISK (12%)"
+        }
+        WaveformItem {
+            id: temperatureTrace
+            width: parent.width; height: 100
+            minimum: 34; maximum: 40
+            color: "#004D40"
+        }
+        WaveformItem {
+            id: heartRateTrace
+            width: parent.width; height: 100
+            minimum: 60; maximum: 200
+            color: "#1565C0"
+        }
+        Row {
+            width: parent.width
+            spacing: 10
+            Rectangle {
+                width: (parent.width - parent.spacing) / 2; height: 44; radius: 8; color: "#9CA3AF"
+                Text { anchors.centerIn: parent; text: "Start Scan"; color: "white"; font.bold: true }
+            }
+            Rectangle {
+                width: (parent.width - parent.spacing) / 2; height: 44; radius: 8; color: "#DC2626"
+                Text { anchors.centerIn: parent; text: "Disconnect"; color: "white"; font.bold: true }
+            }
+        }
+    }
+}
+)";
+
+const char *const BUTTON_STYLE = "QPushButton { background-color: %1; color: white; font-weight: bold; border-radius: 8px; padding: 10px; }"
+                                 "QPushButton:disabled { background-color: #9CA3AF; }";
+
+// The parts of GuiWindow a sample touches, laid out the same way
+struct WidgetPage {
+    QWidget page;
+    QLabel *status;
+    VitalsTile *temperature;
+    VitalsTile *heartRate;
+    VitalsTile *prediction;
+
+    WidgetPage()
+    {
+        QVBoxLayout *layout = new QVBoxLayout(&page);
+        status = new QLabel("Status: <font color='#10B981'>Subscribed to notifications.</font>", &page);
+        status->setStyleSheet("font-size: 18px; font-weight: bold; padding: 5px;");
+        status->setTextFormat(Qt::RichText);
+        layout->addWidget(status);
+
+        QHBoxLayout *tiles = new QHBoxLayout();
+        tiles->setSpacing(20);
+        tiles->setContentsMargins(10, 10, 10, 10);
+        temperature = new VitalsTile(QStringLiteral("Temperature"), TileStyle::temperature(), &page);
+        temperature->setMinimumHeight(80);
+        heartRate = new VitalsTile(QStringLiteral("Heart Rate"), TileStyle::heartRate(), &page);
+        heartRate->setMinimumHeight(80);
+        tiles->addWidget(temperature);
+        tiles->addWidget(heartRate);
+        layout->addLayout(tiles);
+
+        prediction = new VitalsTile(QStringLiteral("Prediction"), TileStyle::safe(), &page);
+        prediction->setValue(QStringLiteral("✅ STATUS: NOT AT RISK"));
+        prediction->setContentsMargins(10, 10, 10, 10);
+        prediction->setMinimumHeight(60);
+        layout->addWidget(prediction);
+        layout->addStretch();
+
+        QHBoxLayout *buttons = new QHBoxLayout();
+        QPushButton *scan = new QPushButton(QStringLiteral("Start Scan"), &page);
+        scan->setStyleSheet(QString(BUTTON_STYLE).arg(QStringLiteral("#2563EB")));
+        scan->setEnabled(false);
+        QPushButton *disconnect = new QPushButton(QStringLiteral("Disconnect"), &page);
+        disconnect->setStyleSheet(QString(BUTTON_STYLE).arg(QStringLiteral("#DC2626")));
+        buttons->addWidget(scan);
+        buttons->addWidget(disconnect);
+        layout->addLayout(buttons);
+
+        page.resize(WINDOW_SIZE);
+        page.ensurePolished();
+        QCoreApplication::sendPostedEvents();
+    }
+};
+
+double temperatureAt(int i)
+{
+    return 36.8 + 0.3 * std::sin(i * 0.05);
+}
+
+double heartRateAt(int i)
+{
+    return 125.0 + 15.0 * std::sin(i * 0.3);
+}
+
+double percentileUs(const std::vector<qint64> &sorted, double q)
+{
+    if (sorted.empty())
+        return 0.0;
+    // Nearest-rank percentile
+    const size_t rank = size_t(std::ceil(q * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)] / 1e3;
+}
+
+// Frame times in nanoseconds, sorted; `frame(i)` updates and renders frame i
+std::vector<qint64> timeFrames(int frames, const std::function<void(int)> &frame)
+{
+    // Warm-up: fonts, glyph caches, style sheets, scene graph nodes
+    for (int i = 0; i < 30; ++i)
+        frame(i);
+    std::vector<qint64> times;
+    times.reserve(size_t(frames));
+    QElapsedTimer timer;
+    for (int i = 0; i < frames; ++i) {
+        timer.start();
+        frame(i);
+        times.push_back(timer.nsecsElapsed());
+    }
+    std::sort(times.begin(), times.end());
+    return times;
+}
+
+void report(const char *name, const std::vector<qint64> &times)
+{
+    out() << "  " << name << " us/frame: p50 " << QString::number(percentileUs(times, 0.50), 'f', 0)
+          << ", p95 " << QString::number(percentileUs(times, 0.95), 'f', 0)
+          << ", p99 " << QString::number(percentileUs(times, 0.99), 'f', 0)
+          << ", max " << QString::number(percentileUs(times, 1.0), 'f', 0) << Qt::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("quickbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Frame time of the Qt Quick dashboard against the widget UI.");
+    parser.addHelpOption();
+    QCommandLineOption framesOption({"n", "frames"}, "Frames per front-end.", "count", "1000");
+    QCommandLineOption rhiOption("rhi", "Render the Quick scene with the default graphics backend.");
+    parser.addOptions({framesOption, rhiOption});
+    parser.process(app);
+    const int frames = qMax(1, parser.value(framesOption).toInt());
+
+    if (!parser.isSet(rhiOption))
+        QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+    qmlRegisterType<WaveformItem>("Monitor", 1, 0, "WaveformItem");
+
+    // --- Qt Quick ---
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData(QUICK_SCENE, QUrl());
+    std::unique_ptr<QObject> root(component.create());
+    QQuickWindow *window = qobject_cast<QQuickWindow *>(root.get());
+    if (!window) {
+        err() << "ERROR: " << component.errorString() << Qt::endl;
+        return 1;
+    }
+    window->resize(WINDOW_SIZE);
+    window->create();
+
+    QImage quickFrame;
+    const std::vector<qint64> quickTimes = timeFrames(frames, [&](int i) {
+        QMetaObject::invokeMethod(window, "addSample", Q_ARG(QVariant, temperatureAt(i)),
+                                  Q_ARG(QVariant, heartRateAt(i)));
+        quickFrame = window->grabWindow();
+    });
+    if (quickFrame.isNull()) {
+        err() << "ERROR: the Quick scene did not render (try without --rhi)" << Qt::endl;
+        return 1;
+    }
+    const QString quickBackend = window->rendererInterface()
+        ? (window->rendererInterface()->graphicsApi() == QSGRendererInterface::Software ? "software" : "rhi")
+        : "unknown";
+
+    // --- Widgets ---
+    WidgetPage widgets;
+    QPixmap widgetFrame;
+    const std::vector<qint64> widgetTimes = timeFrames(frames, [&](int i) {
+        widgets.temperature->setValue(QString("%1 °C").arg(temperatureAt(i), 0, 'f', 1));
+        widgets.heartRate->setValue(QString("%1 BPM").arg(heartRateAt(i), 0, 'f', 0));
+        QCoreApplication::sendPostedEvents();
+        widgetFrame = widgets.page.grab();
+    });
+
+    // --- Report ---
+    out() << "Frames: " << frames << " at " << WINDOW_SIZE.width() << "x" << WINDOW_SIZE.height() << " ("
+          << QGuiApplication::platformName() << ", Quick scene graph " << quickBackend << ")" << Qt::endl;
+    report("Qt Quick (tiles + 2 traces)", quickTimes);
+    report("Widgets (tiles, no traces)", widgetTimes);
+    const double quickP50 = percentileUs(quickTimes, 0.50);
+    out() << "  Widgets / Quick at p50: "
+          << QString::number(quickP50 > 0 ? percentileUs(widgetTimes, 0.50) / quickP50 : 0.0, 'f', 2) << "x"
+          << Qt::endl;
+    return 0;
+}
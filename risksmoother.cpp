@@ -0,0 +1,65 @@
+#include "risksmoother.h"
+
+#include <cmath>
+
+RiskSmoother::Update RiskSmoother::add(float riskProbability)
+{
+    // A NaN would stick in the average forever
+    if (!std::isfinite(riskProbability))
+        return Update{m_state, m_smoothed, false};
+
+    const State previous = m_state;
+    if (m_state == State::Unknown) {
+        // The first prediction decides on its own, at the midpoint of the band
+        m_smoothed = riskProbability;
+        m_state = (m_smoothed >= (m_config.enter + m_config.leave) / 2.0f) ? State::AtRisk : State::Normal;
+    } else {
+        m_smoothed += m_config.alpha * (riskProbability - m_smoothed);
+        if (m_state == State::Normal && m_smoothed >= m_config.enter)
+            m_state = State::AtRisk;
+        else if (m_state == State::AtRisk && m_smoothed <= m_config.leave)
+            m_state = State::Normal;
+    }
+    return Update{m_state, m_smoothed, m_state != previous};
+}
+
+void RiskSmoother::reset()
+{
+    m_state = State::Unknown;
+    m_smoothed = 0.0f;
+}
+
+// --- Config ---
+
+bool RiskSmoother::Config::parse(const QString &spec, Config &config)
+{
+    const QStringList parts = spec.split(':');
+    if (parts.size() != 3)
+        return false;
+    Config parsed;
+    bool ok[3] = {};
+    parsed.alpha = parts[0].trimmed().toFloat(&ok[0]);
+    parsed.enter = parts[1].trimmed().toFloat(&ok[1]);
+    parsed.leave = parts[2].trimmed().toFloat(&ok[2]);
+    if (!ok[0] || !ok[1] || !ok[2])
+        return false;
+    if (!(parsed.alpha > 0.0f && parsed.alpha <= 1.0f) || !(parsed.leave >= 0.0f && parsed.leave <= parsed.enter
+                                                            && parsed.enter <= 1.0f))
+        return false;
+    config = parsed;
+    return true;
+}
+
+RiskSmoother::Config RiskSmoother::Config::fromArguments(const QStringList &arguments)
+{
+    Config config;
+    const int index = arguments.indexOf("--smoothing");
+    if (index >= 0 && !parse(arguments.value(index + 1), config))
+        config = Config();
+    return config;
+}
+
+QString RiskSmoother::Config::toString() const
+{
+    return QString("%1:%2:%3").arg(alpha).arg(enter).arg(leave);
+}
@@ -0,0 +1,58 @@
+#ifndef RISKSMOOTHER_H
+#define RISKSMOOTHER_H
+
+#include <QString>
+#include <QStringList>
+
+// Turns the stream of per-prediction risk probabilities into a stable
+// at-risk / normal state.
+//
+// The probability is smoothed with an exponential moving average, and the
+// state only changes when the average crosses the threshold on the far side:
+// it enters "at risk" at or above `enter` and leaves it at or below `leave`.
+// A model hovering around 0.5 therefore no longer flips the UI and the
+// notification every 10 s. Each update is a few float operations.
+class RiskSmoother
+{
+public:
+    enum class State { Unknown, Normal, AtRisk };
+
+    struct Config {
+        // Weight of the newest probability; 1 disables smoothing
+        float alpha = 0.3f;
+        float enter = 0.6f;
+        float leave = 0.4f;
+
+        // "alpha:enter:leave", e.g. "0.3:0.6:0.4"; false unless
+        // 0 < alpha <= 1 and 0 <= leave <= enter <= 1
+        static bool parse(const QString &spec, Config &config);
+        // From "--smoothing <spec>" in `arguments`, else the defaults
+        static Config fromArguments(const QStringList &arguments);
+        QString toString() const;
+    };
+
+    struct Update {
+        State state = State::Unknown;
+        float smoothed = 0.0f;
+        // The state differs from the one before this update
+        bool changed = false;
+    };
+
+    RiskSmoother() = default;
+    explicit RiskSmoother(const Config &config) : m_config(config) {}
+
+    Update add(float riskProbability);
+    // Forget the average and the state, e.g. for a new patient profile
+    void reset();
+
+    State state() const { return m_state; }
+    float smoothed() const { return m_smoothed; }
+    const Config &config() const { return m_config; }
+
+private:
+    Config m_config;
+    State m_state = State::Unknown;
+    float m_smoothed = 0.0f;
+};
+
+#endif // RISKSMOOTHER_H
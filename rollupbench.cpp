@@ -0,0 +1,138 @@
+// Footprint and per-update cost of the vitals trend rollup.
+//
+// Feeds a simulated stretch of monitoring (7 days at the sensor rate by
+// default) into a VitalsRollup, as GuiWindow does for every sample, and
+// reports the memory it holds against keeping every raw sample, the buckets
+// retained per tier, nanoseconds and heap allocations per update, and the
+// cost of the last-hour summary shown under the tiles.
+//
+//   rollupbench [--days 7] [--rate 1]
+//
+// Runs on the desktop (Linux x86) as well as on the device (adb shell).
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "vitalsrollup.h"
+
+// --- Allocation Counting ---
+
+static std::atomic<quint64> g_allocations{0};
+
+void *operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+const char *const TIER_NAMES[] = {"per second", "per minute", "per hour"};
+
+// Keeps results alive so the optimizer cannot drop the work
+volatile double g_sink = 0.0;
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("rollupbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Footprint and per-update cost of the vitals trend rollup.");
+    parser.addHelpOption();
+    QCommandLineOption daysOption("days", "Simulated monitoring time.", "days", "7");
+    QCommandLineOption rateOption({"r", "rate"}, "Samples per second.", "hz", "1");
+    parser.addOptions({daysOption, rateOption});
+    parser.process(app);
+
+    const double days = qBound(0.01, parser.value(daysOption).toDouble(), 365.0);
+    const int rate = qBound(1, parser.value(rateOption).toInt(), 1000);
+    const qint64 intervalMs = 1000 / rate;
+    const quint64 samples = quint64(days * 86400.0 * rate);
+
+    // Values are drawn up front so that only the rollup is timed
+    std::mt19937 random(1);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<float> temperature(4096);
+    std::vector<float> heartRate(temperature.size());
+    for (size_t i = 0; i < temperature.size(); ++i) {
+        temperature[i] = 36.8f + 0.2f * noise(random);
+        heartRate[i] = 125.0f + 8.0f * noise(random);
+    }
+
+    VitalsRollup rollup;
+    const size_t footprintBefore = rollup.memoryFootprint();
+
+    // --- Updates ---
+    const quint64 allocationsBefore = g_allocations.load();
+    QElapsedTimer timer;
+    timer.start();
+    qint64 timestampMs = 0;
+    for (quint64 i = 0; i < samples; ++i) {
+        timestampMs += intervalMs;
+        const size_t v = size_t(i) % temperature.size();
+        rollup.add(timestampMs, temperature[v], heartRate[v]);
+    }
+    const double updateNs = samples ? double(timer.nsecsElapsed()) / samples : 0.0;
+    const quint64 updateAllocations = g_allocations.load() - allocationsBefore;
+
+    // --- Last-hour Summary ---
+    const int summaries = 10000;
+    timer.start();
+    for (int i = 0; i < summaries; ++i) {
+        const RollupBucket hour = rollup.temperature().summary(1, timestampMs - 3600 * 1000 - i % 60);
+        g_sink = g_sink + hour.mean();
+    }
+    const double summaryNs = double(timer.nsecsElapsed()) / summaries;
+
+    // --- Report ---
+    const size_t footprint = rollup.memoryFootprint();
+    const double rawBytes = double(samples) * 2 * sizeof(RollupSample);
+    out() << "Simulated: " << days << " days at " << rate << " Hz (" << samples << " samples per vital)" << Qt::endl;
+    out() << "Footprint: " << QString::number(footprint / 1024.0, 'f', 1) << " KB (" << footprintBefore
+          << " bytes at start), every raw sample would take "
+          << QString::number(rawBytes / (1024.0 * 1024.0), 'f', 1) << " MB" << Qt::endl;
+    const std::vector<RollupTier> &tiers = rollup.temperature().tiers();
+    for (size_t t = 0; t < tiers.size(); ++t) {
+        const RollupRing<RollupBucket> &buckets = tiers[t].buckets();
+        out() << "  " << (t < std::size(TIER_NAMES) ? TIER_NAMES[t] : "tier") << ": " << buckets.size() << " of "
+              << buckets.capacity() << " buckets, covering "
+              << QString::number(double(buckets.size()) * tiers[t].bucketMs() / 3600000.0, 'f', 1) << " h"
+              << Qt::endl;
+    }
+    out() << "  raw: " << rollup.temperature().raw().size() << " samples" << Qt::endl;
+    out() << "Update (both vitals): " << QString::number(updateNs, 'f', 1) << " ns, "
+          << QString::number(samples ? double(updateAllocations) / samples : 0.0, 'f', 3) << " allocations" << Qt::endl;
+    out() << "Last-hour summary: " << QString::number(summaryNs, 'f', 0) << " ns" << Qt::endl;
+    return footprint == footprintBefore && updateAllocations == 0 ? 0 : 2;
+}
@@ -0,0 +1,308 @@
+// Offline re-scoring of a recorded night with the health classifier.
+//
+// Reads a vitals recording and a patient profile, shards the rows across a
+// pool of worker threads (one inference session each, single-threaded inside)
+// and writes the label and class probabilities of every row as CSV:
+//
+//   sessionscore --model health_classifier.onnx --profile baby.csv --vitals night.csv -o scores.csv
+//   sessionscore --model health_classifier.onnx --profile baby.csv --vitals night.csv --scaling
+//
+// The vitals file is a dataset as read by modelbench (see vitalsdataset.h);
+// columns it lacks, usually all but temperature_c and heart_rate_bpm, come
+// from the first row of the profile CSV. --scaling re-scores the night with
+// 1, 2, 4, ... up to all cores and prints rows/second for each pool size.
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QThread>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "healthpredictor.h"
+#include "inferencememory.h"
+#include "vitalsdataset.h"
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+QTextStream &err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// Per-row result; every worker only writes the rows of its own shard
+struct RowScore {
+    int64_t label = -1;
+    std::vector<float> probabilities;
+};
+
+struct PoolRun {
+    int workers = 0;
+    // Slowest session load; not part of the scoring time
+    double setupSeconds = 0.0;
+    double scoreSeconds = 0.0;
+    QString error;
+
+    double rowsPerSecond(size_t rows) const { return scoreSeconds > 0 ? rows / scoreSeconds : 0.0; }
+};
+
+// --- Scoring ---
+
+// Scores rows [begin, end) on its own session. Waits for `start` after the
+// session is loaded so that only inference is timed.
+void scoreShard(Ort::Env &env, const std::string &modelPath, const MemoryBudget &budget,
+                const std::vector<BabyData> &rows, size_t begin, size_t end, std::vector<RowScore> &scores,
+                std::atomic<int> &ready, const std::atomic<bool> &start, std::atomic<qint64> &setupNs,
+                QString &error)
+{
+    QElapsedTimer setup;
+    setup.start();
+    std::unique_ptr<HealthPredictor> predictor;
+    try {
+        predictor = std::make_unique<HealthPredictor>(env, modelPath, budget.sessionOptions(1));
+        predictor->validateSignature();
+    } catch (const Ort::Exception &e) {
+        error = QString("ONNX Runtime Error: %1").arg(e.what());
+    }
+
+    qint64 elapsed = setup.nsecsElapsed();
+    qint64 slowest = setupNs.load();
+    while (elapsed > slowest && !setupNs.compare_exchange_weak(slowest, elapsed)) {}
+    ++ready;
+    while (!start.load(std::memory_order_acquire))
+        std::this_thread::yield();
+    if (!predictor)
+        return;
+
+    try {
+        // Bound once per profile; a recording usually has just one
+        HealthInputs inputs;
+        const BabyData *boundProfile = nullptr;
+        for (size_t i = begin; i < end; ++i) {
+            const BabyData &row = rows[i];
+            if (!boundProfile || !vitalsdataset::sameProfile(*boundProfile, row))
+                inputs.setProfile(row);
+            else
+                inputs.setVitals(row.temperature_c, row.heart_rate_bpm);
+            boundProfile = &row;
+            scores[i].label = predictor->predict(inputs, &scores[i].probabilities);
+        }
+    } catch (const Ort::Exception &e) {
+        error = QString("ONNX Runtime Error: %1").arg(e.what());
+    }
+}
+
+// Contiguous shards, one per worker, sizes differing by at most one row
+PoolRun scoreAll(Ort::Env &env, const QString &modelPath, const MemoryBudget &budget,
+                 const std::vector<BabyData> &rows, int workers, std::vector<RowScore> &scores)
+{
+    PoolRun run;
+    run.workers = workers;
+    scores.assign(rows.size(), RowScore());
+
+    std::atomic<int> ready{0};
+    std::atomic<bool> start{false};
+    std::atomic<qint64> setupNs{0};
+    std::vector<QString> errors(size_t(workers));
+    std::vector<std::thread> threads;
+    threads.reserve(size_t(workers));
+
+    const std::string path = modelPath.toStdString();
+    const size_t shard = rows.size() / size_t(workers);
+    const size_t remainder = rows.size() % size_t(workers);
+    size_t begin = 0;
+    for (int w = 0; w < workers; ++w) {
+        const size_t end = begin + shard + (size_t(w) < remainder ? 1 : 0);
+        threads.emplace_back(scoreShard, std::ref(env), std::cref(path), std::cref(budget), std::cref(rows),
+                             begin, end, std::ref(scores), std::ref(ready), std::cref(start), std::ref(setupNs),
+                             std::ref(errors[size_t(w)]));
+        begin = end;
+    }
+
+    while (ready.load() < workers)
+        std::this_thread::yield();
+    QElapsedTimer timer;
+    timer.start();
+    start.store(true, std::memory_order_release);
+    for (std::thread &thread : threads)
+        thread.join();
+    run.scoreSeconds = timer.nsecsElapsed() / 1e9;
+    run.setupSeconds = setupNs.load() / 1e9;
+
+    for (const QString &error : errors) {
+        if (!error.isEmpty()) {
+            run.error = error;
+            break;
+        }
+    }
+    return run;
+}
+
+// --- Output ---
+
+bool writeScores(const QString &path, const std::vector<BabyData> &rows, const std::vector<RowScore> &scores)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+        return false;
+
+    const size_t classes = scores.empty() ? 0 : scores.front().probabilities.size();
+    QTextStream stream(&file);
+    stream << "row,temperature_c,heart_rate_bpm,label";
+    for (size_t c = 0; c < classes; ++c)
+        stream << ",p_class" << c;
+    stream << '\n';
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        stream << i << ',' << QString::number(rows[i].temperature_c, 'f', 2)
+               << ',' << QString::number(rows[i].heart_rate_bpm, 'f', 1) << ',' << scores[i].label;
+        for (float p : scores[i].probabilities)
+            stream << ',' << QString::number(p, 'f', 6);
+        stream << '\n';
+    }
+    return stream.status() == QTextStream::Ok;
+}
+
+// 1, 2, 4, ... and finally `maxWorkers` itself
+std::vector<int> scalingSteps(int maxWorkers)
+{
+    std::vector<int> steps;
+    for (int workers = 1; workers < maxWorkers; workers *= 2)
+        steps.push_back(workers);
+    steps.push_back(maxWorkers);
+    return steps;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("sessionscore");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Re-scores a recorded vitals session with a health classifier model.");
+    parser.addHelpOption();
+    QCommandLineOption modelOption({"m", "model"}, "Classifier .onnx model.", "model");
+    QCommandLineOption vitalsOption({"v", "vitals"}, "Recorded vitals (CSV with header, or VTLS binary).", "file");
+    QCommandLineOption profileOption({"p", "profile"}, "CSV with a header and one row of profile values.", "file");
+    QCommandLineOption outputOption({"o", "output"}, "Per-row labels and probabilities (CSV).", "file");
+    QCommandLineOption threadsOption({"t", "threads"}, "Worker threads, one session each (default: all cores).", "count");
+    QCommandLineOption scalingOption("scaling", "Score with 1, 2, 4, ... up to --threads workers and report rows/s.");
+    QCommandLineOption arenaOption("arena", "Memory budget: default, limited[:MB] or off.", "spec", "default");
+    parser.addOptions({modelOption, vitalsOption, profileOption, outputOption, threadsOption, scalingOption, arenaOption});
+    parser.process(app);
+
+    if (!parser.isSet(modelOption) || !parser.isSet(vitalsOption))
+        parser.showHelp(1);
+
+    // --- Load the Recording ---
+    QString error;
+    BabyData profile;
+    if (parser.isSet(profileOption)) {
+        std::vector<BabyData> profileRows;
+        if (!vitalsdataset::loadCsv(parser.value(profileOption), profileRows, error, &profile)) {
+            err() << "ERROR: " << error << Qt::endl;
+            return 1;
+        }
+        if (profileRows.empty()) {
+            err() << "ERROR: " << parser.value(profileOption) << " has no profile row" << Qt::endl;
+            return 1;
+        }
+        profile = profileRows.front();
+    }
+
+    std::vector<BabyData> rows;
+    if (!vitalsdataset::load(parser.value(vitalsOption), rows, error, &profile)) {
+        err() << "ERROR: " << error << Qt::endl;
+        return 1;
+    }
+    if (rows.empty()) {
+        err() << "ERROR: " << parser.value(vitalsOption) << " has no rows" << Qt::endl;
+        return 1;
+    }
+
+    const int maxWorkers = parser.isSet(threadsOption) ? qMax(1, parser.value(threadsOption).toInt())
+                                                       : qMax(1, QThread::idealThreadCount());
+    MemoryBudget budget;
+    if (!MemoryBudget::parse(parser.value(arenaOption), budget)) {
+        err() << "ERROR: invalid --arena " << parser.value(arenaOption) << Qt::endl;
+        return 1;
+    }
+
+    Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "SessionScore");
+    budget.registerSharedAllocator(env);
+
+    out() << "Vitals: " << parser.value(vitalsOption) << " (" << rows.size() << " rows), cores: "
+          << QThread::idealThreadCount() << Qt::endl;
+
+    // --- Score ---
+    const std::vector<int> steps = parser.isSet(scalingOption) ? scalingSteps(maxWorkers)
+                                                               : std::vector<int>{maxWorkers};
+    std::vector<RowScore> scores;
+    std::vector<int64_t> baselineLabels;
+    double baselineRate = 0.0;
+
+    out() << Qt::left << qSetFieldWidth(10) << "workers"
+          << qSetFieldWidth(12) << "load ms" << "score s" << "rows/s" << "speedup" << "efficiency"
+          << qSetFieldWidth(0) << Qt::endl;
+    for (int workers : steps) {
+        const PoolRun run = scoreAll(env, parser.value(modelOption), budget, rows, workers, scores);
+        if (!run.error.isEmpty()) {
+            err() << "ERROR: " << run.error << Qt::endl;
+            return 1;
+        }
+
+        const double rate = run.rowsPerSecond(rows.size());
+        if (baselineRate == 0.0)
+            baselineRate = rate;
+        const double speedup = baselineRate > 0 ? rate / baselineRate : 0.0;
+        out() << qSetFieldWidth(10) << QString::number(workers)
+              << qSetFieldWidth(12) << QString::number(run.setupSeconds * 1000.0, 'f', 1)
+              << QString::number(run.scoreSeconds, 'f', 3)
+              << QString::number(rate, 'f', 0)
+              << QString::number(speedup, 'f', 2)
+              << QString::number(100.0 * speedup / workers, 'f', 0) + "%"
+              << qSetFieldWidth(0) << Qt::endl;
+
+        // Sharding must not change a single label
+        if (baselineLabels.empty()) {
+            for (const RowScore &score : scores)
+                baselineLabels.push_back(score.label);
+        } else {
+            for (size_t i = 0; i < rows.size(); ++i) {
+                if (scores[i].label != baselineLabels[i]) {
+                    err() << "ERROR: row " << i << " scored " << scores[i].label << " with " << workers
+                          << " workers but " << baselineLabels[i] << " with " << steps.front() << Qt::endl;
+                    return 2;
+                }
+            }
+        }
+    }
+
+    size_t atRisk = 0;
+    for (const RowScore &score : scores)
+        atRisk += (score.label == 1);
+    out() << "At risk: " << atRisk << " of " << rows.size() << " rows" << Qt::endl;
+
+    if (parser.isSet(outputOption)) {
+        if (!writeScores(parser.value(outputOption), rows, scores)) {
+            err() << "ERROR: cannot write " << parser.value(outputOption) << Qt::endl;
+            return 1;
+        }
+        out() << "Scores: " << parser.value(outputOption) << Qt::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,443 @@
+#include "structuredlogger.h"
+
+#include <QThread>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef Q_OS_ANDROID
+#include <android/log.h>
+#endif
+
+namespace {
+
+const std::chrono::milliseconds FLUSH_INTERVAL(100);
+
+inline qint64 steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char *levelName(LogLevel level)
+{
+    switch (level) {
+    case LogLevel::Trace: return "trace";
+    case LogLevel::Debug: return "debug";
+    case LogLevel::Info: return "info";
+    case LogLevel::Warning: return "warning";
+    case LogLevel::Error: return "error";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+// --- LogThreadBuffer ---
+
+// Single producer (the owning thread), single consumer (the flush thread)
+class LogThreadBuffer
+{
+public:
+    static constexpr quint32 Capacity = 256;
+
+    explicit LogThreadBuffer(const std::string &threadName) : m_threadName(threadName) {}
+
+    // Producer side: the slot to fill, or nullptr if the ring is full
+    LogRecord *reserve()
+    {
+        const quint32 head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) >= Capacity) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &m_records[head % Capacity];
+    }
+
+    void commit()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer side
+    template <typename Function>
+    void drain(Function &&consume)
+    {
+        quint32 tail = m_tail.load(std::memory_order_relaxed);
+        const quint32 head = m_head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail)
+            consume(m_records[tail % Capacity]);
+        m_tail.store(tail, std::memory_order_release);
+    }
+
+    const std::string &threadName() const { return m_threadName; }
+    quint64 dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // Set when the owning thread exits; the flush thread frees the buffer
+    std::atomic<bool> retired{false};
+
+private:
+    std::atomic<quint32> m_head{0};
+    std::atomic<quint32> m_tail{0};
+    std::atomic<quint64> m_dropped{0};
+    std::string m_threadName;
+    std::array<LogRecord, Capacity> m_records;
+};
+
+// --- Registry and Flush Thread ---
+
+namespace {
+
+class LogRegistry
+{
+public:
+    static LogRegistry &instance()
+    {
+        static LogRegistry registry;
+        return registry;
+    }
+
+    ~LogRegistry() { stop(); }
+
+    LogThreadBuffer *registerThread()
+    {
+        QThread *thread = QThread::currentThread();
+        std::string name = thread ? thread->objectName().toStdString() : std::string();
+        if (name.empty())
+            name = std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()) % 100000);
+
+        LogThreadBuffer *buffer = new LogThreadBuffer(name);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_buffers.push_back(buffer);
+        }
+        start();
+        return buffer;
+    }
+
+    // Idempotent; does nothing once stop() ran, so a thread that logs during
+    // exit cannot bring the flush thread back after shutdown
+    void start()
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        if (m_running || m_stopped)
+            return;
+        m_running = true;
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_stopped = true;
+            if (!m_running)
+                return;
+            m_running = false;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+        flush();
+    }
+
+    // After every commit. Only the first record after a flush (or an urgent
+    // one) takes the wake mutex; the rest are a single atomic exchange.
+    void recordCommitted(bool urgent)
+    {
+        const bool wasPending = m_pending.exchange(true);
+        if (urgent)
+            m_urgent.store(true);
+        if (!wasPending || urgent) {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_wake.notify_one();
+        }
+    }
+
+    quint64 dropped()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        quint64 total = m_retiredDropped;
+        for (const LogThreadBuffer *buffer : m_buffers)
+            total += buffer->dropped();
+        return total;
+    }
+
+private:
+    // Guards m_buffers, m_retiredDropped and m_batch
+    std::mutex m_mutex;
+    // Guards m_running, m_stopped and the sleep of the flush thread
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::thread m_thread;
+    bool m_running = false;
+    bool m_stopped = false;
+    std::atomic<bool> m_pending{false};
+    std::atomic<bool> m_urgent{false};
+    std::vector<LogThreadBuffer *> m_buffers;
+    quint64 m_retiredDropped = 0;
+    std::string m_batch;
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        while (m_running) {
+            // Idle until a record arrives: no periodic wake-ups
+            m_wake.wait(lock, [this]() { return !m_running || m_pending.load(); });
+            // Then give the burst up to FLUSH_INTERVAL to batch, unless it is urgent
+            m_wake.wait_for(lock, FLUSH_INTERVAL, [this]() { return !m_running || m_urgent.load(); });
+            // Reading the flag also makes every record committed before it visible
+            m_pending.exchange(false);
+            m_urgent.store(false);
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_buffers.begin(); it != m_buffers.end();) {
+            LogThreadBuffer *buffer = *it;
+            // Read the flag first: once set, nothing new can be committed
+            const bool retired = buffer->retired.load(std::memory_order_acquire);
+            buffer->drain([this, buffer](const LogRecord &record) { format(record, buffer->threadName()); });
+            if (retired) {
+                m_retiredDropped += buffer->dropped();
+                delete buffer;
+                it = m_buffers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        write();
+    }
+
+    void format(const LogRecord &record, const std::string &threadName)
+    {
+        char line[512];
+        int used = std::snprintf(line, sizeof(line), "ts=%.6f level=%s thread=%s event=%s",
+                                 record.timestampNs / 1e9, levelName(record.level),
+                                 threadName.c_str(), record.event);
+        for (int i = 0; i < record.fieldCount && used > 0 && used < int(sizeof(line)); ++i) {
+            const LogField &field = record.fields[i];
+            char *out = line + used;
+            const size_t room = sizeof(line) - size_t(used);
+            switch (field.type) {
+            case LogField::Type::Int:
+                used += std::snprintf(out, room, " %s=%lld", field.key, static_cast<long long>(field.intValue));
+                break;
+            case LogField::Type::Double:
+                used += std::snprintf(out, room, " %s=%g", field.key, field.doubleValue);
+                break;
+            case LogField::Type::Bool:
+                used += std::snprintf(out, room, " %s=%s", field.key, field.intValue ? "true" : "false");
+                break;
+            case LogField::Type::Text:
+                used += std::snprintf(out, room, " %s=\"%.*s\"", field.key, int(field.textLength),
+                                      record.text + field.textOffset);
+                break;
+            }
+        }
+
+#ifdef Q_OS_ANDROID
+        const int priority = record.level >= LogLevel::Error ? ANDROID_LOG_ERROR
+                             : record.level >= LogLevel::Warning ? ANDROID_LOG_WARN
+                             : record.level >= LogLevel::Info ? ANDROID_LOG_INFO
+                                                              : ANDROID_LOG_DEBUG;
+        __android_log_write(priority, "monitor", line);
+#else
+        m_batch.append(line);
+        m_batch.push_back('\n');
+#endif
+    }
+
+    void write()
+    {
+        // One write per flush pass instead of one per record
+        if (m_batch.empty())
+            return;
+        std::fwrite(m_batch.data(), 1, m_batch.size(), stderr);
+        std::fflush(stderr);
+        m_batch.clear();
+    }
+};
+
+// Hands the buffer back to the registry when the thread ends
+struct ThreadBufferHandle {
+    LogThreadBuffer *buffer = nullptr;
+
+    ~ThreadBufferHandle()
+    {
+        if (buffer)
+            buffer->retired.store(true, std::memory_order_release);
+    }
+};
+
+thread_local ThreadBufferHandle t_handle;
+
+LogThreadBuffer *currentThreadBuffer()
+{
+    if (!t_handle.buffer)
+        t_handle.buffer = LogRegistry::instance().registerThread();
+    return t_handle.buffer;
+}
+
+} // namespace
+
+// --- LogLine ---
+
+LogLine::LogLine(LogLevel level, const char *event)
+    : m_buffer(currentThreadBuffer()), m_record(m_buffer->reserve())
+{
+    if (!m_record)
+        return;
+    m_record->timestampNs = steadyNowNs();
+    m_record->event = event;
+    m_record->level = level;
+    m_record->fieldCount = 0;
+    m_record->textUsed = 0;
+}
+
+LogLine::~LogLine()
+{
+    if (!m_record)
+        return;
+    const bool urgent = m_record->level >= LogLevel::Warning;
+    m_buffer->commit();
+    LogRegistry::instance().recordCommitted(urgent);
+}
+
+LogField *LogLine::nextField(const char *key, LogField::Type type)
+{
+    if (!m_record || m_record->fieldCount == LogRecord::MaxFields)
+        return nullptr;
+    LogField *field = &m_record->fields[m_record->fieldCount++];
+    field->key = key;
+    field->type = type;
+    return field;
+}
+
+LogLine &LogLine::addInt(const char *key, qint64 value)
+{
+    if (LogField *field = nextField(key, LogField::Type::Int))
+        field->intValue = value;
+    return *this;
+}
+
+LogLine &LogLine::field(const char *key, double value)
+{
+    if (LogField *field = nextField(key, LogField::Type::Double))
+        field->doubleValue = value;
+    return *this;
+}
+
+LogLine &LogLine::field(const char *key, bool value)
+{
+    if (LogField *field = nextField(key, LogField::Type::Bool))
+        field->intValue = value ? 1 : 0;
+    return *this;
+}
+
+LogLine &LogLine::field(const char *key, const char *text)
+{
+    return addText(key, text, text ? qsizetype(std::strlen(text)) : 0);
+}
+
+LogLine &LogLine::field(const char *key, const QString &text)
+{
+    return field(key, QStringView(text));
+}
+
+LogLine &LogLine::field(const char *key, QStringView text)
+{
+    LogField *field = nextField(key, LogField::Type::Text);
+    if (!field)
+        return *this;
+
+    // UTF-16 to UTF-8 directly into the record; stops at the last whole
+    // character that fits, and replaces unpaired surrogates with U+FFFD
+    char *out = m_record->text + m_record->textUsed;
+    const char *const end = m_record->text + LogRecord::TextSize;
+    const char16_t *p = text.utf16();
+    const char16_t *const last = p + text.size();
+    while (p != last) {
+        char32_t c = *p++;
+        if (c >= 0xD800 && c <= 0xDBFF && p != last && *p >= 0xDC00 && *p <= 0xDFFF)
+            c = 0x10000 + ((c - 0xD800) << 10) + (char32_t(*p++) - 0xDC00);
+        else if (c >= 0xD800 && c <= 0xDFFF)
+            c = 0xFFFD;
+
+        const int bytes = c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+        if (end - out < bytes)
+            break;
+        switch (bytes) {
+        case 1:
+            *out++ = char(c);
+            break;
+        case 2:
+            *out++ = char(0xC0 | (c >> 6));
+            *out++ = char(0x80 | (c & 0x3F));
+            break;
+        case 3:
+            *out++ = char(0xE0 | (c >> 12));
+            *out++ = char(0x80 | ((c >> 6) & 0x3F));
+            *out++ = char(0x80 | (c & 0x3F));
+            break;
+        default:
+            *out++ = char(0xF0 | (c >> 18));
+            *out++ = char(0x80 | ((c >> 12) & 0x3F));
+            *out++ = char(0x80 | ((c >> 6) & 0x3F));
+            *out++ = char(0x80 | (c & 0x3F));
+            break;
+        }
+    }
+    const quint8 length = quint8(out - (m_record->text + m_record->textUsed));
+    field->textOffset = m_record->textUsed;
+    field->textLength = length;
+    m_record->textUsed += length;
+    return *this;
+}
+
+LogLine &LogLine::addText(const char *key, const char *text, qsizetype length)
+{
+    LogField *field = nextField(key, LogField::Type::Text);
+    if (!field)
+        return *this;
+    const qsizetype room = LogRecord::TextSize - m_record->textUsed;
+    const qsizetype copied = qMin(length, room);
+    if (copied > 0)
+        std::memcpy(m_record->text + m_record->textUsed, text, size_t(copied));
+    field->textOffset = m_record->textUsed;
+    field->textLength = quint8(copied);
+    m_record->textUsed += quint8(copied);
+    return *this;
+}
+
+// --- StructuredLogger ---
+
+namespace StructuredLogger {
+
+void start()
+{
+    LogRegistry::instance().start();
+}
+
+void shutdown()
+{
+    LogRegistry::instance().stop();
+}
+
+quint64 droppedRecords()
+{
+    return LogRegistry::instance().dropped();
+}
+
+} // namespace StructuredLogger
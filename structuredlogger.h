@@ -0,0 +1,129 @@
+#ifndef STRUCTUREDLOGGER_H
+#define STRUCTUREDLOGGER_H
+
+#include <QString>
+#include <QStringView>
+#include <QtGlobal>
+#include <atomic>
+#include <type_traits>
+
+// Structured, asynchronous logging for the hot paths.
+//
+//   LOG_DEBUG("ui.sample").field("temp_c", t).field("hr_bpm", hr);
+//
+// A call site copies a fixed-size record into a ring owned by the calling
+// thread (no lock, no allocation, no I/O); a background thread formats the
+// records as logfmt lines and writes them to logcat / stderr. Event names and
+// field keys must be string literals, they are stored as pointers.
+//
+// MONITOR_LOG_LEVEL (set from CMake) removes every call site below it at
+// compile time, arguments included: 0 trace, 1 debug, 2 info, 3 warning,
+// 4 error.
+
+#ifndef MONITOR_LOG_LEVEL
+#define MONITOR_LOG_LEVEL 1
+#endif
+
+enum class LogLevel : quint8 { Trace = 0, Debug = 1, Info = 2, Warning = 3, Error = 4 };
+
+struct LogField {
+    enum class Type : quint8 { Int, Double, Bool, Text };
+
+    const char *key = nullptr;
+    Type type = Type::Int;
+    // Text fields are stored in LogRecord::text
+    quint8 textOffset = 0;
+    quint8 textLength = 0;
+    union {
+        qint64 intValue;
+        double doubleValue;
+    };
+};
+
+struct LogRecord {
+    static constexpr int MaxFields = 6;
+    static constexpr int TextSize = 96;
+
+    qint64 timestampNs = 0;
+    const char *event = nullptr;
+    LogLevel level = LogLevel::Debug;
+    quint8 fieldCount = 0;
+    quint8 textUsed = 0;
+    LogField fields[MaxFields];
+    char text[TextSize];
+};
+
+class LogThreadBuffer;
+
+// Builds one record in place in the calling thread's ring and publishes it
+// when the statement ends. Fields beyond MaxFields and text beyond TextSize
+// are truncated; a full ring drops the record (counted, never blocks).
+class LogLine
+{
+public:
+    LogLine(LogLevel level, const char *event);
+    ~LogLine();
+
+    LogLine(const LogLine &) = delete;
+    LogLine &operator=(const LogLine &) = delete;
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    LogLine &field(const char *key, T value) { return addInt(key, qint64(value)); }
+    LogLine &field(const char *key, double value);
+    LogLine &field(const char *key, bool value);
+    LogLine &field(const char *key, const char *text);
+    LogLine &field(const char *key, const QString &text);
+    // Encoded to UTF-8 straight into the record, without a temporary
+    LogLine &field(const char *key, QStringView text);
+
+private:
+    LogThreadBuffer *m_buffer;
+    LogRecord *m_record;
+
+    LogField *nextField(const char *key, LogField::Type type);
+    LogLine &addInt(const char *key, qint64 value);
+    LogLine &addText(const char *key, const char *text, qsizetype length);
+};
+
+namespace StructuredLogger {
+
+// Starts the flush thread (idempotent); records logged before are kept
+void start();
+// Drains every ring and stops the flush thread for good: later records
+// stay in their rings and are not written
+void shutdown();
+// Records dropped because a ring was full
+quint64 droppedRecords();
+
+} // namespace StructuredLogger
+
+// A disabled level expands to a dead branch, so its arguments are never evaluated
+#define MONITOR_LOG_DISABLED(level, event) if (true) {} else LogLine(level, event)
+
+#if MONITOR_LOG_LEVEL <= 0
+#define LOG_TRACE(event) LogLine(LogLevel::Trace, event)
+#else
+#define LOG_TRACE(event) MONITOR_LOG_DISABLED(LogLevel::Trace, event)
+#endif
+
+#if MONITOR_LOG_LEVEL <= 1
+#define LOG_DEBUG(event) LogLine(LogLevel::Debug, event)
+#else
+#define LOG_DEBUG(event) MONITOR_LOG_DISABLED(LogLevel::Debug, event)
+#endif
+
+#if MONITOR_LOG_LEVEL <= 2
+#define LOG_INFO(event) LogLine(LogLevel::Info, event)
+#else
+#define LOG_INFO(event) MONITOR_LOG_DISABLED(LogLevel::Info, event)
+#endif
+
+#if MONITOR_LOG_LEVEL <= 3
+#define LOG_WARNING(event) LogLine(LogLevel::Warning, event)
+#else
+#define LOG_WARNING(event) MONITOR_LOG_DISABLED(LogLevel::Warning, event)
+#endif
+
+#define LOG_ERROR(event) LogLine(LogLevel::Error, event)
+
+#endif // STRUCTUREDLOGGER_H
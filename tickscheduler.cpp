@@ -0,0 +1,253 @@
+#include "tickscheduler.h"
+
+#include <QMutexLocker>
+#include <QThread>
+#include <QTimer>
+
+#include <limits>
+
+#include "structuredlogger.h"
+
+namespace {
+
+const qint64 STATS_WINDOW_MS = 60 * 1000;
+
+} // namespace
+
+QString TickStats::summary() const
+{
+    return QString("Wake-ups/min: %1 (critical: %2, one timer per task: %3)%4")
+        .arg(wakeupsPerMinute, 0, 'f', 1)
+        .arg(criticalWakeupsPerMinute, 0, 'f', 1)
+        .arg(taskRunsPerMinute, 0, 'f', 1)
+        .arg(lowPower ? QString(" | low power") : QString());
+}
+
+TickScheduler::TickScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_clock.start();
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    // The tolerance windows are the slack; the timer itself must be on time
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &TickScheduler::tick);
+}
+
+qint64 TickScheduler::stretch(const Task &task, qint64 valueMs) const
+{
+    if (!m_lowPower)
+        return valueMs;
+    switch (task.priority) {
+    case Priority::Critical: return valueMs;
+    case Priority::Normal: return valueMs * 2;
+    case Priority::Background: return valueMs * 4;
+    }
+    return valueMs;
+}
+
+int TickScheduler::addTask(const QString &name, int intervalMs, int toleranceMs, Priority priority,
+                           QObject *context, std::function<void()> callback, bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    Task task;
+    task.name = name;
+    task.intervalMs = qMax(1, intervalMs);
+    task.toleranceMs = qMax(0, toleranceMs);
+    task.priority = priority;
+    task.context = context;
+    task.callback = std::move(callback);
+    task.enabled = enabled;
+    task.dueMs = m_clock.elapsed() + stretch(task, task.intervalMs);
+    m_tasks.push_back(std::move(task));
+    const int id = int(m_tasks.size()) - 1;
+    locker.unlock();
+
+    requestRearm();
+    return id;
+}
+
+int TickScheduler::addDeferredTask(const QString &name, int toleranceMs, Priority priority,
+                                   QObject *context, std::function<void()> callback)
+{
+    QMutexLocker locker(&m_mutex);
+    Task task;
+    task.name = name;
+    task.toleranceMs = qMax(0, toleranceMs);
+    task.priority = priority;
+    task.deferred = true;
+    task.context = context;
+    task.callback = std::move(callback);
+    m_tasks.push_back(std::move(task));
+    return int(m_tasks.size()) - 1;
+}
+
+void TickScheduler::setTaskEnabled(int id, bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    if (id < 0 || id >= int(m_tasks.size()))
+        return;
+    Task &task = m_tasks[id];
+    if (task.enabled == enabled)
+        return;
+    task.enabled = enabled;
+    if (enabled)
+        task.dueMs = m_clock.elapsed() + stretch(task, task.intervalMs);
+    locker.unlock();
+
+    requestRearm();
+}
+
+void TickScheduler::trigger(int id)
+{
+    QMutexLocker locker(&m_mutex);
+    if (id < 0 || id >= int(m_tasks.size()) || !m_tasks[id].deferred)
+        return;
+    Task &task = m_tasks[id];
+    if (task.enabled)
+        return; // Already pending
+    task.enabled = true;
+    task.dueMs = m_clock.elapsed();
+    locker.unlock();
+
+    requestRearm();
+}
+
+bool TickScheduler::isLowPowerMode() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lowPower;
+}
+
+void TickScheduler::setLowPowerMode(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_lowPower == enabled)
+        return;
+    m_lowPower = enabled;
+
+    // Re-base pending periodic tasks on the new intervals
+    const qint64 now = m_clock.elapsed();
+    for (Task &task : m_tasks) {
+        if (task.enabled && !task.deferred)
+            task.dueMs = qMin(task.dueMs, now + stretch(task, task.intervalMs));
+    }
+    locker.unlock();
+
+    LOG_INFO("scheduler.low_power").field("enabled", enabled);
+    requestRearm();
+}
+
+TickStats TickScheduler::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    TickStats stats = m_lastMinute;
+    if (m_wakeups > 0 && stats.totalWakeups == 0) {
+        // Still in the first minute: extrapolate
+        const double minutes = qMax<qint64>(1, m_clock.elapsed() - m_windowStartMs) / double(STATS_WINDOW_MS);
+        stats.wakeupsPerMinute = m_windowWakeups / minutes;
+        stats.taskRunsPerMinute = m_windowTaskRuns / minutes;
+        stats.criticalWakeupsPerMinute = m_windowCriticalWakeups / minutes;
+    }
+    stats.totalWakeups = m_wakeups;
+    stats.totalTaskRuns = m_taskRuns;
+    stats.totalCriticalWakeups = m_criticalWakeups;
+    stats.lowPower = m_lowPower;
+    return stats;
+}
+
+void TickScheduler::requestRearm()
+{
+    if (QThread::currentThread() == thread())
+        rearm();
+    else
+        QMetaObject::invokeMethod(this, &TickScheduler::rearm, Qt::QueuedConnection);
+}
+
+void TickScheduler::rearm()
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 nextDeadline = std::numeric_limits<qint64>::max();
+    for (const Task &task : m_tasks) {
+        if (task.enabled)
+            nextDeadline = qMin(nextDeadline, task.dueMs + stretch(task, task.toleranceMs));
+    }
+
+    if (nextDeadline == std::numeric_limits<qint64>::max()) {
+        m_timer->stop();
+        return;
+    }
+    const qint64 delay = qMax<qint64>(0, nextDeadline - m_clock.elapsed());
+    // Only move the timer earlier; a later deadline is picked up after the next tick
+    if (!m_timer->isActive() || m_timer->remainingTime() > delay)
+        m_timer->start(int(delay));
+}
+
+void TickScheduler::tick()
+{
+    std::vector<std::pair<QPointer<QObject>, std::function<void()>>> due;
+    TickStats minuteStats;
+    bool minuteComplete = false;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        const qint64 now = m_clock.elapsed();
+        ++m_wakeups;
+        ++m_windowWakeups;
+
+        bool critical = false;
+        for (Task &task : m_tasks) {
+            if (!task.enabled || task.dueMs > now)
+                continue;
+            critical = critical || task.priority == Priority::Critical;
+            due.emplace_back(task.context, task.callback);
+            ++task.runs;
+            if (task.deferred)
+                task.enabled = false;
+            else
+                task.dueMs = now + stretch(task, task.intervalMs);
+        }
+        m_taskRuns += due.size();
+        m_windowTaskRuns += due.size();
+        if (critical) {
+            ++m_criticalWakeups;
+            ++m_windowCriticalWakeups;
+        }
+
+        if (now - m_windowStartMs >= STATS_WINDOW_MS) {
+            const double minutes = (now - m_windowStartMs) / double(STATS_WINDOW_MS);
+            m_lastMinute.wakeupsPerMinute = m_windowWakeups / minutes;
+            m_lastMinute.taskRunsPerMinute = m_windowTaskRuns / minutes;
+            m_lastMinute.criticalWakeupsPerMinute = m_windowCriticalWakeups / minutes;
+            m_lastMinute.totalWakeups = m_wakeups;
+            m_lastMinute.totalTaskRuns = m_taskRuns;
+            m_lastMinute.totalCriticalWakeups = m_criticalWakeups;
+            m_lastMinute.lowPower = m_lowPower;
+            minuteStats = m_lastMinute;
+            minuteComplete = true;
+            m_windowStartMs = now;
+            m_windowWakeups = 0;
+            m_windowTaskRuns = 0;
+            m_windowCriticalWakeups = 0;
+        }
+    }
+
+    // Outside the lock: callbacks may add, enable or trigger tasks
+    for (const auto &[context, callback] : due) {
+        if (!context)
+            continue;
+        if (context->thread() == QThread::currentThread())
+            callback();
+        else
+            QMetaObject::invokeMethod(context, callback, Qt::QueuedConnection);
+    }
+
+    if (minuteComplete) {
+        LOG_INFO("scheduler.minute").field("wakeups_per_min", minuteStats.wakeupsPerMinute)
+            .field("task_runs_per_min", minuteStats.taskRunsPerMinute)
+            .field("critical_wakeups_per_min", minuteStats.criticalWakeupsPerMinute)
+            .field("low_power", minuteStats.lowPower);
+        emit statsUpdated(minuteStats);
+    }
+    rearm();
+}
@@ -0,0 +1,112 @@
+#ifndef TICKSCHEDULER_H
+#define TICKSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <functional>
+#include <vector>
+
+class QTimer;
+
+// Wake-up accounting over the last full minute
+struct TickStats {
+    // Timer wake-ups the scheduler actually took
+    double wakeupsPerMinute = 0.0;
+    // Task runs, i.e. the wake-ups one timer per task would have cost
+    double taskRunsPerMinute = 0.0;
+    // Wake-ups that ran a Critical task, the ones low-power mode cannot stretch
+    double criticalWakeupsPerMinute = 0.0;
+    quint64 totalWakeups = 0;
+    quint64 totalTaskRuns = 0;
+    quint64 totalCriticalWakeups = 0;
+    bool lowPower = false;
+
+    QString summary() const;
+};
+Q_DECLARE_METATYPE(TickStats)
+
+// One timer for all periodic work of the app.
+//
+// Every task may run anywhere in [due, due + tolerance]. The scheduler wakes
+// up at the earliest deadline and then runs every task whose window has
+// opened, so tasks with compatible windows share one wake-up. Deferred tasks
+// run once per trigger(), on the next tick within their tolerance.
+//
+// Callbacks run on the thread of their context object (queued when that is
+// not the scheduler's thread). All methods are thread-safe.
+class TickScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Priority {
+        Critical,   // never stretched
+        Normal,     // interval and tolerance doubled in low-power mode
+        Background  // quadrupled in low-power mode
+    };
+
+    explicit TickScheduler(QObject *parent = nullptr);
+
+    int addTask(const QString &name, int intervalMs, int toleranceMs, Priority priority,
+                QObject *context, std::function<void()> callback, bool enabled = true);
+    int addDeferredTask(const QString &name, int toleranceMs, Priority priority,
+                        QObject *context, std::function<void()> callback);
+
+    // Periodic tasks: (re)starts counting the interval from now
+    void setTaskEnabled(int id, bool enabled);
+    // Deferred tasks: run once within the tolerance; repeated triggers merge
+    void trigger(int id);
+
+    bool isLowPowerMode() const;
+    TickStats stats() const;
+
+public slots:
+    void setLowPowerMode(bool enabled);
+
+signals:
+    // Once per minute
+    void statsUpdated(const TickStats &stats);
+
+private slots:
+    void tick();
+    void rearm();
+
+private:
+    struct Task {
+        QString name;
+        qint64 intervalMs = 0;
+        qint64 toleranceMs = 0;
+        Priority priority = Priority::Normal;
+        bool deferred = false;
+        QPointer<QObject> context;
+        std::function<void()> callback;
+
+        bool enabled = false;
+        qint64 dueMs = 0;
+        quint64 runs = 0;
+    };
+
+    mutable QMutex m_mutex;
+    std::vector<Task> m_tasks;
+    QTimer *m_timer = nullptr;
+    QElapsedTimer m_clock;
+    bool m_lowPower = false;
+
+    quint64 m_wakeups = 0;
+    quint64 m_taskRuns = 0;
+    quint64 m_criticalWakeups = 0;
+    qint64 m_windowStartMs = 0;
+    quint64 m_windowWakeups = 0;
+    quint64 m_windowTaskRuns = 0;
+    quint64 m_windowCriticalWakeups = 0;
+    TickStats m_lastMinute;
+
+    qint64 stretch(const Task &task, qint64 valueMs) const;
+    void requestRearm();
+};
+
+#endif // TICKSCHEDULER_H
@@ -0,0 +1,199 @@
+// Paint-time benchmark of the vitals tiles against the rich-text QLabels they
+// replaced.
+//
+//   tilebench [--updates 2000]
+//
+// Each update changes the widgets the way GuiWindow does, delivers the posted
+// layout events, and renders what Qt would repaint: the whole label (setText()
+// invalidates all of it), or only the dirty rectangle of a tile. Three cases:
+// a new sample (temperature and heart rate), a prediction that flips between
+// at risk and normal (text and style), and a repeated prediction (the common
+// case every 10 s).
+//
+// Runs offscreen unless QT_QPA_PLATFORM is set, on the desktop or the device.
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QLabel>
+#include <QPainter>
+#include <QTextStream>
+
+#include <functional>
+
+#include "vitalstile.h"
+
+namespace {
+
+QTextStream &out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+// The stylesheets the labels used
+const char *const TEMP_STYLE = "QLabel { background-color: #E0F2F1; border-radius: 8px; padding: 15px; font-size: 16px; font-weight: bold; color: #004D40; border: 1px solid #B2DFDB; }";
+const char *const HR_STYLE = "QLabel { background-color: #E3F2FD; border-radius: 8px; padding: 15px; font-size: 16px; font-weight: bold; color: #1565C0; border: 1px solid #BBDEFB; }";
+const char *const AT_RISK_STYLE = "QLabel { background-color: #FFFBEB; border-radius: 8px; padding: 10px; font-size: 18px; font-weight: bold; color: #92400E; border: 2px solid #FCD34D; margin: 10px; }";
+const char *const SAFE_STYLE = "QLabel { background-color: #ECFDF5; border-radius: 8px; padding: 10px; font-size: 18px; font-weight: bold; color: #065F46; border: 2px solid #A7F3D0; margin: 10px; }";
+
+struct Timing {
+    double usPerUpdate = 0.0;
+    double pixelsPerUpdate = 0.0;
+};
+
+// Renders `region` of `widget` into `target`, as the backing store would
+quint64 repaint(QWidget *widget, const QRegion &region, QImage &target)
+{
+    if (region.isEmpty())
+        return 0;
+    QPainter painter(&target);
+    widget->render(&painter, region.boundingRect().topLeft(), region, QWidget::DrawChildren);
+    quint64 pixels = 0;
+    for (const QRect &rect : region)
+        pixels += quint64(rect.width()) * rect.height();
+    return pixels;
+}
+
+// `update(i)` changes the widgets and returns the pixels repainted
+Timing timeUpdates(int updates, const std::function<quint64(int)> &update)
+{
+    // Warm-up: fonts, glyph caches, style sheet parsing
+    for (int i = 0; i < 50; ++i)
+        update(i);
+    quint64 pixels = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < updates; ++i)
+        pixels += update(i);
+    Timing timing;
+    timing.usPerUpdate = timer.nsecsElapsed() / 1000.0 / updates;
+    timing.pixelsPerUpdate = double(pixels) / updates;
+    return timing;
+}
+
+void report(const char *name, const Timing &labels, const Timing &tiles)
+{
+    out() << name << Qt::endl;
+    out() << "  QLabel rich text: " << QString::number(labels.usPerUpdate, 'f', 1) << " us/update, "
+          << QString::number(labels.pixelsPerUpdate, 'f', 0) << " px repainted" << Qt::endl;
+    out() << "  VitalsTile:       " << QString::number(tiles.usPerUpdate, 'f', 1) << " us/update, "
+          << QString::number(tiles.pixelsPerUpdate, 'f', 0) << " px repainted" << Qt::endl;
+    out() << "  Speed-up:         "
+          << QString::number(tiles.usPerUpdate > 0 ? labels.usPerUpdate / tiles.usPerUpdate : 0.0, 'f', 1) << "x"
+          << Qt::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("tilebench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compares repaint cost of the vitals tiles and the former rich-text labels.");
+    parser.addHelpOption();
+    QCommandLineOption updatesOption({"n", "updates"}, "Updates per case and variant.", "count", "2000");
+    parser.addOption(updatesOption);
+    parser.process(app);
+    const int updates = qMax(1, parser.value(updatesOption).toInt());
+
+    // Same sizes as in the main window on a phone
+    const QSize vitalsSize(170, 90);
+    const QSize predictionSize(360, 80);
+    QImage target(QSize(360, 90), QImage::Format_ARGB32_Premultiplied);
+    target.fill(Qt::white);
+
+    // --- Former labels ---
+    QLabel tempLabel("Temperature: <br><b>-- °C</b>");
+    tempLabel.setTextFormat(Qt::RichText);
+    tempLabel.setAlignment(Qt::AlignCenter);
+    tempLabel.setStyleSheet(TEMP_STYLE);
+    tempLabel.resize(vitalsSize);
+    QLabel hrLabel("Heart Rate: <br><b>-- BPM</b>");
+    hrLabel.setTextFormat(Qt::RichText);
+    hrLabel.setAlignment(Qt::AlignCenter);
+    hrLabel.setStyleSheet(HR_STYLE);
+    hrLabel.resize(vitalsSize);
+    QLabel predictionLabel("Prediction: Not Run");
+    predictionLabel.setTextFormat(Qt::RichText);
+    predictionLabel.setAlignment(Qt::AlignCenter);
+    predictionLabel.resize(predictionSize);
+
+    // --- Tiles ---
+    VitalsTile tempTile(QStringLiteral("Temperature"), TileStyle::temperature());
+    tempTile.setValue("-- °C");
+    tempTile.resize(vitalsSize);
+    VitalsTile hrTile(QStringLiteral("Heart Rate"), TileStyle::heartRate());
+    hrTile.setValue("-- BPM");
+    hrTile.resize(vitalsSize);
+    VitalsTile predictionTile(QStringLiteral("Prediction"), TileStyle::neutral());
+    predictionTile.setContentsMargins(10, 10, 10, 10);
+    predictionTile.resize(predictionSize);
+
+    for (QWidget *widget : std::initializer_list<QWidget *>{&tempLabel, &hrLabel, &predictionLabel, &tempTile,
+                                                              &hrTile, &predictionTile}) {
+        widget->ensurePolished();
+        QCoreApplication::sendPostedEvents();
+    }
+
+    auto temperature = [](int i) { return 36.0 + (i % 30) * 0.1; };
+    auto heartRate = [](int i) { return 110 + (i % 40); };
+
+    // --- New sample ---
+    const Timing sampleLabels = timeUpdates(updates, [&](int i) {
+        tempLabel.setText(QString("Temperature: <br><b>%1 °C</b>").arg(temperature(i), 0, 'f', 1));
+        hrLabel.setText(QString("Heart Rate: <br><b>%1 BPM</b>").arg(heartRate(i)));
+        QCoreApplication::sendPostedEvents();
+        return repaint(&tempLabel, tempLabel.rect(), target) + repaint(&hrLabel, hrLabel.rect(), target);
+    });
+    const Timing sampleTiles = timeUpdates(updates, [&](int i) {
+        tempTile.setValue(QString("%1 °C").arg(temperature(i), 0, 'f', 1));
+        hrTile.setValue(QString("%1 BPM").arg(heartRate(i)));
+        QCoreApplication::sendPostedEvents();
+        return repaint(&tempTile, tempTile.valueRect(), target) + repaint(&hrTile, hrTile.valueRect(), target);
+    });
+
+    // --- Prediction flips ---
+    const Timing flipLabels = timeUpdates(updates, [&](int i) {
+        const bool atRisk = i % 2;
+        predictionLabel.setText(atRisk ? "⚠️ **STATUS: AT RISK**" : "✅ **STATUS: NOT AT RISK**");
+        predictionLabel.setStyleSheet(atRisk ? AT_RISK_STYLE : SAFE_STYLE);
+        QCoreApplication::sendPostedEvents();
+        return repaint(&predictionLabel, predictionLabel.rect(), target);
+    });
+    const Timing flipTiles = timeUpdates(updates, [&](int i) {
+        const bool atRisk = i % 2;
+        predictionTile.setValue(atRisk ? "⚠️ STATUS: AT RISK" : "✅ STATUS: NOT AT RISK");
+        predictionTile.setDetail(QString());
+        predictionTile.setTileStyle(atRisk ? TileStyle::atRisk() : TileStyle::safe());
+        QCoreApplication::sendPostedEvents();
+        return repaint(&predictionTile, predictionTile.rect(), target);
+    });
+
+    // --- Same prediction again: the old code still set text and stylesheet ---
+    const Timing repeatLabels = timeUpdates(updates, [&](int) {
+        predictionLabel.setText("✅ **STATUS: NOT AT RISK**");
+        predictionLabel.setStyleSheet(SAFE_STYLE);
+        QCoreApplication::sendPostedEvents();
+        return repaint(&predictionLabel, predictionLabel.rect(), target);
+    });
+    const Timing repeatTiles = timeUpdates(updates, [&](int) {
+        predictionTile.setValue("✅ STATUS: NOT AT RISK");
+        predictionTile.setDetail(QString());
+        predictionTile.setTileStyle(TileStyle::safe());
+        QCoreApplication::sendPostedEvents();
+        // Nothing changed, so nothing is invalidated
+        return quint64(0);
+    });
+
+    out() << "Updates per case: " << updates << " (" << QGuiApplication::platformName() << ")" << Qt::endl;
+    report("New sample (temperature + heart rate):", sampleLabels, sampleTiles);
+    report("Prediction flips (text + style):", flipLabels, flipTiles);
+    report("Prediction repeated:", repeatLabels, repeatTiles);
+    return 0;
+}
@@ -0,0 +1,293 @@
+#include "vitalscodec.h"
+
+#include <cstring>
+
+namespace {
+
+uint32_t floatBits(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    return bits;
+}
+
+float bitsToFloat(uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof value);
+    return value;
+}
+
+const size_t HEADER_SIZE = 4;
+
+} // namespace
+
+// --- Encoder ---
+
+VitalsEncoder::VitalsEncoder()
+{
+    reset();
+}
+
+void VitalsEncoder::reset()
+{
+    m_bytes.clear();
+    m_bytes.resize(HEADER_SIZE); // Sample count, patched in finish()
+    m_bitBuffer = 0;
+    m_bitCount = 0;
+    m_count = 0;
+    m_prevTimestamp = 0;
+    m_prevDelta = 0;
+    m_prevValue = 0;
+    m_prevLeading = 33; // Forces a fresh window for the first non-zero XOR
+    m_prevTrailing = 0;
+}
+
+void VitalsEncoder::writeBits(uint64_t bits, int count)
+{
+    // Bits are packed MSB first into a 64-bit accumulator which is spilled
+    // eight bytes at a time; m_bitCount is always < 64 between calls
+    if (count == 0)
+        return;
+    if (count < 64)
+        bits &= (uint64_t(1) << count) - 1;
+
+    const int space = 64 - m_bitCount;
+    if (count < space) {
+        m_bitBuffer = (m_bitBuffer << count) | bits;
+        m_bitCount += count;
+        return;
+    }
+
+    const int rest = count - space;
+    uint64_t full = (space == 64) ? bits : (m_bitBuffer << space) | (bits >> rest);
+    for (int shift = 56; shift >= 0; shift -= 8)
+        m_bytes.push_back(uint8_t(full >> shift));
+
+    m_bitBuffer = (rest == 0) ? 0 : bits & ((uint64_t(1) << rest) - 1);
+    m_bitCount = rest;
+}
+
+void VitalsEncoder::flushBits()
+{
+    if (m_bitCount == 0)
+        return;
+    uint64_t aligned = m_bitBuffer << (64 - m_bitCount);
+    for (int i = 0; i < (m_bitCount + 7) / 8; ++i)
+        m_bytes.push_back(uint8_t(aligned >> (56 - 8 * i)));
+    m_bitBuffer = 0;
+    m_bitCount = 0;
+}
+
+void VitalsEncoder::encodeTimestamp(int64_t timestampMs)
+{
+    const int64_t delta = timestampMs - m_prevTimestamp;
+    const int64_t dod = delta - m_prevDelta;
+
+    if (dod == 0) {
+        writeBits(0b0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+        writeBits(0b10, 2);
+        writeBits(uint64_t(dod + 63), 7);
+    } else if (dod >= -255 && dod <= 256) {
+        writeBits(0b110, 3);
+        writeBits(uint64_t(dod + 255), 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+        writeBits(0b1110, 4);
+        writeBits(uint64_t(dod + 2047), 12);
+    } else {
+        writeBits(0b1111, 4);
+        writeBits(uint64_t(dod), 64);
+    }
+
+    m_prevDelta = delta;
+    m_prevTimestamp = timestampMs;
+}
+
+void VitalsEncoder::encodeValue(uint32_t valueBits)
+{
+    const uint32_t x = valueBits ^ m_prevValue;
+    m_prevValue = valueBits;
+
+    if (x == 0) {
+        writeBits(0b0, 1);
+        return;
+    }
+
+    const int leading = __builtin_clz(x);
+    const int trailing = __builtin_ctz(x);
+
+    if (leading >= m_prevLeading && trailing >= m_prevTrailing) {
+        // Reuse the previous window
+        writeBits(0b10, 2);
+        writeBits(x >> m_prevTrailing, 32 - m_prevLeading - m_prevTrailing);
+        return;
+    }
+
+    const int length = 32 - leading - trailing;
+    writeBits(0b11, 2);
+    writeBits(uint64_t(leading), 5);
+    writeBits(uint64_t(length - 1), 5);
+    writeBits(x >> trailing, length);
+    m_prevLeading = leading;
+    m_prevTrailing = trailing;
+}
+
+void VitalsEncoder::append(int64_t timestampMs, float value)
+{
+    const uint32_t valueBits = floatBits(value);
+
+    if (m_count == 0) {
+        // The first sample is stored verbatim and seeds both predictors
+        writeBits(uint64_t(timestampMs), 64);
+        writeBits(valueBits, 32);
+        m_prevTimestamp = timestampMs;
+        m_prevDelta = 0;
+        m_prevValue = valueBits;
+    } else {
+        encodeTimestamp(timestampMs);
+        encodeValue(valueBits);
+    }
+    ++m_count;
+}
+
+std::vector<uint8_t> VitalsEncoder::finish()
+{
+    flushBits();
+    for (size_t i = 0; i < HEADER_SIZE; ++i)
+        m_bytes[i] = uint8_t(m_count >> (8 * i));
+
+    std::vector<uint8_t> block;
+    block.swap(m_bytes);
+    reset();
+    return block;
+}
+
+// --- Decoder ---
+
+VitalsDecoder::VitalsDecoder(const uint8_t *data, size_t size)
+    : m_data(data), m_end(data + size)
+{
+    if (size < HEADER_SIZE) {
+        m_data = m_end;
+        return;
+    }
+    for (size_t i = 0; i < HEADER_SIZE; ++i)
+        m_count |= uint32_t(m_data[i]) << (8 * i);
+    m_data += HEADER_SIZE;
+}
+
+void VitalsDecoder::refill()
+{
+    // Keep the unread bits left-aligned in the 64-bit window
+    while (m_bitCount <= 56 && m_data < m_end) {
+        m_bitBuffer |= uint64_t(*m_data++) << (56 - m_bitCount);
+        m_bitCount += 8;
+    }
+}
+
+uint64_t VitalsDecoder::readBits(int count)
+{
+    if (count == 0)
+        return 0;
+    if (count > 56) {
+        const uint64_t high = readBits(32);
+        return (high << (count - 32)) | readBits(count - 32);
+    }
+
+    if (m_bitCount < count) {
+        refill();
+        if (m_bitCount < count) {
+            m_overrun = true;
+            return 0;
+        }
+    }
+
+    const uint64_t bits = m_bitBuffer >> (64 - count);
+    m_bitBuffer <<= count;
+    m_bitCount -= count;
+    return bits;
+}
+
+bool VitalsDecoder::readBit()
+{
+    return readBits(1) != 0;
+}
+
+bool VitalsDecoder::next(int64_t &timestampMs, float &value)
+{
+    if (m_read >= m_count || m_overrun)
+        return false;
+
+    if (m_read == 0) {
+        m_prevTimestamp = int64_t(readBits(64));
+        m_prevValue = uint32_t(readBits(32));
+        m_prevDelta = 0;
+    } else {
+        // --- Timestamp ---
+        int64_t dod = 0;
+        if (readBit()) {
+            if (!readBit())
+                dod = int64_t(readBits(7)) - 63;
+            else if (!readBit())
+                dod = int64_t(readBits(9)) - 255;
+            else if (!readBit())
+                dod = int64_t(readBits(12)) - 2047;
+            else
+                dod = int64_t(readBits(64));
+        }
+        m_prevDelta += dod;
+        m_prevTimestamp += m_prevDelta;
+
+        // --- Value ---
+        if (readBit()) {
+            if (readBit()) {
+                m_prevLeading = int(readBits(5));
+                const int length = int(readBits(5)) + 1;
+                m_prevTrailing = 32 - m_prevLeading - length;
+                if (m_prevTrailing < 0) {
+                    m_overrun = true;
+                    return false;
+                }
+            }
+            const int length = 32 - m_prevLeading - m_prevTrailing;
+            m_prevValue ^= uint32_t(readBits(length)) << m_prevTrailing;
+        }
+    }
+
+    if (m_overrun)
+        return false;
+
+    timestampMs = m_prevTimestamp;
+    value = bitsToFloat(m_prevValue);
+    ++m_read;
+    return true;
+}
+
+// --- Block API ---
+
+void encodeVitalsBlock(const int64_t *timestampsMs, const float *values, size_t n,
+                       std::vector<uint8_t> &out)
+{
+    VitalsEncoder encoder;
+    for (size_t i = 0; i < n; ++i)
+        encoder.append(timestampsMs[i], values[i]);
+    out = encoder.finish();
+}
+
+long decodeVitalsBlock(const uint8_t *data, size_t size,
+                       int64_t *timestampsMs, float *values, size_t capacity)
+{
+    if (size < HEADER_SIZE)
+        return -1;
+
+    VitalsDecoder decoder(data, size);
+    if (decoder.size() > capacity)
+        return -1;
+
+    size_t n = 0;
+    while (n < decoder.size() && decoder.next(timestampsMs[n], values[n]))
+        ++n;
+
+    return (n == decoder.size()) ? long(n) : -1;
+}
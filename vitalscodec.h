@@ -0,0 +1,104 @@
+#ifndef VITALSCODEC_H
+#define VITALSCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Gorilla-style compression for a timestamped float series (one vital sign).
+//
+// Layout of an encoded block:
+//   u32 sample count (little endian)
+//   64-bit first timestamp, 32-bit first value
+//   then per sample: delta-of-delta timestamp code, XOR-encoded value code
+//
+// Timestamp codes (dod = delta - previous delta, first previous delta is 0):
+//   '0'                     dod == 0
+//   '10'   + 7 bits         dod in [-63, 64]
+//   '110'  + 9 bits         dod in [-255, 256]
+//   '1110' + 12 bits        dod in [-2047, 2048]
+//   '1111' + 64 bits        anything else
+//
+// Value codes (xor = bits(value) ^ bits(previous value)):
+//   '0'                     xor == 0
+//   '10' + meaningful bits  xor fits in the previous leading/trailing window
+//   '11' + 5 bits leading zeros + 5 bits (length - 1) + meaningful bits
+
+class VitalsEncoder
+{
+public:
+    VitalsEncoder();
+
+    // Timestamps are in milliseconds and must not decrease
+    void append(int64_t timestampMs, float value);
+
+    // Number of samples appended so far
+    size_t size() const { return m_count; }
+
+    // Flushes pending bits, patches the header and hands over the block.
+    // The encoder is reset and can be reused afterwards.
+    std::vector<uint8_t> finish();
+
+private:
+    std::vector<uint8_t> m_bytes;
+    uint64_t m_bitBuffer = 0;
+    int m_bitCount = 0;
+
+    uint32_t m_count = 0;
+    int64_t m_prevTimestamp = 0;
+    int64_t m_prevDelta = 0;
+    uint32_t m_prevValue = 0;
+    int m_prevLeading = 33;
+    int m_prevTrailing = 0;
+
+    void reset();
+    void writeBits(uint64_t bits, int count);
+    void flushBits();
+    void encodeTimestamp(int64_t timestampMs);
+    void encodeValue(uint32_t valueBits);
+};
+
+class VitalsDecoder
+{
+public:
+    VitalsDecoder(const uint8_t *data, size_t size);
+
+    // Sample count announced by the block header (0 for a malformed block)
+    size_t size() const { return m_count; }
+
+    // Returns false once all samples were read or the stream is truncated
+    bool next(int64_t &timestampMs, float &value);
+
+private:
+    const uint8_t *m_data;
+    const uint8_t *m_end;
+    uint64_t m_bitBuffer = 0;
+    int m_bitCount = 0;
+    bool m_overrun = false;
+
+    uint32_t m_count = 0;
+    uint32_t m_read = 0;
+    int64_t m_prevTimestamp = 0;
+    int64_t m_prevDelta = 0;
+    uint32_t m_prevValue = 0;
+    int m_prevLeading = 0;
+    int m_prevTrailing = 0;
+
+    void refill();
+    uint64_t readBits(int count);
+    bool readBit();
+};
+
+// --- Block API ---
+
+// Encodes n samples into one block, replacing the contents of out
+void encodeVitalsBlock(const int64_t *timestampsMs, const float *values, size_t n,
+                       std::vector<uint8_t> &out);
+
+// Decodes a block into caller-provided arrays of at least `capacity` entries.
+// Returns the number of samples written, or -1 if the block is malformed or
+// holds more than `capacity` samples.
+long decodeVitalsBlock(const uint8_t *data, size_t size,
+                       int64_t *timestampsMs, float *values, size_t capacity);
+
+#endif // VITALSCODEC_H
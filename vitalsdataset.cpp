@@ -0,0 +1,120 @@
+#include "vitalsdataset.h"
+
+#include <QFile>
+#include <QList>
+#include <QtEndian>
+
+#include <array>
+#include <cstring>
+
+#include "featureschema.h"
+
+namespace {
+
+using featureschema::InputCount;
+using featureschema::NUMERIC_FIELDS;
+
+const char BINARY_MAGIC[4] = {'V', 'T', 'L', 'S'};
+
+} // namespace
+
+namespace vitalsdataset {
+
+bool loadCsv(const QString &path, std::vector<BabyData> &rows, QString &error, const BabyData *defaults)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        error = QString("Cannot open %1").arg(path);
+        return false;
+    }
+
+    // -1 for a column taken from `defaults`
+    const QList<QByteArray> header = file.readLine().trimmed().split(',');
+    std::array<int, InputCount> columns;
+    for (size_t i = 0; i < InputCount; ++i) {
+        columns[i] = header.indexOf(QByteArray(featureschema::NAMES[i]));
+        if (columns[i] < 0 && !defaults) {
+            error = QString("Missing column '%1' in %2").arg(featureschema::NAMES[i], path);
+            return false;
+        }
+    }
+
+    int lineNumber = 1;
+    while (!file.atEnd()) {
+        ++lineNumber;
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty())
+            continue;
+
+        const QList<QByteArray> fields = line.split(',');
+        BabyData row = defaults ? *defaults : BabyData();
+        if (columns[0] >= 0)
+            row.gender = QString::fromUtf8(fields.value(columns[0]).trimmed());
+        for (size_t i = 0; i < NUMERIC_FIELDS.size(); ++i) {
+            if (columns[i + 1] < 0)
+                continue;
+            bool ok = false;
+            row.*NUMERIC_FIELDS[i] = fields.value(columns[i + 1]).trimmed().toFloat(&ok);
+            if (!ok) {
+                error = QString("Invalid value for '%1' on line %2")
+                            .arg(featureschema::NAMES[i + 1]).arg(lineNumber);
+                return false;
+            }
+        }
+        rows.push_back(row);
+    }
+    return true;
+}
+
+bool loadBinary(const QString &path, std::vector<BabyData> &rows, QString &error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("Cannot open %1").arg(path);
+        return false;
+    }
+
+    const QByteArray data = file.readAll();
+    const qsizetype rowSize = 1 + qsizetype(NUMERIC_FIELDS.size() * sizeof(float));
+    if (data.size() < 8 || !data.startsWith(QByteArray(BINARY_MAGIC, 4))) {
+        error = QString("%1 is not a VTLS dataset").arg(path);
+        return false;
+    }
+
+    const quint32 count = qFromLittleEndian<quint32>(data.constData() + 4);
+    if (data.size() < 8 + qsizetype(count) * rowSize) {
+        error = QString("%1 is truncated").arg(path);
+        return false;
+    }
+
+    rows.reserve(rows.size() + count);
+    const char *cursor = data.constData() + 8;
+    for (quint32 r = 0; r < count; ++r) {
+        BabyData row;
+        row.gender = (*cursor++ == 0) ? QStringLiteral("male") : QStringLiteral("female");
+        for (float BabyData::*field : NUMERIC_FIELDS) {
+            const quint32 bits = qFromLittleEndian<quint32>(cursor);
+            std::memcpy(&(row.*field), &bits, sizeof(float));
+            cursor += sizeof(float);
+        }
+        rows.push_back(row);
+    }
+    return true;
+}
+
+bool load(const QString &path, std::vector<BabyData> &rows, QString &error, const BabyData *defaults)
+{
+    QFile probe(path);
+    const bool isBinary = probe.open(QIODevice::ReadOnly) && probe.peek(4) == QByteArray(BINARY_MAGIC, 4);
+    probe.close();
+    return isBinary ? loadBinary(path, rows, error) : loadCsv(path, rows, error, defaults);
+}
+
+bool sameProfile(const BabyData &a, const BabyData &b)
+{
+    return a.gender == b.gender && a.gestational_age_weeks == b.gestational_age_weeks
+           && a.birth_weight_kg == b.birth_weight_kg && a.birth_length_cm == b.birth_length_cm
+           && a.age_days == b.age_days && a.weight_kg == b.weight_kg && a.length_cm == b.length_cm;
+}
+
+} // namespace vitalsdataset
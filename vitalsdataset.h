@@ -0,0 +1,35 @@
+#ifndef VITALSDATASET_H
+#define VITALSDATASET_H
+
+#include <QString>
+#include <vector>
+
+#include "babydata.h"
+
+// Recorded rows of the 9 classifier inputs, shared by the command-line tools.
+//
+// CSV: a header row naming the model inputs (any order, extra columns
+// ignored). Columns missing from the header are copied from `defaults`; with
+// no defaults every input column is required. This lets a night of vitals
+// ("temperature_c,heart_rate_bpm") be combined with a separate profile.
+//
+// Binary ("VTLS"): u32 row count, then per row one byte gender (0 = male,
+// 1 = female) followed by the 8 float inputs in featureschema order;
+// everything little endian.
+namespace vitalsdataset {
+
+bool loadCsv(const QString &path, std::vector<BabyData> &rows, QString &error,
+             const BabyData *defaults = nullptr);
+bool loadBinary(const QString &path, std::vector<BabyData> &rows, QString &error);
+
+// Picks the format from the first bytes of the file
+bool load(const QString &path, std::vector<BabyData> &rows, QString &error,
+          const BabyData *defaults = nullptr);
+
+// True if the two rows differ at most in the vitals, i.e. HealthInputs bound
+// for one only needs setVitals() for the other
+bool sameProfile(const BabyData &a, const BabyData &b);
+
+} // namespace vitalsdataset
+
+#endif // VITALSDATASET_H
@@ -0,0 +1,175 @@
+#include "vitalsparser.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <system_error>
+
+namespace {
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+#if !defined(__cpp_lib_to_chars)
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Standard libraries without floating-point std::from_chars (libc++ before
+// LLVM 20, i.e. current Android NDKs) use this decimal-only equivalent. It
+// accepts the same syntax as std::chars_format::general.
+std::from_chars_result fromCharsDecimal(const char *begin, const char *end, float &value)
+{
+    const char *p = begin;
+    const bool negative = (p != end && *p == '-');
+    if (negative)
+        ++p;
+
+    // Up to 19 significant digits fit a uint64_t; further digits only scale
+    std::uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+    for (; p != end && isDigit(*p); ++p, any = true) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + std::uint64_t(*p - '0');
+            if (mantissa != 0)
+                ++digits;
+        } else {
+            ++exponent;
+        }
+    }
+    if (p != end && *p == '.') {
+        ++p;
+        for (; p != end && isDigit(*p); ++p, any = true) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + std::uint64_t(*p - '0');
+                if (mantissa != 0)
+                    ++digits;
+                --exponent;
+            }
+        }
+    }
+    if (!any)
+        return {begin, std::errc::invalid_argument};
+
+    // The exponent is optional and only consumed if it has digits
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        const bool negativeExponent = (q != end && *q == '-');
+        if (q != end && (*q == '-' || *q == '+'))
+            ++q;
+        if (q != end && isDigit(*q)) {
+            int written = 0;
+            for (; q != end && isDigit(*q); ++q)
+                written = (written < 10000) ? written * 10 + (*q - '0') : written;
+            exponent += negativeExponent ? -written : written;
+            p = q;
+        }
+    }
+
+    // Zero stays zero whatever the exponent (0 * inf would be NaN)
+    const double magnitude = (mantissa == 0) ? 0.0 : double(mantissa) * std::pow(10.0, exponent);
+    const float rounded = float(magnitude);
+    if (mantissa != 0 && (std::isinf(rounded) || rounded == 0.0f))
+        return {p, std::errc::result_out_of_range};
+    value = negative ? -rounded : rounded;
+    return {p, std::errc()};
+}
+#endif
+
+void trim(const char *&begin, const char *&end)
+{
+    while (begin != end && isSpace(*begin))
+        ++begin;
+    while (end != begin && isSpace(end[-1]))
+        --end;
+}
+
+} // namespace
+
+namespace vitalsparser {
+
+bool parseFloat(const char *begin, const char *end, float &value)
+{
+    trim(begin, end);
+    // std::from_chars takes no '+'; a sign after it is still an error
+    if (begin != end && *begin == '+' && (end - begin == 1 || begin[1] != '-'))
+        ++begin;
+    if (begin == end)
+        return false;
+
+    float parsed = 0.0f;
+#if defined(__cpp_lib_to_chars)
+    const std::from_chars_result result = std::from_chars(begin, end, parsed, std::chars_format::general);
+#else
+    const std::from_chars_result result = fromCharsDecimal(begin, end, parsed);
+#endif
+    // "inf" and "nan" parse, but are no vital signs
+    if (result.ec != std::errc() || result.ptr != end || !std::isfinite(parsed))
+        return false;
+    value = parsed;
+    return true;
+}
+
+int parseFields(const char *begin, const char *end, float *values, int maxFields)
+{
+    if (begin == end)
+        return 0;
+
+    int count = 0;
+    const char *field = begin;
+    for (const char *p = begin;; ++p) {
+        if (p != end && *p != ',')
+            continue;
+        if (count == maxFields || !parseFloat(field, p, values[count]))
+            return -1;
+        ++count;
+        if (p == end)
+            return count;
+        field = p + 1;
+    }
+}
+
+bool parseCounter(const char *begin, const char *end, std::int64_t &value)
+{
+    trim(begin, end);
+    // Integer std::from_chars is available everywhere, libc++ included
+    std::int64_t parsed = 0;
+    const std::from_chars_result result = std::from_chars(begin, end, parsed);
+    if (begin == end || *begin == '-' || result.ec != std::errc() || result.ptr != end)
+        return false;
+    value = parsed;
+    return true;
+}
+
+bool parseVitals(const char *begin, const char *end, float &temperature, float &heartRate,
+                 std::int64_t &deviceTimeUs)
+{
+    // The timestamp is an integer (a float would lose microseconds after
+    // 16 s of uptime), so it is split off before the float fields
+    const char *stamp = end;
+    int commas = 0;
+    for (const char *p = begin; p != end; ++p) {
+        if (*p == ',' && ++commas == 2) {
+            stamp = p;
+            break;
+        }
+    }
+
+    float fields[2];
+    if (parseFields(begin, stamp, fields, 2) != 2)
+        return false;
+    std::int64_t device = -1;
+    if (stamp != end && !parseCounter(stamp + 1, end, device))
+        return false;
+    temperature = fields[0];
+    heartRate = fields[1];
+    deviceTimeUs = device;
+    return true;
+}
+
+} // namespace vitalsparser
@@ -0,0 +1,35 @@
+#ifndef VITALSPARSER_H
+#define VITALSPARSER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Allocation-free parser for the ESP32's comma-separated text payload
+// ("37.5,120"), working on the notification bytes directly. Newer sketches
+// append the ESP32's own clock in microseconds ("37.5,120,81234567").
+//
+// Each field is a decimal number (optional sign, fraction and exponent) with
+// optional ASCII whitespace around it. Empty fields, trailing garbage,
+// non-finite or out-of-range values make the whole payload malformed.
+namespace vitalsparser {
+
+// Parses one number spanning exactly [begin, end), whitespace aside
+bool parseFloat(const char *begin, const char *end, float &value);
+
+// Parses the comma-separated fields of [begin, end) into `values`. Returns the
+// number of fields, or -1 if a field is malformed or there are more than
+// `maxFields`. An empty payload has 0 fields.
+int parseFields(const char *begin, const char *end, float *values, int maxFields);
+
+// Parses one non-negative decimal integer spanning exactly [begin, end),
+// whitespace aside
+bool parseCounter(const char *begin, const char *end, std::int64_t &value);
+
+// "temp,hr" or "temp,hr,deviceUs". `deviceTimeUs` is -1 when the payload
+// carries no timestamp. False if the payload is malformed.
+bool parseVitals(const char *begin, const char *end, float &temperature, float &heartRate,
+                 std::int64_t &deviceTimeUs);
+
+} // namespace vitalsparser
+
+#endif // VITALSPARSER_H
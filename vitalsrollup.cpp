@@ -0,0 +1,111 @@
+#include "vitalsrollup.h"
+
+#include <algorithm>
+
+// --- RollupBucket ---
+
+void RollupBucket::add(float value)
+{
+    min = std::min(min, value);
+    max = std::max(max, value);
+    sum += value;
+    ++count;
+}
+
+// --- RollupTier ---
+
+RollupTier::RollupTier(int64_t bucketMs, size_t capacity)
+    : m_bucketMs(bucketMs), m_buckets(capacity)
+{
+}
+
+void RollupTier::add(int64_t timestampMs, float value)
+{
+    // Align to the bucket grid (floor division, also for negative times)
+    int64_t start = timestampMs - timestampMs % m_bucketMs;
+    if (timestampMs < 0 && timestampMs % m_bucketMs != 0)
+        start -= m_bucketMs;
+
+    if (m_open.count == 0) {
+        m_open.startMs = start;
+    } else if (start > m_open.startMs) {
+        // The open bucket is complete; gaps simply leave no bucket behind
+        m_buckets.push(m_open);
+        m_open = RollupBucket();
+        m_open.startMs = start;
+    }
+    // Late samples are folded into the open bucket rather than reopening old ones
+    m_open.add(value);
+}
+
+// --- RollupSeries ---
+
+const std::vector<RollupSeries::TierSpec> &RollupSeries::defaultTiers()
+{
+    static const std::vector<TierSpec> tiers = {
+        {1000, 3600},          // per second, 1 hour
+        {60 * 1000, 24 * 60},  // per minute, 24 hours
+        {3600 * 1000, 30 * 24} // per hour, 30 days
+    };
+    return tiers;
+}
+
+RollupSeries::RollupSeries(const std::vector<TierSpec> &tiers, size_t rawCapacity)
+    : m_raw(rawCapacity)
+{
+    m_tiers.reserve(tiers.size());
+    for (const TierSpec &spec : tiers)
+        m_tiers.emplace_back(spec.bucketMs, spec.capacity);
+}
+
+void RollupSeries::add(int64_t timestampMs, float value)
+{
+    m_raw.push({timestampMs, value});
+    for (RollupTier &tier : m_tiers)
+        tier.add(timestampMs, value);
+}
+
+RollupBucket RollupSeries::summary(size_t tier, int64_t sinceMs) const
+{
+    RollupBucket total;
+    if (tier >= m_tiers.size())
+        return total;
+
+    auto merge = [&total](const RollupBucket &bucket) {
+        total.min = std::min(total.min, bucket.min);
+        total.max = std::max(total.max, bucket.max);
+        total.sum += bucket.sum;
+        total.count += bucket.count;
+    };
+    const RollupRing<RollupBucket> &buckets = m_tiers[tier].buckets();
+    // Newest first, so the walk stops at the first bucket that is too old
+    for (size_t i = buckets.size(); i > 0 && buckets.at(i - 1).startMs >= sinceMs; --i)
+        merge(buckets.at(i - 1));
+    const RollupBucket &open = m_tiers[tier].openBucket();
+    if (open.count > 0 && open.startMs >= sinceMs)
+        merge(open);
+    if (total.count > 0)
+        total.startMs = sinceMs;
+    return total;
+}
+
+size_t RollupSeries::memoryFootprint() const
+{
+    size_t bytes = sizeof(*this) + m_raw.capacity() * sizeof(RollupSample);
+    for (const RollupTier &tier : m_tiers)
+        bytes += sizeof(RollupTier) + tier.buckets().capacity() * sizeof(RollupBucket);
+    return bytes;
+}
+
+// --- VitalsRollup ---
+
+void VitalsRollup::add(int64_t timestampMs, float temperature_c, float heart_rate_bpm)
+{
+    m_temperature.add(timestampMs, temperature_c);
+    m_heartRate.add(timestampMs, heart_rate_bpm);
+}
+
+size_t VitalsRollup::memoryFootprint() const
+{
+    return m_temperature.memoryFootprint() + m_heartRate.memoryFootprint();
+}
@@ -0,0 +1,129 @@
+#ifndef VITALSROLLUP_H
+#define VITALSROLLUP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Bounded-memory trend storage for a whole night (or week) of monitoring.
+//
+// Every sample is folded into the open bucket of each tier (per second, per
+// minute, per hour by default). When a bucket's time span ends it is pushed
+// into that tier's fixed-size ring, evicting the oldest one. Raw samples are
+// only kept for a short window. Memory is fixed at construction and each
+// update is O(number of tiers).
+
+struct RollupBucket {
+    int64_t startMs = 0;
+    float min = std::numeric_limits<float>::max();
+    float max = std::numeric_limits<float>::lowest();
+    double sum = 0.0;
+    uint32_t count = 0;
+
+    double mean() const { return count ? sum / count : 0.0; }
+    void add(float value);
+};
+
+struct RollupSample {
+    int64_t timestampMs = 0;
+    float value = 0.0f;
+};
+
+// Fixed-capacity ring, oldest element at index 0. A capacity of 0 is raised
+// to 1, the ring always holds the newest element.
+template <typename T>
+class RollupRing
+{
+public:
+    explicit RollupRing(size_t capacity) : m_items(capacity > 0 ? capacity : 1) {}
+
+    void push(const T &item)
+    {
+        m_items[m_head] = item;
+        m_head = (m_head + 1) % m_items.size();
+        if (m_size < m_items.size())
+            ++m_size;
+    }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_items.size(); }
+    const T &at(size_t i) const { return m_items[(m_head + m_items.size() - m_size + i) % m_items.size()]; }
+    const T &newest() const { return at(m_size - 1); }
+
+private:
+    std::vector<T> m_items;
+    size_t m_head = 0;
+    size_t m_size = 0;
+};
+
+class RollupTier
+{
+public:
+    RollupTier(int64_t bucketMs, size_t capacity);
+
+    void add(int64_t timestampMs, float value);
+
+    int64_t bucketMs() const { return m_bucketMs; }
+    // Completed buckets, oldest first
+    const RollupRing<RollupBucket> &buckets() const { return m_buckets; }
+    // The bucket currently being filled (count is 0 if none)
+    const RollupBucket &openBucket() const { return m_open; }
+
+private:
+    int64_t m_bucketMs;
+    RollupRing<RollupBucket> m_buckets;
+    RollupBucket m_open;
+};
+
+// Raw window plus tiers for one vital sign
+class RollupSeries
+{
+public:
+    struct TierSpec {
+        int64_t bucketMs;
+        size_t capacity;
+    };
+
+    // 10 min of raw samples; 1 h of seconds, 24 h of minutes, 30 days of hours
+    static const std::vector<TierSpec> &defaultTiers();
+    static const size_t DefaultRawCapacity = 600;
+
+    explicit RollupSeries(const std::vector<TierSpec> &tiers = defaultTiers(),
+                          size_t rawCapacity = DefaultRawCapacity);
+
+    void add(int64_t timestampMs, float value);
+
+    // Min, max and mean of the buckets of tier `tier` that start at or after
+    // `sinceMs`, the open bucket included (count is 0 if there are none)
+    RollupBucket summary(size_t tier, int64_t sinceMs) const;
+
+    const RollupRing<RollupSample> &raw() const { return m_raw; }
+    const std::vector<RollupTier> &tiers() const { return m_tiers; }
+
+    // Bytes held by this series; constant after construction
+    size_t memoryFootprint() const;
+
+private:
+    RollupRing<RollupSample> m_raw;
+    std::vector<RollupTier> m_tiers;
+};
+
+class VitalsRollup
+{
+public:
+    VitalsRollup() = default;
+
+    void add(int64_t timestampMs, float temperature_c, float heart_rate_bpm);
+
+    const RollupSeries &temperature() const { return m_temperature; }
+    const RollupSeries &heartRate() const { return m_heartRate; }
+
+    size_t memoryFootprint() const;
+
+private:
+    RollupSeries m_temperature;
+    RollupSeries m_heartRate;
+};
+
+#endif // VITALSROLLUP_H
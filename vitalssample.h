@@ -0,0 +1,39 @@
+#ifndef VITALSSAMPLE_H
+#define VITALSSAMPLE_H
+
+#include <QMetaType>
+#include <QtGlobal>
+#include <chrono>
+
+// One parsed "temp,hr" notification, as it crosses from the BLE I/O thread
+// to the UI thread.
+struct VitalsSample {
+    float temperature_c = 0.0f;
+    float heart_rate_bpm = 0.0f;
+    // Running notification counter, used to spot dropped samples
+    quint64 sequence = 0;
+    // steady_clock time at which the notification reached BleClient
+    qint64 arrivalNs = 0;
+    // ESP32 clock when it took the reading, -1 if the sketch sends none
+    qint64 deviceTimeUs = -1;
+    // deviceTimeUs on the steady clock above (see ClockSync), -1 if unknown
+    qint64 sensorNs = -1;
+};
+Q_DECLARE_METATYPE(VitalsSample)
+
+// Why BleClient dropped a notification, decided once on the BLE thread
+enum class SampleRejection {
+    Format,      // not two or three fields: "temp,hr" or "temp,hr,deviceUs"
+    NotNumeric,  // the right fields, but one of them is not a number
+    OutOfRange,  // parsed, but outside the featureschema range
+};
+Q_DECLARE_METATYPE(SampleRejection)
+
+// Monotonic clock shared by every thread that timestamps samples
+inline qint64 monotonicNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // VITALSSAMPLE_H
@@ -0,0 +1,261 @@
+#include "vitalsserver.h"
+
+#include <QRandomGenerator>
+#include <QUrlQuery>
+#include <QWebSocket>
+#include <QWebSocketServer>
+#include <QtEndian>
+
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <sys/socket.h>
+#endif
+
+#include "structuredlogger.h"
+
+// --- Frames ---
+
+namespace fanoutframe {
+
+namespace {
+
+QByteArray beginFrame(Type type, int payloadSize, quint32 sequence, qint64 sentNs)
+{
+    QByteArray frame(HeaderSize + payloadSize, Qt::Uninitialized);
+    uchar *p = reinterpret_cast<uchar *>(frame.data());
+    p[0] = type;
+    p[1] = Version;
+    qToLittleEndian<quint16>(quint16(payloadSize), p + 2);
+    qToLittleEndian<quint32>(sequence, p + 4);
+    qToLittleEndian<qint64>(sentNs, p + 8);
+    return frame;
+}
+
+void putFloat(uchar *p, float value)
+{
+    quint32 bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    qToLittleEndian<quint32>(bits, p);
+}
+
+float getFloat(const uchar *p)
+{
+    const quint32 bits = qFromLittleEndian<quint32>(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof value);
+    return value;
+}
+
+} // namespace
+
+QByteArray encodeSample(const VitalsSample &sample, quint32 sequence, qint64 sentNs)
+{
+    QByteArray frame = beginFrame(Sample, 12, sequence, sentNs);
+    uchar *p = reinterpret_cast<uchar *>(frame.data()) + HeaderSize;
+    putFloat(p, sample.temperature_c);
+    putFloat(p + 4, sample.heart_rate_bpm);
+    qToLittleEndian<quint32>(quint32(sample.sequence), p + 8);
+    return frame;
+}
+
+QByteArray encodePrediction(const PredictionResult &result, quint32 sequence, qint64 sentNs)
+{
+    const int classes = result.classes;
+    QByteArray frame = beginFrame(Prediction, 5 + 4 * classes, sequence, sentNs);
+    uchar *p = reinterpret_cast<uchar *>(frame.data()) + HeaderSize;
+    qToLittleEndian<qint32>(qint32(result.label), p);
+    p[4] = uchar(classes);
+    for (int c = 0; c < classes; ++c)
+        putFloat(p + 5 + 4 * c, result.probabilities[c]);
+    return frame;
+}
+
+bool decodeHeader(const QByteArray &frame, Header &header)
+{
+    if (frame.size() < HeaderSize)
+        return false;
+    const uchar *p = reinterpret_cast<const uchar *>(frame.constData());
+    header.type = p[0];
+    header.version = p[1];
+    header.payloadSize = qFromLittleEndian<quint16>(p + 2);
+    header.sequence = qFromLittleEndian<quint32>(p + 4);
+    header.sentNs = qFromLittleEndian<qint64>(p + 8);
+    return frame.size() >= HeaderSize + header.payloadSize;
+}
+
+bool decodeSample(const QByteArray &frame, float &temperature_c, float &heart_rate_bpm)
+{
+    Header header;
+    if (!decodeHeader(frame, header) || header.type != Sample || header.payloadSize < 8)
+        return false;
+    const uchar *p = reinterpret_cast<const uchar *>(frame.constData()) + HeaderSize;
+    temperature_c = getFloat(p);
+    heart_rate_bpm = getFloat(p + 4);
+    return true;
+}
+
+} // namespace fanoutframe
+
+// --- VitalsServer ---
+
+VitalsServer::VitalsServer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+VitalsServer::~VitalsServer()
+{
+    stop();
+}
+
+QString VitalsServer::generateToken()
+{
+    quint32 words[4];
+    QRandomGenerator::system()->fillRange(words);
+    return QString::fromLatin1(QByteArray(reinterpret_cast<const char *>(words), sizeof(words)).toHex());
+}
+
+void VitalsServer::start(quint16 port, const QString &token, const QHostAddress &address)
+{
+    if (m_server)
+        return;
+    if (token.isEmpty()) {
+        LOG_ERROR("fanout.no_token").field("port", port);
+        return;
+    }
+    m_token = token;
+    m_server = new QWebSocketServer(QStringLiteral("VitalsServer"), QWebSocketServer::NonSecureMode, this);
+    if (!m_server->listen(address, port)) {
+        LOG_ERROR("fanout.listen_failed").field("port", port).field("error", m_server->errorString());
+        delete m_server;
+        m_server = nullptr;
+        return;
+    }
+#ifdef Q_OS_UNIX
+    // Accepted sockets inherit it from the listening socket
+    const int sendBuffer = SocketSendBufferBytes;
+    ::setsockopt(int(m_server->socketDescriptor()), SOL_SOCKET, SO_SNDBUF, &sendBuffer, sizeof sendBuffer);
+#endif
+    connect(m_server, &QWebSocketServer::newConnection, this, &VitalsServer::acceptConnections);
+    LOG_INFO("fanout.listening").field("address", address.toString()).field("port", m_server->serverPort());
+    emit listening(m_server->serverPort());
+}
+
+void VitalsServer::stop()
+{
+    const QList<QWebSocket *> sockets = m_clients.keys();
+    for (QWebSocket *socket : sockets) {
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+    m_clients.clear();
+    m_clientCount = 0;
+    if (m_server) {
+        m_server->close();
+        m_server->deleteLater();
+        m_server = nullptr;
+    }
+}
+
+void VitalsServer::acceptConnections()
+{
+    while (m_server->hasPendingConnections()) {
+        QWebSocket *socket = m_server->nextPendingConnection();
+        if (!authorized(socket)) {
+            LOG_WARNING("fanout.client_rejected").field("peer", socket->peerAddress().toString());
+            socket->close(QWebSocketProtocol::CloseCodePolicyViolated, QStringLiteral("invalid token"));
+            socket->deleteLater();
+            continue;
+        }
+        connect(socket, &QWebSocket::disconnected, this, [this, socket]() { removeClient(socket); });
+        connect(socket, &QWebSocket::bytesWritten, this, [this, socket]() { pump(socket); });
+
+        Client &client = m_clients[socket];
+        if (!m_lastSample.isEmpty())
+            enqueue(client, m_lastSample);
+        if (!m_lastPrediction.isEmpty())
+            enqueue(client, m_lastPrediction);
+        m_clientCount = int(m_clients.size());
+        LOG_INFO("fanout.client_connected").field("peer", socket->peerAddress().toString())
+            .field("clients", m_clientCount.load());
+        emit clientCountChanged(m_clientCount);
+        pump(socket);
+    }
+}
+
+bool VitalsServer::authorized(const QWebSocket *socket) const
+{
+    const QString offered = QUrlQuery(socket->requestUrl()).queryItemValue(QStringLiteral("token"));
+    if (offered.size() != m_token.size())
+        return false;
+    // Same time for every wrong token of the right length
+    ushort difference = 0;
+    for (qsizetype i = 0; i < offered.size(); ++i)
+        difference |= offered[i].unicode() ^ m_token[i].unicode();
+    return difference == 0;
+}
+
+void VitalsServer::removeClient(QWebSocket *socket)
+{
+    const auto it = m_clients.constFind(socket);
+    if (it == m_clients.cend())
+        return;
+    LOG_INFO("fanout.client_disconnected").field("dropped_frames", it->dropped)
+        .field("clients", int(m_clients.size()) - 1);
+    m_clients.erase(it);
+    m_clientCount = int(m_clients.size());
+    socket->deleteLater();
+    emit clientCountChanged(m_clientCount);
+}
+
+void VitalsServer::publishSample(const VitalsSample &sample)
+{
+    m_lastSample = fanoutframe::encodeSample(sample, ++m_sequence, monotonicNowNs());
+    broadcast(m_lastSample);
+}
+
+void VitalsServer::publishPrediction(const PredictionResult &result)
+{
+    m_lastPrediction = fanoutframe::encodePrediction(result, ++m_sequence, monotonicNowNs());
+    broadcast(m_lastPrediction);
+}
+
+void VitalsServer::broadcast(const QByteArray &frame)
+{
+    // Every queue entry shares `frame`'s bytes; nothing is copied per client
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        enqueue(it.value(), frame);
+        pump(it.key());
+    }
+}
+
+void VitalsServer::enqueue(Client &client, const QByteArray &frame)
+{
+    if (client.size == ClientQueueFrames) {
+        // Full: the oldest frame makes room for the newest
+        client.head = (client.head + 1) % ClientQueueFrames;
+        --client.size;
+        ++client.dropped;
+        ++m_framesDropped;
+    }
+    client.ring[(client.head + client.size) % ClientQueueFrames] = frame;
+    ++client.size;
+}
+
+void VitalsServer::pump(QWebSocket *socket)
+{
+    const auto it = m_clients.find(socket);
+    if (it == m_clients.end())
+        return;
+    Client &client = it.value();
+    while (client.size > 0 && socket->bytesToWrite() < MaxInFlightBytes) {
+        QByteArray &frame = client.ring[client.head];
+        socket->sendBinaryMessage(frame);
+        frame = QByteArray();
+        client.head = (client.head + 1) % ClientQueueFrames;
+        --client.size;
+        ++m_framesSent;
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef VITALSSERVER_H
+#define VITALSSERVER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QHostAddress>
+#include <QList>
+#include <QObject>
+#include <array>
+#include <atomic>
+
+#include "predictionresult.h"
+#include "vitalssample.h"
+
+class QWebSocket;
+class QWebSocketServer;
+
+// Binary frames sent to secondary screens, one per WebSocket message.
+// Little endian throughout:
+//
+//   header   u8 type, u8 version, u16 payload bytes, u32 sequence,
+//            i64 sentNs (server steady clock when the frame was built)
+//   Sample      f32 temperature_c, f32 heart_rate_bpm, u32 sample sequence
+//   Prediction  i32 label, u8 classes, f32 probability[classes]
+namespace fanoutframe {
+
+enum Type : quint8 { Sample = 1, Prediction = 2 };
+
+const quint8 Version = 1;
+const int HeaderSize = 16;
+
+struct Header {
+    quint8 type = 0;
+    quint8 version = 0;
+    quint16 payloadSize = 0;
+    quint32 sequence = 0;
+    qint64 sentNs = 0;
+};
+
+QByteArray encodeSample(const VitalsSample &sample, quint32 sequence, qint64 sentNs);
+QByteArray encodePrediction(const PredictionResult &result, quint32 sequence, qint64 sentNs);
+// False if `frame` is too short for its header or announced payload
+bool decodeHeader(const QByteArray &frame, Header &header);
+bool decodeSample(const QByteArray &frame, float &temperature_c, float &heart_rate_bpm);
+
+} // namespace fanoutframe
+
+// Optional WebSocket server that mirrors live samples and predictions to any
+// number of secondary screens on the local network.
+//
+// Every frame is encoded once and shared by all clients. Each client has a
+// small ring of frames waiting to be sent; a frame is only handed to the
+// socket when the socket's own buffer is nearly empty, so a slow client never
+// makes the server buffer without bound. When its ring is full the oldest
+// frame is dropped: a screen that falls behind skips ahead to fresh data.
+//
+// Screens must present the access token as "?token=..." in the connection URL
+// (ws://<device>:<port>/?token=...); others are closed on connect. Frames are
+// not encrypted, so the server only listens on the address it is given.
+//
+// Lives on its own thread; all slots may be invoked from other threads.
+class VitalsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Frames queued per client before the oldest is dropped
+    static const int ClientQueueFrames = 32;
+    // Bytes a socket may hold unsent before its queue stops draining
+    static const qint64 MaxInFlightBytes = 4096;
+    // Kernel send buffer per client (SO_SNDBUF). Left alone, Linux grows it
+    // to megabytes, which a stalled screen fills with minutes of stale
+    // frames before its ring ever drops one
+    static const int SocketSendBufferBytes = 16384;
+
+    explicit VitalsServer(QObject *parent = nullptr);
+    ~VitalsServer() override;
+
+    // 128 random bits as hex, for when the user gives no token
+    static QString generateToken();
+
+    // Thread-safe counters
+    int clientCount() const { return m_clientCount.load(); }
+    quint64 framesSent() const { return m_framesSent.load(); }
+    quint64 framesDropped() const { return m_framesDropped.load(); }
+
+public slots:
+    // An empty `token` refuses to start
+    void start(quint16 port, const QString &token, const QHostAddress &address = QHostAddress::LocalHost);
+    void stop();
+    void publishSample(const VitalsSample &sample);
+    void publishPrediction(const PredictionResult &result);
+
+signals:
+    void listening(quint16 port);
+    void clientCountChanged(int clients);
+
+private:
+    struct Client {
+        std::array<QByteArray, ClientQueueFrames> ring;
+        int head = 0;
+        int size = 0;
+        quint64 dropped = 0;
+    };
+
+    QWebSocketServer *m_server = nullptr;
+    QHash<QWebSocket *, Client> m_clients;
+    QString m_token;
+    quint32 m_sequence = 0;
+    // Sent to every new client first, so it has something to show at once
+    QByteArray m_lastSample;
+    QByteArray m_lastPrediction;
+
+    std::atomic<int> m_clientCount{0};
+    std::atomic<quint64> m_framesSent{0};
+    std::atomic<quint64> m_framesDropped{0};
+
+    void acceptConnections();
+    bool authorized(const QWebSocket *socket) const;
+    void removeClient(QWebSocket *socket);
+    void broadcast(const QByteArray &frame);
+    void enqueue(Client &client, const QByteArray &frame);
+    void pump(QWebSocket *socket);
+};
+
+#endif // VITALSSERVER_H
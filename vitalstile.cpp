@@ -0,0 +1,152 @@
+#include "vitalstile.h"
+
+#include <QFontMetrics>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QtMath>
+
+namespace {
+
+const qreal CORNER_RADIUS = 8.0;
+const int PADDING = 10;
+const int LINE_SPACING = 4;
+
+} // namespace
+
+VitalsTile::VitalsTile(const QString &caption, const TileStyle &style, QWidget *parent)
+    : QWidget(parent), m_style(style)
+{
+    m_captionFont = font();
+    m_captionFont.setPixelSize(14);
+    m_captionFont.setWeight(QFont::DemiBold);
+    m_valueFont = font();
+    m_valueFont.setPixelSize(22);
+    m_valueFont.setBold(true);
+    m_detailFont = font();
+    m_detailFont.setPixelSize(12);
+
+    m_caption.setTextFormat(Qt::PlainText);
+    m_caption.setPerformanceHint(QStaticText::AggressiveCaching);
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Minimum);
+    setCaption(caption);
+}
+
+void VitalsTile::setCaption(const QString &caption)
+{
+    m_caption.setText(caption);
+    m_caption.prepare(QTransform(), m_captionFont);
+    layoutTile();
+    updateGeometry();
+    update();
+}
+
+void VitalsTile::setValue(const QString &value)
+{
+    if (m_value == value)
+        return;
+    m_value = value;
+    update(m_valueRect);
+}
+
+void VitalsTile::setDetail(const QString &detail)
+{
+    if (m_detail == detail)
+        return;
+    // Showing or hiding the line moves the others
+    const bool relayout = m_detail.isEmpty() != detail.isEmpty();
+    m_detail = detail;
+    if (relayout) {
+        layoutTile();
+        updateGeometry();
+        update();
+    } else {
+        update(m_detailRect);
+    }
+}
+
+void VitalsTile::setTileStyle(const TileStyle &style)
+{
+    if (m_style == style)
+        return;
+    m_style = style;
+    layoutTile();
+    update();
+}
+
+void VitalsTile::layoutTile()
+{
+    // Caption, value and detail lines, centred vertically inside the border
+    const int inset = PADDING + m_style.borderWidth;
+    const QRect inner = contentsRect().adjusted(inset, inset, -inset, -inset);
+    const int captionHeight = m_caption.text().isEmpty() ? 0 : QFontMetrics(m_captionFont).height();
+    const int valueHeight = QFontMetrics(m_valueFont).height();
+    const int detailHeight = m_detail.isEmpty() ? 0 : QFontMetrics(m_detailFont).height();
+    const int total = captionHeight + (captionHeight ? LINE_SPACING : 0) + valueHeight
+                      + (detailHeight ? LINE_SPACING + detailHeight : 0);
+
+    int y = inner.top() + qMax(0, (inner.height() - total) / 2);
+    m_captionRect = QRect(inner.left(), y, inner.width(), captionHeight);
+    y += captionHeight + (captionHeight ? LINE_SPACING : 0);
+    m_valueRect = QRect(inner.left(), y, inner.width(), valueHeight);
+    y += valueHeight + LINE_SPACING;
+    m_detailRect = QRect(inner.left(), y, inner.width(), detailHeight);
+}
+
+QSize VitalsTile::sizeHint() const
+{
+    const int inset = 2 * (PADDING + m_style.borderWidth);
+    const QMargins margins = contentsMargins();
+    const int width = qMax(qCeil(m_caption.size().width()), QFontMetrics(m_valueFont).horizontalAdvance(m_value));
+    int height = QFontMetrics(m_valueFont).height();
+    if (!m_caption.text().isEmpty())
+        height += QFontMetrics(m_captionFont).height() + LINE_SPACING;
+    if (!m_detail.isEmpty())
+        height += QFontMetrics(m_detailFont).height() + LINE_SPACING;
+    return QSize(width + inset + margins.left() + margins.right(), height + inset + margins.top() + margins.bottom());
+}
+
+QSize VitalsTile::minimumSizeHint() const
+{
+    return QSize(0, sizeHint().height());
+}
+
+void VitalsTile::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    layoutTile();
+}
+
+void VitalsTile::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    const QRect dirty = event->rect();
+
+    // A value or detail update lies well inside the border: a plain fill
+    // instead of the antialiased outline
+    if (m_valueRect.contains(dirty) || m_detailRect.contains(dirty)) {
+        painter.fillRect(dirty, m_style.background);
+    } else {
+        painter.setRenderHint(QPainter::Antialiasing);
+        const qreal half = m_style.borderWidth / 2.0;
+        painter.setPen(QPen(m_style.border, m_style.borderWidth));
+        painter.setBrush(m_style.background);
+        painter.drawRoundedRect(QRectF(contentsRect()).adjusted(half, half, -half, -half), CORNER_RADIUS, CORNER_RADIUS);
+        painter.setRenderHint(QPainter::Antialiasing, false);
+    }
+
+    painter.setPen(m_style.text);
+    if (dirty.intersects(m_captionRect) && !m_caption.text().isEmpty()) {
+        const qreal x = m_captionRect.left() + (m_captionRect.width() - m_caption.size().width()) / 2.0;
+        painter.drawStaticText(QPointF(x, m_captionRect.top()), m_caption);
+    }
+    if (dirty.intersects(m_valueRect)) {
+        painter.setFont(m_valueFont);
+        const QString text = QFontMetrics(m_valueFont).elidedText(m_value, Qt::ElideRight, m_valueRect.width());
+        painter.drawText(m_valueRect, Qt::AlignCenter, text);
+    }
+    if (!m_detail.isEmpty() && dirty.intersects(m_detailRect)) {
+        painter.setFont(m_detailFont);
+        const QString text = QFontMetrics(m_detailFont).elidedText(m_detail, Qt::ElideRight, m_detailRect.width());
+        painter.drawText(m_detailRect, Qt::AlignCenter, text);
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef VITALSTILE_H
+#define VITALSTILE_H
+
+#include <QColor>
+#include <QFont>
+#include <QStaticText>
+#include <QString>
+#include <QWidget>
+
+// Colours of one tile; the presets match the former label stylesheets
+struct TileStyle {
+    QColor background;
+    QColor border;
+    QColor text;
+    int borderWidth = 1;
+
+    bool operator==(const TileStyle &other) const
+    {
+        return background == other.background && border == other.border && text == other.text
+               && borderWidth == other.borderWidth;
+    }
+    bool operator!=(const TileStyle &other) const { return !(*this == other); }
+
+    static TileStyle temperature() { return {QColor(0xE0F2F1), QColor(0xB2DFDB), QColor(0x004D40), 1}; }
+    static TileStyle heartRate() { return {QColor(0xE3F2FD), QColor(0xBBDEFB), QColor(0x1565C0), 1}; }
+    static TileStyle neutral() { return {QColor(0xF3F4F6), QColor(0xD1D5DB), QColor(0x374151), 2}; }
+    static TileStyle failure() { return {QColor(0xFEE2E2), QColor(0xFCA5A5), QColor(0x991B1B), 2}; }
+    static TileStyle atRisk() { return {QColor(0xFFFBEB), QColor(0xFCD34D), QColor(0x92400E), 2}; }
+    static TileStyle safe() { return {QColor(0xECFDF5), QColor(0xA7F3D0), QColor(0x065F46), 2}; }
+};
+
+// A rounded tile with a caption, a large value and an optional detail line,
+// painted directly with QPainter.
+//
+// Replaces rich-text QLabels with stylesheets: no HTML is parsed and no style
+// is re-polished when the value changes. The caption is laid out once into a
+// QStaticText, and a new value only invalidates the value's own rectangle, so
+// a sample costs one small fill and one line of text.
+class VitalsTile : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit VitalsTile(const QString &caption, const TileStyle &style, QWidget *parent = nullptr);
+
+    void setCaption(const QString &caption);
+    // Repaints the value line only
+    void setValue(const QString &value);
+    // Small elided line under the value, e.g. error details; repaints it only
+    void setDetail(const QString &detail);
+    // Repaints the whole tile, and only if the colours changed
+    void setTileStyle(const TileStyle &style);
+
+    QString value() const { return m_value; }
+    TileStyle tileStyle() const { return m_style; }
+    // Region invalidated by setValue(), for benchmarks
+    QRect valueRect() const { return m_valueRect; }
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    TileStyle m_style;
+    QString m_value;
+    QString m_detail;
+
+    QFont m_captionFont;
+    QFont m_valueFont;
+    QFont m_detailFont;
+    QStaticText m_caption;
+
+    QRect m_captionRect;
+    QRect m_valueRect;
+    QRect m_detailRect;
+
+    void layoutTile();
+};
+
+#endif // VITALSTILE_H
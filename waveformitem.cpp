@@ -0,0 +1,187 @@
+#include "waveformitem.h"
+
+#include <QSGGeometryNode>
+#include <QSGGeometry>
+#include <QSGFlatColorMaterial>
+
+WaveformItem::WaveformItem(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+    // We provide our own scene-graph content
+    setFlag(ItemHasContents, true);
+    m_samples.resize(300);
+}
+
+// --- Properties ---
+
+void WaveformItem::setCapacity(int capacity)
+{
+    // At least two points are needed to draw a single segment
+    capacity = qMax(2, capacity);
+    if (capacity == m_samples.size())
+        return;
+
+    m_samples.fill(0.0f, capacity);
+    m_head = -1;
+    m_filled = 0;
+    requestFullRebuild();
+    emit capacityChanged();
+}
+
+void WaveformItem::setMinimum(qreal minimum)
+{
+    if (qFuzzyCompare(m_minimum, minimum))
+        return;
+    m_minimum = minimum;
+    requestFullRebuild();
+    emit rangeChanged();
+}
+
+void WaveformItem::setMaximum(qreal maximum)
+{
+    if (qFuzzyCompare(m_maximum, maximum))
+        return;
+    m_maximum = maximum;
+    requestFullRebuild();
+    emit rangeChanged();
+}
+
+void WaveformItem::setColor(const QColor &color)
+{
+    if (m_color == color)
+        return;
+    m_color = color;
+    m_colorDirty = true;
+    update();
+    emit colorChanged();
+}
+
+// --- Public Slots ---
+
+void WaveformItem::append(qreal value)
+{
+    const int capacity = m_samples.size();
+    m_head = (m_head + 1) % capacity;
+    m_samples[m_head] = float(value);
+    m_filled = qMin(m_filled + 1, capacity);
+
+    // Once a whole sweep is pending there is nothing to gain from tracking points
+    if (!m_fullRebuild) {
+        if (m_dirtyPoints.size() >= capacity)
+            m_fullRebuild = true;
+        else
+            m_dirtyPoints.append(m_head);
+    }
+    update();
+}
+
+void WaveformItem::clear()
+{
+    m_head = -1;
+    m_filled = 0;
+    requestFullRebuild();
+}
+
+// --- Rendering ---
+
+void WaveformItem::requestFullRebuild()
+{
+    m_fullRebuild = true;
+    m_dirtyPoints.clear();
+    update();
+}
+
+void WaveformItem::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size())
+        requestFullRebuild();
+}
+
+void WaveformItem::writeSegment(QSGGeometryNode *node, int segment) const
+{
+    // Segment k joins point k to point k + 1 and owns vertices 2k and 2k + 1
+    const int capacity = m_samples.size();
+    if (segment < 0 || segment >= capacity - 1)
+        return;
+
+    QSGGeometry::Point2D *vertices = node->geometry()->vertexDataAsPoint2D() + 2 * segment;
+
+    const qreal range = (m_maximum > m_minimum) ? (m_maximum - m_minimum) : 1.0;
+    const qreal step = width() / (capacity - 1);
+    auto yFor = [&](int index) {
+        const qreal normalized = qBound(0.0, (m_samples[index] - m_minimum) / range, 1.0);
+        return float(height() - normalized * height());
+    };
+
+    const float x0 = float(segment * step);
+    const float x1 = float((segment + 1) * step);
+    const float y0 = yFor(segment);
+
+    // The segment right after the newest sample is the sweep gap; unwritten
+    // points are collapsed so nothing is drawn for them either
+    const bool visible = segment + 1 < m_filled && segment != m_head;
+    vertices[0].set(x0, y0);
+    if (visible)
+        vertices[1].set(x1, yFor(segment + 1));
+    else
+        vertices[1].set(x0, y0);
+}
+
+QSGNode *WaveformItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+
+    const int vertexCount = 2 * (m_samples.size() - 1);
+    auto *node = static_cast<QSGGeometryNode *>(oldNode);
+
+    if (!node) {
+        node = new QSGGeometryNode;
+
+        auto *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), vertexCount);
+        geometry->setDrawingMode(QSGGeometry::DrawLines);
+        geometry->setLineWidth(2);
+        // The vertex buffer is re-uploaded only when we mark it dirty
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+
+        auto *material = new QSGFlatColorMaterial;
+        node->setMaterial(material);
+        node->setFlag(QSGNode::OwnsMaterial);
+
+        m_fullRebuild = true;
+        m_colorDirty = true;
+    }
+
+    if (m_colorDirty) {
+        static_cast<QSGFlatColorMaterial *>(node->material())->setColor(m_color);
+        node->markDirty(QSGNode::DirtyMaterial);
+        m_colorDirty = false;
+    }
+
+    QSGGeometry *geometry = node->geometry();
+    if (geometry->vertexCount() != vertexCount) {
+        geometry->allocate(vertexCount);
+        m_fullRebuild = true;
+    }
+
+    if (m_fullRebuild) {
+        for (int segment = 0; segment < m_samples.size() - 1; ++segment)
+            writeSegment(node, segment);
+    } else if (!m_dirtyPoints.isEmpty()) {
+        // A new point changes the end of the previous segment and the start of its own
+        for (int point : std::as_const(m_dirtyPoints)) {
+            writeSegment(node, point - 1);
+            writeSegment(node, point);
+        }
+    } else {
+        return node;
+    }
+
+    geometry->markVertexDataDirty();
+    node->markDirty(QSGNode::DirtyGeometry);
+    m_dirtyPoints.clear();
+    m_fullRebuild = false;
+    return node;
+}
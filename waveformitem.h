@@ -0,0 +1,70 @@
+#ifndef WAVEFORMITEM_H
+#define WAVEFORMITEM_H
+
+#include <QQuickItem>
+#include <QColor>
+#include <QList>
+
+class QSGGeometryNode;
+
+// Sweep-style live trace (like a bedside monitor) rendered straight into the
+// scene graph. Samples are written into a fixed ring; only the vertices touched
+// by new samples are rewritten in updatePaintNode() on the render thread.
+class WaveformItem : public QQuickItem
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged FINAL)
+    Q_PROPERTY(qreal minimum READ minimum WRITE setMinimum NOTIFY rangeChanged FINAL)
+    Q_PROPERTY(qreal maximum READ maximum WRITE setMaximum NOTIFY rangeChanged FINAL)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged FINAL)
+
+public:
+    explicit WaveformItem(QQuickItem *parent = nullptr);
+
+    int capacity() const { return m_samples.size(); }
+    void setCapacity(int capacity);
+
+    qreal minimum() const { return m_minimum; }
+    void setMinimum(qreal minimum);
+
+    qreal maximum() const { return m_maximum; }
+    void setMaximum(qreal maximum);
+
+    QColor color() const { return m_color; }
+    void setColor(const QColor &color);
+
+public slots:
+    void append(qreal value);
+    void clear();
+
+signals:
+    void capacityChanged();
+    void rangeChanged();
+    void colorChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
+private:
+    // Ring of samples; m_head is the index of the newest one (-1 when empty)
+    QList<float> m_samples;
+    int m_head = -1;
+    int m_filled = 0;
+
+    qreal m_minimum = 0.0;
+    qreal m_maximum = 1.0;
+    QColor m_color = QColor("#1565C0");
+
+    // Indices written since the last sync with the render thread
+    QList<int> m_dirtyPoints;
+    bool m_fullRebuild = true;
+    bool m_colorDirty = true;
+
+    void requestFullRebuild();
+    void writeSegment(QSGGeometryNode *node, int segment) const;
+};
+
+#endif // WAVEFORMITEM_H